@@ -0,0 +1,53 @@
+# Copyright (c) 2015-2018 DNEG Visual Effects
+#
+# All rights reserved. This software is distributed under the
+# Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+#
+# Redistributions of source code must retain the above copyright
+# and license notice and the following restrictions and disclaimer.
+#
+# *     Neither the name of DNEG Visual Effects nor the names
+# of its contributors may be used to endorse or promote products derived
+# from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+# IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+# LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+#
+
+# -*- cmake -*-
+# - Embed a bitcode file into a C++ source file
+#
+# Usage:
+#   cmake -DINPUT=<file.bc> -DOUTPUT=<file.cc> -DSYMBOL=<name> -P EmbedBitcode.cmake
+#
+# Writes a source file defining the C symbols <name> (the bytes of the input
+# file) and <name>_size (the number of bytes).
+
+IF ( NOT INPUT OR NOT OUTPUT OR NOT SYMBOL )
+  MESSAGE ( FATAL_ERROR "EmbedBitcode requires INPUT, OUTPUT and SYMBOL to be defined" )
+ENDIF ()
+
+FILE ( READ ${INPUT} BITCODE HEX )
+STRING ( LENGTH "${BITCODE}" BITCODE_LENGTH )
+MATH ( EXPR BITCODE_SIZE "${BITCODE_LENGTH} / 2" )
+
+STRING ( REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BITCODE "${BITCODE}" )
+STRING ( REGEX REPLACE "(0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],)" "\\1\n" BITCODE "${BITCODE}" )
+
+FILE ( WRITE ${OUTPUT}
+  "// Generated by EmbedBitcode.cmake from ${INPUT}. Do not edit.\n\n"
+  "#include <cstddef>\n\n"
+  "extern \"C\" const unsigned char ${SYMBOL}[] = {\n${BITCODE}\n};\n"
+  "extern \"C\" const size_t ${SYMBOL}_size = ${BITCODE_SIZE};\n"
+  )
@@ -34,6 +34,7 @@
 # LLVM_INCLUDE_DIR      LLVM's include directory
 # LLVM_LIBRARYDIR       LLVM's library directory
 # LLVM_LIBRARIES        all LLVM libraries
+# LLVM_CLANG            the clang executable of the LLVM installation, if found
 
 FIND_PACKAGE ( PackageHandleStandardArgs )
 
@@ -64,4 +65,13 @@ IF ( LLVM_FOUND )
     OUTPUT_VARIABLE LLVM_LIBRARIES
     OUTPUT_STRIP_TRAILING_WHITESPACE)
 
+  execute_process (COMMAND ${LLVM_CONFIG} --bindir
+    OUTPUT_VARIABLE LLVM_BINARYDIR
+    OUTPUT_STRIP_TRAILING_WHITESPACE)
+
+  # bitcode must be generated by the clang of the same LLVM version
+  FIND_PROGRAM (LLVM_CLANG clang
+    PATHS ${LLVM_BINARYDIR}
+    NO_DEFAULT_PATH)
+
 ENDIF ( LLVM_FOUND )
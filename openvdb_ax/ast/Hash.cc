@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "Hash.h"
+
+#include "AST.h"
+#include "Tokens.h"
+
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace ast {
+
+namespace {
+
+// 64 bit FNV-1a constants
+const uint64_t sFNVOffset = 14695981039346656037ULL;
+const uint64_t sFNVPrime = 1099511628211ULL;
+
+inline uint64_t fnv1a(uint64_t seed, const void* data, const size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        seed ^= static_cast<uint64_t>(bytes[i]);
+        seed *= sFNVPrime;
+    }
+    return seed;
+}
+
+/// @brief  Visitor which accumulates a hash from a post-order traversal of a tree.
+///         Each node is tagged with a unique identifier so that trees with the same
+///         leaf data but different structure produce different results. As all
+///         containers also mix their sizes, the traversal is unambiguous.
+struct HashVisitor : public ast::Visitor
+{
+    HashVisitor() : mHash(sFNVOffset) {}
+    ~HashVisitor() override = default;
+
+    enum NodeTag : uint8_t
+    {
+        TreeTag = 1, BlockTag, ExpressionListTag, ConditionalStatementTag,
+        AssignExpressionTag, CrementTag, UnaryOperatorTag, BinaryOperatorTag,
+        CastTag, FunctionCallTag, ReturnTag, AttributeTag, AttributeValueTag,
+        DeclareLocalTag, LocalTag, LocalValueTag, VectorUnpackTag, VectorPackTag,
+        ArrayPackTag, ValueBoolTag, ValueInt16Tag, ValueInt32Tag, ValueInt64Tag,
+        ValueFloatTag, ValueDoubleTag, ValueStringTag
+    };
+
+    void visit(const ast::Tree&) override { this->tag(TreeTag); }
+
+    void visit(const ast::Block& node) override
+    {
+        this->tag(BlockTag);
+        this->mix(uint64_t(node.mList.size()));
+    }
+
+    void visit(const ast::ExpressionList& node) override
+    {
+        this->tag(ExpressionListTag);
+        this->mix(uint64_t(node.mList.size()));
+    }
+
+    void visit(const ast::ConditionalStatement& node) override
+    {
+        this->tag(ConditionalStatementTag);
+        this->mix(bool(node.mElseBranch));
+    }
+
+    void visit(const ast::AssignExpression&) override { this->tag(AssignExpressionTag); }
+
+    void visit(const ast::Crement& node) override
+    {
+        this->tag(CrementTag);
+        this->mix(int32_t(node.mOperation));
+        this->mix(node.mPost);
+    }
+
+    void visit(const ast::UnaryOperator& node) override
+    {
+        this->tag(UnaryOperatorTag);
+        this->mix(int32_t(node.mOperation));
+    }
+
+    void visit(const ast::BinaryOperator& node) override
+    {
+        this->tag(BinaryOperatorTag);
+        this->mix(int32_t(node.mOperation));
+    }
+
+    void visit(const ast::Cast& node) override
+    {
+        this->tag(CastTag);
+        this->mix(node.mType);
+    }
+
+    void visit(const ast::FunctionCall& node) override
+    {
+        this->tag(FunctionCallTag);
+        this->mix(node.mFunction);
+    }
+
+    void visit(const ast::Return&) override { this->tag(ReturnTag); }
+
+    void visit(const ast::Attribute& node) override
+    {
+        this->tag(AttributeTag);
+        this->mix(node.mName);
+        this->mix(node.mType);
+        this->mix(node.mTypeInferred);
+    }
+
+    void visit(const ast::AttributeValue&) override { this->tag(AttributeValueTag); }
+
+    void visit(const ast::DeclareLocal& node) override
+    {
+        this->tag(DeclareLocalTag);
+        this->mix(node.mName);
+        this->mix(node.mType);
+    }
+
+    void visit(const ast::Local& node) override
+    {
+        this->tag(LocalTag);
+        this->mix(node.mName);
+    }
+
+    void visit(const ast::LocalValue&) override { this->tag(LocalValueTag); }
+
+    void visit(const ast::VectorUnpack& node) override
+    {
+        this->tag(VectorUnpackTag);
+        this->mix(int32_t(node.mIndex));
+    }
+
+    void visit(const ast::VectorPack&) override { this->tag(VectorPackTag); }
+    void visit(const ast::ArrayPack&) override { this->tag(ArrayPackTag); }
+
+    void visit(const ast::Value<bool>& node) override { this->visitValue(node, ValueBoolTag); }
+    void visit(const ast::Value<int16_t>& node) override { this->visitValue(node, ValueInt16Tag); }
+    void visit(const ast::Value<int32_t>& node) override { this->visitValue(node, ValueInt32Tag); }
+    void visit(const ast::Value<int64_t>& node) override { this->visitValue(node, ValueInt64Tag); }
+    void visit(const ast::Value<float>& node) override { this->visitValue(node, ValueFloatTag); }
+    void visit(const ast::Value<double>& node) override { this->visitValue(node, ValueDoubleTag); }
+
+    void visit(const ast::Value<std::string>& node) override
+    {
+        this->tag(ValueStringTag);
+        this->mix(node.mValue);
+    }
+
+    inline uint64_t result() const { return mHash; }
+
+private:
+
+    template <typename T>
+    inline void visitValue(const ast::Value<T>& node, const NodeTag tag)
+    {
+        this->tag(tag);
+        // hash the bit representation of the value container. The original text
+        // is only present on overflow and changes the generated warnings
+        this->mix(node.mValue);
+        this->mix(bool(node.mText));
+        if (node.mText) this->mix(*node.mText);
+    }
+
+    inline void tag(const NodeTag tag) { this->mix(uint8_t(tag)); }
+
+    template <typename T>
+    inline void mix(const T& value)
+    {
+        mHash = fnv1a(mHash, &value, sizeof(T));
+    }
+
+    inline void mix(const std::string& str)
+    {
+        this->mix(uint64_t(str.size()));
+        mHash = fnv1a(mHash, str.data(), str.size());
+    }
+
+    uint64_t mHash;
+};
+
+} // anonymous namespace
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+uint64_t hash(const ast::Tree& tree)
+{
+    HashVisitor visitor;
+    tree.accept(visitor);
+    return visitor.result();
+}
+
+uint64_t hashCombine(const uint64_t seed, const std::string& str)
+{
+    const uint64_t size = str.size();
+    uint64_t result = fnv1a(seed, &size, sizeof(uint64_t));
+    return fnv1a(result, str.data(), str.size());
+}
+
+} // namespace ast
+} // namespace ax
+
+}
+} // namespace openvdb
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
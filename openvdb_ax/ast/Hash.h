@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file ast/Hash.h
+///
+/// @brief  Stable structural hashing of abstract syntax trees
+///
+
+#ifndef OPENVDB_AX_AST_HASH_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_AST_HASH_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <cstdint>
+#include <string>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace ast {
+
+struct Tree;
+
+/// @brief  Returns a 64 bit hash of the structure and contents of a syntax tree.
+/// @details Every node contributes its type and all members which affect code
+///          generation (names, types, literal values and operator tokens).  Two
+///          trees which produce identical programs will produce the same hash.
+///          The result is stable across processes on the same platform, so can
+///          be used as a persistent cache key.
+/// @param tree  The tree to hash
+uint64_t hash(const ast::Tree& tree);
+
+/// @brief  Combines a string into an existing 64 bit hash (FNV-1a). Used to mix
+///         additional state into a hash produced by ast::hash.
+/// @param seed  The current hash value
+/// @param str   The string to mix
+uint64_t hashCombine(const uint64_t seed, const std::string& str);
+
+} // namespace ast
+} // namespace ax
+
+}
+} // namespace openvdb
+
+#endif // OPENVDB_AX_AST_HASH_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -29,21 +29,22 @@
 ///////////////////////////////////////////////////////////////////////////
 
 #include <openvdb_ax/ast/AST.h>
-#include <openvdb_ax/ast/Scanners.h>
 #include <openvdb_ax/codegen/FunctionRegistry.h>
+#include <openvdb_ax/compiler/CompileReport.h>
 #include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/ObjectCache.h>
 #include <openvdb_ax/compiler/PointExecutable.h>
 #include <openvdb_ax/compiler/VolumeExecutable.h>
 
 #include <openvdb/openvdb.h>
 #include <openvdb/util/logging.h>
-#include <openvdb/points/PointDelete.h>
 #include <openvdb/pointsdev/PointSort.h>
 
 #ifdef DWA_OPENVDB
 #include <usagetrack.h>
 #endif
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -57,6 +58,7 @@ struct ProgOptions
     std::string mInputCode = "";
     std::string mInputVDBFile = "";
     std::string mOutputVDBFile = "";
+    std::string mCacheDirectory = "";
     bool mVerbose = false;
 };
 
@@ -70,6 +72,7 @@ usage [[noreturn]] (int exitStatus = EXIT_FAILURE)
 "    -s snippet        execute code snippet on the input.vdb file\n" <<
 "    -f file.txt       execute text file containing a code snippet on the input.vdb file\n" <<
 "    -v                verbose (print timing and diagnostics)\n" <<
+"    --cache dir       cache compiled objects in dir and reuse them on subsequent runs\n" <<
 "    --list-functions  list all available functions, their signatures and their documentation\n" <<
 "Warning:\n" <<
 "     Providing the same file-path to both input.vdb and output.vdb arguments will overwrite\n" <<
@@ -202,6 +205,9 @@ main(int argc, char *argv[])
                 loadSnippetFile(argv[i], options.mInputCode);
             } else if (parser.check(i, "-v", 0)) {
                 options.mVerbose = true;
+            } else if (parser.check(i, "--cache")) {
+                ++i;
+                options.mCacheDirectory = argv[i];
             } else if (parser.check(i, "--list-functions", 0)) {
                 initializer.initializeCompiler();
                 printFunctions(std::cout);
@@ -260,6 +266,17 @@ main(int argc, char *argv[])
     initializer.initializeCompiler();
     openvdb::ax::Compiler::Ptr compiler = openvdb::ax::Compiler::create();
 
+    openvdb::ax::ObjectCache::Ptr cache;
+    if (!options.mCacheDirectory.empty()) {
+        try {
+            cache = openvdb::ax::ObjectCache::create(options.mCacheDirectory);
+        } catch (std::exception& e) {
+            OPENVDB_LOG_FATAL(e.what());
+            return EXIT_FAILURE;
+        }
+        compiler->setObjectCache(cache);
+    }
+
     // Execute on PointDataGrids
 
     bool executeOnPoints = false;
@@ -276,16 +293,22 @@ main(int argc, char *argv[])
 
         openvdb::ax::CustomData::Ptr customData = openvdb::ax::CustomData::create();
         PointExecutable::Ptr pointExecutable;
+        openvdb::ax::CompileReport report;
 
+        const auto parseStart = std::chrono::steady_clock::now();
         const openvdb::ax::ast::Tree::ConstPtr syntaxTree =
             openvdb::ax::ast::parse(options.mInputCode.c_str());
+        const std::chrono::duration<double> parseTime =
+            std::chrono::steady_clock::now() - parseStart;
 
         if (options.mVerbose) std::cout << "OpenVDB PointDataGrids Found" << std::endl;
         std::vector<std::string> warnings;
 
         try {
             if (options.mVerbose) std::cout << "  Compiling for PointDataGrids...";
-            pointExecutable = compiler->compile<PointExecutable>(*syntaxTree, customData, &warnings);
+            pointExecutable = compiler->compile<PointExecutable>(*syntaxTree, customData, &warnings,
+                options.mVerbose ? &report : nullptr);
+            report.mParseTime = parseTime.count();
         } catch (std::exception& e) {
             OPENVDB_LOG_FATAL("Compilation error!");
             OPENVDB_LOG_FATAL("Errors:");
@@ -297,7 +320,10 @@ main(int argc, char *argv[])
             OPENVDB_LOG_WARN(warning);
         }
 
-        if (options.mVerbose) std::cout << "done." << std::endl;
+        if (options.mVerbose) {
+            std::cout << "done." << std::endl;
+            report.print(std::cout);
+        }
 
         for (auto grid : *grids) {
             if (!grid->isType<openvdb::points::PointDataGrid>()) continue;
@@ -308,13 +334,6 @@ main(int argc, char *argv[])
 
             try {
                 pointExecutable->execute(*points);
-
-                const bool requiresDeletion =
-                    openvdb::ax::ast::callsFunction(*syntaxTree, "deletepoint");
-
-                if (requiresDeletion) {
-                    openvdb::points::deleteFromGroup(points->tree(), "dead", false, false);
-                }
             }
             catch (std::exception& e) {
                 OPENVDB_LOG_FATAL("Execution error!");
@@ -342,6 +361,7 @@ main(int argc, char *argv[])
 
         using openvdb::ax::VolumeExecutable;
         VolumeExecutable::Ptr volumeExecutable;
+        openvdb::ax::CompileReport report;
 
         if (options.mVerbose) std::cout << "OpenVDB Volume Grids Found" << std::endl;
         std::vector<std::string> warnings;
@@ -349,7 +369,8 @@ main(int argc, char *argv[])
         try {
             if (options.mVerbose) std::cout << "  Compiling for Volume VDB Grid...";
             volumeExecutable =
-                compiler->compile<VolumeExecutable>(options.mInputCode, customData, &warnings);
+                compiler->compile<VolumeExecutable>(options.mInputCode, customData, &warnings,
+                    options.mVerbose ? &report : nullptr);
         } catch (std::exception& e) {
             OPENVDB_LOG_FATAL("Compilation error!");
             OPENVDB_LOG_FATAL("Errors:");
@@ -361,7 +382,10 @@ main(int argc, char *argv[])
             OPENVDB_LOG_WARN(warning);
         }
 
-        if (options.mVerbose) std::cout << "done." << std::endl;
+        if (options.mVerbose) {
+            std::cout << "done." << std::endl;
+            report.print(std::cout);
+        }
 
         if (options.mVerbose) {
             std::string names("");
@@ -387,6 +411,13 @@ main(int argc, char *argv[])
         if (options.mVerbose) std::cout << "done." << std::endl;
     }
 
+    if (cache && options.mVerbose) {
+        const openvdb::ax::ObjectCache::Statistics stats = cache->statistics();
+        std::cout << "Object cache \"" << cache->directory() << "\": "
+            << stats.mHits << " hit(s), " << stats.mMisses << " miss(es), "
+            << stats.mStores << " store(s)" << std::endl;
+    }
+
     if (!options.mOutputVDBFile.empty()) {
         openvdb::io::File out(options.mOutputVDBFile);
 
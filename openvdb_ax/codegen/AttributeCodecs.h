@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file codegen/AttributeCodecs.h
+///
+/// @brief  Bulk decoding and encoding of attribute arrays stored with the codecs
+///         provided by OpenVDB. The codec of an array is resolved once, after which
+///         every value is converted inline rather than through the per value function
+///         pointers of an attribute handle.
+///
+
+#ifndef OPENVDB_AX_CODEGEN_ATTRIBUTE_CODECS_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_CODEGEN_ATTRIBUTE_CODECS_HAS_BEEN_INCLUDED
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+
+#include <cassert>
+#include <vector>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace codegen {
+
+namespace codec_internal {
+
+/// @brief  Attempts each codec of a list in turn until the array is found to be
+///         stored with one of them
+template <typename ValueT, typename... CodecTs>
+struct CodecList
+{
+    static inline bool supports(const points::AttributeArray&) { return false; }
+    static inline bool decode(const points::AttributeArray&, ValueT*) { return false; }
+    static inline bool encode(points::AttributeArray&, const ValueT*, const ValueT*) { return false; }
+};
+
+template <typename ValueT, typename CodecT, typename... CodecTs>
+struct CodecList<ValueT, CodecT, CodecTs...>
+{
+    using ArrayT = points::TypedAttributeArray<ValueT, CodecT>;
+
+    static inline bool supports(const points::AttributeArray& array)
+    {
+        return array.isType<ArrayT>() || CodecList<ValueT, CodecTs...>::supports(array);
+    }
+
+    static inline bool decode(const points::AttributeArray& array, ValueT* values)
+    {
+        if (!array.isType<ArrayT>()) return CodecList<ValueT, CodecTs...>::decode(array, values);
+
+        const ArrayT& typed = static_cast<const ArrayT&>(array);
+        const Index size = typed.size();
+        for (Index n = 0; n < size; ++n) values[n] = typed.getUnsafe(n);
+        return true;
+    }
+
+    static inline bool encode(points::AttributeArray& array,
+                              const ValueT* values,
+                              const ValueT* decoded)
+    {
+        if (!array.isType<ArrayT>()) {
+            return CodecList<ValueT, CodecTs...>::encode(array, values, decoded);
+        }
+
+        // encoding may not exactly reproduce a decoded value, so only values which
+        // have changed are written. Changes are found against the values as they were
+        // decoded, rather than by decoding the array again
+
+        ArrayT& typed = static_cast<ArrayT&>(array);
+        const Index size = typed.size();
+        for (Index n = 0; n < size; ++n) {
+            if (decoded[n] != values[n]) typed.setUnsafe(n, values[n]);
+        }
+        return true;
+    }
+};
+
+/// @brief  The codecs supported for each value type
+template <typename ValueT>
+struct KnownCodecs { using Type = CodecList<ValueT, points::NullCodec>; };
+
+// booleans are stored as bytes rather than the bits of their llvm type
+template <>
+struct KnownCodecs<bool> { using Type = CodecList<bool>; };
+
+// strings are indices into string metadata
+template <>
+struct KnownCodecs<Name> { using Type = CodecList<Name>; };
+
+template <>
+struct KnownCodecs<float>
+{
+    using Type = CodecList<float,
+        points::NullCodec,
+        points::TruncateCodec,
+        points::FixedPointCodec<false, points::UnitRange>,
+        points::FixedPointCodec<true, points::UnitRange>,
+        points::FixedPointCodec<false, points::PositionRange>,
+        points::FixedPointCodec<true, points::PositionRange>>;
+};
+
+template <>
+struct KnownCodecs<math::Vec3<float>>
+{
+    using Type = CodecList<math::Vec3<float>,
+        points::NullCodec,
+        points::TruncateCodec,
+        points::FixedPointCodec<false, points::UnitRange>,
+        points::FixedPointCodec<true, points::UnitRange>,
+        points::FixedPointCodec<false, points::PositionRange>,
+        points::FixedPointCodec<true, points::PositionRange>,
+        points::UnitVecCodec>;
+};
+
+/// @brief  Returns true if the values of an array may be accessed in bulk
+inline bool isBulkAccessible(const points::AttributeArray& array)
+{
+    return !array.isUniform() && !array.isCompressed() && !array.isOutOfCore() &&
+        array.stride() == 1;
+}
+
+} // namespace codec_internal
+
+/// @brief  Returns true if every value of an attribute array can be decoded. This
+///         requires the array to be in-core, uncompressed, non-uniform, of stride one
+///         and to be stored with a known codec.
+template <typename ValueT>
+inline bool
+canDecodeAttributeArray(const points::AttributeArray& array)
+{
+    return codec_internal::isBulkAccessible(array) &&
+        codec_internal::KnownCodecs<ValueT>::Type::supports(array);
+}
+
+/// @brief  Decodes every value of an attribute array into a buffer of at least the
+///         size of the array. Returns false and leaves the buffer unchanged if the
+///         array can not be decoded, see canDecodeAttributeArray.
+template <typename ValueT>
+inline bool
+decodeAttributeArray(const points::AttributeArray& array, ValueT* values)
+{
+    if (!codec_internal::isBulkAccessible(array)) return false;
+    return codec_internal::KnownCodecs<ValueT>::Type::decode(array, values);
+}
+
+/// @brief  Decodes every value of an attribute array into a buffer, which is resized to
+///         the size of the array. Returns false and leaves the buffer unchanged if the
+///         array can not be decoded, see canDecodeAttributeArray.
+template <typename ValueT>
+inline bool
+decodeAttributeArray(const points::AttributeArray& array, std::vector<ValueT>& values)
+{
+    if (!canDecodeAttributeArray<ValueT>(array)) return false;
+    values.resize(array.size());
+    return decodeAttributeArray(array, values.data());
+}
+
+/// @brief  Encodes a buffer previously filled by decodeAttributeArray back into its
+///         array. Only the values which differ from those originally decoded are
+///         encoded, so that unchanged values are not subject to the precision loss of a
+///         lossy codec. Returns false if the array can not be accessed in bulk.
+/// @param  array    The array the values were decoded from
+/// @param  values   The values to encode
+/// @param  decoded  The values as they were decoded from the array
+template <typename ValueT>
+inline bool
+encodeAttributeArray(points::AttributeArray& array, const ValueT* values, const ValueT* decoded)
+{
+    if (!codec_internal::isBulkAccessible(array)) return false;
+    return codec_internal::KnownCodecs<ValueT>::Type::encode(array, values, decoded);
+}
+
+template <typename ValueT>
+inline bool
+encodeAttributeArray(points::AttributeArray& array,
+                     const std::vector<ValueT>& values,
+                     const std::vector<ValueT>& decoded)
+{
+    assert(values.size() == array.size());
+    assert(decoded.size() == array.size());
+    return encodeAttributeArray(array, values.data(), decoded.data());
+}
+
+}
+}
+}
+}
+
+#endif // OPENVDB_AX_CODEGEN_ATTRIBUTE_CODECS_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
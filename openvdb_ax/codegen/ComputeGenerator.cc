@@ -327,8 +327,15 @@ void ComputeGenerator::visit(const ast::BinaryOperator& node)
                     + ast::tokens::operatorNameFromToken(op) + "\"");
             }
 
-            llvm::AllocaInst* lhsAllocInstance = llvm::cast<llvm::AllocaInst>(ptrToLhsValue);
-            llvm::AllocaInst* rhsAllocInstance = llvm::cast<llvm::AllocaInst>(ptrToRhsValue);
+            // strings which are not allocated by the program, such as those read from
+            // string attributes, are of an unknown size
+
+            llvm::AllocaInst* lhsAllocInstance = llvm::dyn_cast<llvm::AllocaInst>(ptrToLhsValue);
+            llvm::AllocaInst* rhsAllocInstance = llvm::dyn_cast<llvm::AllocaInst>(ptrToRhsValue);
+            if (!lhsAllocInstance || !rhsAllocInstance) {
+                OPENVDB_THROW(LLVMBinaryOperationError, "Unable to concatenate a string "
+                    "of unknown size");
+            }
             llvm::Value* lhsCharArraySize = lhsAllocInstance->getArraySize();
             llvm::Value* rhsCharArraySize = rhsAllocInstance->getArraySize();
 
@@ -545,7 +552,10 @@ void ComputeGenerator::visit(const ast::AssignExpression& node)
             }
 
             // re-allocate the lhs
-            llvm::AllocaInst* allocInstance = llvm::cast<llvm::AllocaInst>(ptrToRhsValue);
+            llvm::AllocaInst* allocInstance = llvm::dyn_cast<llvm::AllocaInst>(ptrToRhsValue);
+            if (!allocInstance) {
+                OPENVDB_THROW(LLVMCastError, "Unable to assign a string of unknown size");
+            }
             llvm::Value* size = allocInstance->getArraySize();
             assert(llvm::isa<llvm::ConstantInt>(size));
             ptrToLhsValue = mBuilder.CreateAlloca(lhsType, size);
@@ -975,6 +985,27 @@ void ComputeGenerator::visit(const ast::Tree& node)
     assert(mBlocks.size() == 1);
     mBuilder.CreateRetVoid();
     for (auto& block : mReturnBlocks) block->eraseFromParent();
+
+    // stack allocations are created where they are first required, which may be
+    // within a branch. Move them to the entry block so that they can be promoted to
+    // registers. As AX has no loops, each is only ever executed once per call
+
+    llvm::BasicBlock& entry = mFunction->getEntryBlock();
+    std::vector<llvm::AllocaInst*> allocas;
+
+    for (llvm::BasicBlock& block : *mFunction) {
+        if (&block == &entry) continue;
+        for (llvm::Instruction& instruction : block) {
+            llvm::AllocaInst* alloca = llvm::dyn_cast<llvm::AllocaInst>(&instruction);
+            if (alloca && llvm::isa<llvm::Constant>(alloca->getArraySize())) {
+                allocas.push_back(alloca);
+            }
+        }
+    }
+
+    for (llvm::AllocaInst* alloca : allocas) {
+        alloca->moveBefore(&*entry.getFirstInsertionPt());
+    }
 }
 
 void ComputeGenerator::visit(const ast::Attribute& node)
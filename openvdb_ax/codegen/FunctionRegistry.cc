@@ -188,6 +188,7 @@ void insertStandardFunctions(FunctionRegistry& registry)
     registry.insert("internal_cross", CrossProd::Internal::create, false);
     registry.insert("internal_normalize", Normalize::Internal::create, false);
     registry.insert("internal_addtogroup", AddToGroup::Internal::create, false);
+    registry.insert("internal_deletepoint", DeletePoint::Internal::create, false);
     registry.insert("internal_ingroup", InGroup::Internal::create, false);
     registry.insert("internal_removefromgroup", RemoveFromGroup::Internal::create, false);
     registry.insert("internal_lookupf", LookupFloat::Internal::create, false);
@@ -197,6 +198,7 @@ void insertStandardFunctions(FunctionRegistry& registry)
 
     registry.insert("getvoxel", GetVoxel::create, true);
     registry.insert("setvoxel", SetVoxel::create, true);
+    registry.insert("setactivevoxel", SetActiveVoxel::create, true);
     registry.insert("getcoordx", GetCoordX::create);
     registry.insert("getcoordy", GetCoordY::create);
     registry.insert("getcoordz", GetCoordZ::create);
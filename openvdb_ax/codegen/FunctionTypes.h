@@ -425,6 +425,13 @@ struct FunctionBase
     ///
     inline virtual void getDocumentation(std::string& doc) const {}
 
+    /// @brief  Returns true if this function has no side effects and its result depends
+    ///         only on its arguments (and the custom data, which is constant during an
+    ///         execution). Calls to functions which are not pure are never hoisted,
+    ///         reused between points or vectorised. Defaults to false.
+    ///
+    inline virtual bool isPure() const { return false; }
+
     /// @brief  Given a vector of llvm types, automatically returns the best possible
     ///         function signature pointer and match type.
     /// @note   The vector of provided llvm types does not need to contain the possible
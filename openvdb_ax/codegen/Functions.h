@@ -68,11 +68,18 @@ namespace codegen {
     inline const std::string identifier() const override final { return std::string(Identifier); } \
     inline void getDocumentation(std::string& doc) const override final { doc = Documentation; }
 
+// Macro for marking a function as pure. Functions which are not marked are assumed
+// to have side effects or to depend on state other than their arguments
+
+#define DEFINE_PURE \
+    inline bool isPure() const override final { return true; }
+
 // LLVM Intrinsics which work on FP types
 
 #define DEFINE_LLVM_FP_INTRINSIC(ClassName, Identifier, ASTToken, LLVMToken, STDFunc, Doc) \
     struct ClassName : public FunctionBase { \
         DEFINE_IDENTIFIER_CONTEXT_DOC(Identifier, FunctionBase::All, Doc) \
+        DEFINE_PURE \
         inline static Ptr create(const FunctionOptions& op) { \
             return Ptr(op.mPrioritiseFunctionIR ? new ClassName(PrioritiseIRGeneration()) : new ClassName()); \
         }\
@@ -130,6 +137,7 @@ struct Pow : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("pow", FunctionBase::All,
         "Computes the value of the first argument raised to the power of the second argument.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Pow()); }
 
@@ -171,6 +179,7 @@ struct Acos : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("acos", FunctionBase::All,
         "Computes the principal value of the arc cosine of the input.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Acos()); }
 
@@ -186,6 +195,7 @@ struct Asin : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("asin", FunctionBase::All,
         "Computes the principal value of the arc sine of the input.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Asin()); }
 
@@ -201,6 +211,7 @@ struct Atan : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("atan", FunctionBase::All,
         "Computes the principal value of the arc tangent of the input.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Atan()); }
 
@@ -217,6 +228,7 @@ struct Atan2 : public FunctionBase
     DEFINE_IDENTIFIER_CONTEXT_DOC("atan2", FunctionBase::All,
         "Computes the arc tangent of y/x using the signs of arguments to determine "
         "the correct quadrant.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Atan2()); }
 
@@ -232,6 +244,7 @@ struct Cbrt : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("cbrt", FunctionBase::All,
         "Computes the cubic root of the input.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Cbrt()); }
 
@@ -247,6 +260,7 @@ struct Sinh : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("sinh", FunctionBase::All,
         "Computes the hyperbolic sine of the input")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Sinh()); }
 
@@ -262,6 +276,7 @@ struct Cosh : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("cosh", FunctionBase::All,
         "Computes the hyperbolic cosine of the input")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Cosh()); }
 
@@ -277,6 +292,7 @@ struct Tanh : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("tanh", FunctionBase::All,
         "Computes the hyperbolic tangent of the input")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Tanh()); }
 
@@ -336,6 +352,7 @@ struct Atoi : public FunctionBase
     DEFINE_IDENTIFIER_CONTEXT_DOC("atoi", FunctionBase::All,
         "Parses the string input interpreting its content as an integral number, which is "
         "returned as a value of type int.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Atoi()); }
 
@@ -350,6 +367,7 @@ struct Atof : public FunctionBase
     DEFINE_IDENTIFIER_CONTEXT_DOC("atof", FunctionBase::All,
         "Parses the string input, interpreting its content as a floating point number and "
         "returns its value as a double.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Atof()); }
 
@@ -362,6 +380,7 @@ struct Signbit : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("signbit", FunctionBase::All,
         "Determines if the given floating point number input is negative.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Signbit()); }
 
@@ -377,6 +396,7 @@ struct Abs : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("abs", FunctionBase::All,
         "Computes the absolute value of an integer number.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Abs(PrioritiseIRGeneration()) : new Abs());
@@ -448,6 +468,7 @@ struct LookupFloat : public Lookup
         "Find a custom user parameter with a given name of type 'float' in the Custom data "
         "provided to the AX compiler. If the data can not be found, or is not of the expected type "
         "0.0f is returned.")
+    DEFINE_PURE
     inline static FunctionBase::Ptr create(const FunctionOptions&) { return Ptr(new LookupFloat()); }
 
     LookupFloat() : Lookup({
@@ -489,6 +510,7 @@ struct LookupVec3f : public Lookup
         "Find a custom user parameter with a given name of type 'vector float' in the Custom data "
         "provided to the AX compiler. If the data can not be found, or is not of the expected type "
         "{ 0.0f, 0.0f, 0.0f } is returned.")
+    DEFINE_PURE
     inline static FunctionBase::Ptr create(const FunctionOptions&) { return Ptr(new LookupVec3f()); }
 
     LookupVec3f() : Lookup({
@@ -522,6 +544,7 @@ struct Min : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("min", FunctionBase::All,
         "Returns the smaller of the given values.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Min(PrioritiseIRGeneration()) : new Min());
@@ -572,6 +595,7 @@ struct Max : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("max", FunctionBase::All,
         "Returns the larger of the given values.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Max(PrioritiseIRGeneration()) : new Max());
@@ -622,6 +646,7 @@ struct Tan : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("tan", FunctionBase::All,
         "Computes the tangent of arg (measured in radians).")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Tan(PrioritiseIRGeneration()) : new Tan());
@@ -665,6 +690,7 @@ struct LengthSq : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("lengthsq", FunctionBase::All,
         "Returns the squared length of the given vector")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new LengthSq(PrioritiseIRGeneration()) : new LengthSq());
@@ -721,6 +747,7 @@ struct Length : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("length", FunctionBase::All,
         "Returns the length of the given vector")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Length(PrioritiseIRGeneration()) : new Length());
@@ -798,6 +825,7 @@ struct Normalize : public FunctionBase
 
     DEFINE_IDENTIFIER_CONTEXT_DOC("normalize", FunctionBase::All,
         "Returns the normalized result of the given vector.")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Normalize(PrioritiseIRGeneration()) : new Normalize());
@@ -874,6 +902,7 @@ struct DotProd : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("dot", FunctionBase::All,
         "Computes the dot product of two vectors")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new DotProd(PrioritiseIRGeneration()) : new DotProd());
@@ -947,6 +976,7 @@ struct CrossProd : public FunctionBase
 
     DEFINE_IDENTIFIER_CONTEXT_DOC("cross", FunctionBase::All,
         "Computes the cross product of two vectors")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new CrossProd()); }
 
@@ -983,6 +1013,7 @@ struct Clamp : public FunctionBase
     DEFINE_IDENTIFIER_CONTEXT_DOC("clamp", FunctionBase::All,
         "Clamps the first argument to the minimum second argument value and maximum third "
         "argument value")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions& op) {
         return Ptr(op.mPrioritiseFunctionIR ? new Clamp(PrioritiseIRGeneration()) : new Clamp());
@@ -1076,6 +1107,7 @@ struct Fit : public FunctionBase
         "Fit the first argument to the output range by first clamping the value between the second and "
         "third input range arguments and then remapping the result to the output range fourth and fifth "
         "arguments")
+    DEFINE_PURE
 
     inline static Ptr create(const FunctionOptions&) { return Ptr(new Fit()); }
 
@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file codegen/LeafArena.h
+///
+/// @brief  A region of memory from which the state used to execute a single leaf is
+///         allocated. The objects of a leaf are destroyed when the arena is reset, but
+///         its memory is kept and reused for the next leaf, so that a thread executing
+///         many leaves only allocates while its arena grows.
+///
+///         Only state which is released once a leaf has been executed is held by the
+///         arena. Data created by a program which outlives the leaf, such as new groups,
+///         new strings and written positions, is held by the LeafLocalData of the leaf
+///         until it is applied to the grid, and is allocated per leaf.
+///
+
+#ifndef OPENVDB_AX_CODEGEN_LEAF_ARENA_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_CODEGEN_LEAF_ARENA_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace codegen {
+
+/// @brief  A monotonic allocator which destroys its objects on reset. An arena is not
+///         thread safe, each thread executing leaves uses its own
+class LeafArena
+{
+public:
+    /// @param blockSize  The size in bytes of the first block of memory. Each further
+    ///                   block is twice the size of the previous
+    LeafArena(const size_t blockSize = 4096)
+        : mBlocks()
+        , mBlockSize(blockSize)
+        , mBlock(0)
+        , mOffset(0)
+        , mObjects() {}
+
+    ~LeafArena() { this->reset(); }
+
+    LeafArena(const LeafArena&) = delete;
+    LeafArena& operator=(const LeafArena&) = delete;
+
+    /// @brief  Constructs an object in the arena. The object is destroyed when the
+    ///         arena is reset
+    template <typename T, typename... Args>
+    inline T* create(Args&&... args)
+    {
+        void* memory = this->allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        this->addObject(object, 1);
+        return object;
+    }
+
+    /// @brief  Constructs an array of value initialized objects in the arena. The
+    ///         objects are destroyed when the arena is reset
+    template <typename T>
+    inline T* createArray(const size_t size)
+    {
+        if (size == 0) return nullptr;
+        T* array = static_cast<T*>(this->allocate(sizeof(T) * size, alignof(T)));
+        for (size_t i = 0; i < size; ++i) new (array + i) T();
+        this->addObject(array, size);
+        return array;
+    }
+
+    /// @brief  Destroys all objects created since the last reset, in reverse order of
+    ///         creation, and makes their memory available to new objects
+    inline void reset()
+    {
+        for (auto iter = mObjects.rbegin(); iter != mObjects.rend(); ++iter) {
+            iter->mDestroy(iter->mObject, iter->mSize);
+        }
+        mObjects.clear();
+        mBlock = 0;
+        mOffset = 0;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> mData;
+        size_t mSize;
+    };
+
+    struct Object
+    {
+        void* mObject;
+        size_t mSize;
+        void (*mDestroy)(void*, const size_t);
+    };
+
+    template <typename T>
+    static void destroy(void* object, const size_t size)
+    {
+        T* array = static_cast<T*>(object);
+        for (size_t i = size; i > 0; --i) array[i - 1].~T();
+    }
+
+    template <typename T>
+    inline void addObject(T* object, const size_t size)
+    {
+        if (std::is_trivially_destructible<T>::value) return;
+        mObjects.push_back({ object, size, &LeafArena::destroy<T> });
+    }
+
+    /// @brief  Returns aligned memory from the current block, moving to the next block
+    ///         or allocating a new one when it is exhausted
+    inline void* allocate(const size_t size, const size_t alignment)
+    {
+        while (mBlock < mBlocks.size()) {
+            Block& block = mBlocks[mBlock];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.mData.get());
+            const uintptr_t begin = (base + mOffset + alignment - 1) & ~uintptr_t(alignment - 1);
+            if (begin + size <= base + block.mSize) {
+                mOffset = size_t(begin + size - base);
+                return reinterpret_cast<void*>(begin);
+            }
+            ++mBlock;
+            mOffset = 0;
+        }
+
+        // the new block is at least large enough for the requested size once aligned
+
+        const size_t previous = mBlocks.empty() ? mBlockSize / 2 : mBlocks.back().mSize;
+        const size_t blockSize = std::max(previous * 2, size + alignment);
+
+        mBlocks.push_back({ std::unique_ptr<char[]>(new char[blockSize]), blockSize });
+
+        mBlock = mBlocks.size() - 1;
+        mOffset = 0;
+        return this->allocate(size, alignment);
+    }
+
+    std::vector<Block> mBlocks;
+    const size_t mBlockSize;
+    size_t mBlock;
+    size_t mOffset;
+    std::vector<Object> mObjects;
+};
+
+}
+}
+}
+}
+
+#endif // OPENVDB_AX_CODEGEN_LEAF_ARENA_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
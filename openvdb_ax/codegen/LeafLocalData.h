@@ -32,12 +32,23 @@
 #ifndef OPENVDB_AX_CODEGEN_LEAF_LOCAL_DATA_HAS_BEEN_INCLUDED
 #define OPENVDB_AX_CODEGEN_LEAF_LOCAL_DATA_HAS_BEEN_INCLUDED
 
+#include "AttributeCodecs.h"
+#include "LeafArena.h"
+
 #include <openvdb/openvdb.h>
 #include <openvdb/points/AttributeArray.h>
+#include <openvdb/points/AttributeArrayString.h>
 #include <openvdb/points/PointAttribute.h>
 #include <openvdb/points/PointDataGrid.h>
 #include <openvdb/points/PointGroup.h>
 
+#include <algorithm>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace openvdb {
 OPENVDB_USE_VERSION_NAMESPACE
 namespace OPENVDB_VERSION_NAME {
@@ -49,14 +60,15 @@ namespace codegen {
 /// @brief  Various functions can request the use and initialization of point data from within
 ///         the kernel that does not use the standard attribute handle methods. This data can
 ///         then be accessed after execution to perform post-processes such as adding new groups,
-///         adding new string attributes or updating positions.
+///         adding new string attributes, updating positions or removing deleted points.
 ///
 /// @note  Due to the way string handles work, string write attribute handles cannot
 ///        be constructed in parallel, nor can read handles retrieve values in parallel
 ///        if there is a chance the shared metadata is being written to (with set()).
-///        As the compiler allows for any arbitrary string setting/getting, leaf local
-///        maps are used for temporary storage per point. The maps use the string array
-///        pointers as a key for later synchronization.
+///        As the compiler allows for any arbitrary string setting/getting, new strings
+///        are stored contiguously per leaf, and each string array which is written holds
+///        a dense index per point into them. The string array pointers are used as a key
+///        for later synchronization.
 ///
 struct LeafLocalData
 {
@@ -64,8 +76,7 @@ struct LeafLocalData
     using GroupArrayT = openvdb::points::GroupAttributeArray;
     using GroupHandleT = openvdb::points::GroupWriteHandle;
 
-    using PointStringMap = std::map<uint64_t, std::string>;
-    using StringArrayMap = std::map<points::AttributeArray*, PointStringMap>;
+    using StringIndexMap = std::unordered_map<std::string, Index>;
 
     using PositionT = openvdb::Vec3f;
     using PositionVector = std::vector<PositionT>;
@@ -83,8 +94,12 @@ struct LeafLocalData
         , mArrays()
         , mOffset(0)
         , mHandles()
-        , mStringMap()
-        , mPositions() {}
+        , mStringArrays()
+        , mStringArena()
+        , mStringRanges()
+        , mWrittenPositions()
+        , mDeleted()
+        , mDeletedCount(0) {}
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -102,10 +117,7 @@ struct LeafLocalData
         GroupHandleT* ptr = get(name);
         if (ptr) return ptr;
 
-        static const size_t maxGroupsInArray =
-            points::point_group_internal::GroupInfo::groupBits();
-
-        if (mArrays.empty() || mOffset == maxGroupsInArray) {
+        if (mArrays.empty() || mOffset == maxGroupsInArray()) {
             mArrays.emplace_back(new GroupArrayT(mPointCount));
             mOffset = 0;
         }
@@ -113,9 +125,11 @@ struct LeafLocalData
         GroupArrayT* array = mArrays.back().get();
         assert(array);
 
-        std::unique_ptr<GroupHandleT>& handle = mHandles[name];
-        handle.reset(new GroupHandleT(*array, mOffset++));
-        return handle.get();
+        NewGroup& group = mHandles[name];
+        group.mArray = array;
+        group.mOffset = mOffset++;
+        group.mHandle.reset(new GroupHandleT(*array, group.mOffset));
+        return group.mHandle.get();
     }
 
     /// @brief  Return a group write handle to a specific group name if it exists.
@@ -127,7 +141,21 @@ struct LeafLocalData
     {
         const auto iter = mHandles.find(name);
         if (iter == mHandles.end()) return nullptr;
-        return iter->second.get();
+        return iter->second.mHandle.get();
+    }
+
+    /// @brief  Return the array holding a specific group name and the offset of the
+    ///         group within it. Returns a nullptr if no group exists of the given name
+    ///
+    /// @param  name    The group name
+    /// @param  offset  The offset of the group within the returned array
+    ///
+    inline const GroupArrayT* getArray(const std::string& name, points::GroupType& offset) const
+    {
+        const auto iter = mHandles.find(name);
+        if (iter == mHandles.end()) return nullptr;
+        offset = iter->second.mOffset;
+        return iter->second.mArray;
     }
 
     /// @brief  Return true if a valid group handle exists
@@ -138,15 +166,28 @@ struct LeafLocalData
         return mHandles.find(name) != mHandles.end();
     }
 
-    /// @brief  Populate a set with all the groups which have been inserted into
-    ///         this object. Used to compute a final set of all new groups which
-    ///         have been created across all leaf nodes
+    /// @brief  Append the groups which have been inserted into this object and are
+    ///         not yet in a list, in the order in which they were inserted. Used to
+    ///         compute a final list of all new groups which have been created across
+    ///         all leaf nodes
     ///
-    /// @param  groups  The set to populate
+    /// @param  groups  The list to append to
     ///
-    inline void getGroups(std::set<std::string>& groups) const {
+    inline void getGroups(std::vector<std::string>& groups) const {
+        std::vector<std::pair<size_t, std::string>> inserted;
+        inserted.reserve(mHandles.size());
         for (const auto& iter : mHandles) {
-            groups.insert(iter.first);
+            // groups are inserted in order of their array and offset
+            const size_t array = std::find_if(mArrays.begin(), mArrays.end(),
+                [&](const std::unique_ptr<GroupArrayT>& a) { return a.get() == iter.second.mArray; })
+                    - mArrays.begin();
+            inserted.emplace_back(array * maxGroupsInArray() + iter.second.mOffset, iter.first);
+        }
+        std::sort(inserted.begin(), inserted.end());
+        for (const auto& iter : inserted) {
+            if (std::find(groups.begin(), groups.end(), iter.second) == groups.end()) {
+                groups.emplace_back(iter.second);
+            }
         }
     }
 
@@ -172,11 +213,12 @@ struct LeafLocalData
     ///
     inline bool
     getNewStringData(const points::AttributeArray* array, const uint64_t idx, std::string& data) const {
-        const auto arrayMapIter = mStringMap.find(const_cast<points::AttributeArray*>(array));
-        if (arrayMapIter == mStringMap.end()) return false;
-        const auto iter = arrayMapIter->second.find(idx);
-        if (iter == arrayMapIter->second.end()) return false;
-        data = iter->second;
+        const NewStringArray* const strings = this->findNewStrings(array);
+        if (!strings) return false;
+        const Index id = strings->mIds[idx];
+        if (id == 0) return false;
+        const std::pair<size_t, size_t>& range = mStringRanges[id - 1];
+        data.assign(mStringArena.data() + range.first, range.second);
         return true;
     }
 
@@ -189,7 +231,27 @@ struct LeafLocalData
     ///
     inline void
     setNewStringData(points::AttributeArray* array, const uint64_t idx, const std::string& data) {
-        mStringMap[array][idx] = data;
+        NewStringArray* strings = this->findNewStrings(array);
+        if (!strings) {
+            mStringArrays.push_back({ array, std::vector<Index>(mPointCount, 0) });
+            strings = &mStringArrays.back();
+        }
+
+        // consecutive points are commonly set to the same string, which is then only
+        // stored once
+
+        if (!mStringRanges.empty()) {
+            const std::pair<size_t, size_t>& last = mStringRanges.back();
+            if (last.second == data.size() &&
+                std::equal(data.begin(), data.end(), mStringArena.begin() + last.first)) {
+                strings->mIds[idx] = Index(mStringRanges.size());
+                return;
+            }
+        }
+
+        mStringRanges.emplace_back(mStringArena.size(), data.size());
+        mStringArena.insert(mStringArena.end(), data.begin(), data.end());
+        strings->mIds[idx] = Index(mStringRanges.size());
     }
 
     /// @brief  Remove any new string data associated with a particular point on a
@@ -200,32 +262,63 @@ struct LeafLocalData
     ///
     inline void
     removeNewStringData(points::AttributeArray* array, const uint64_t idx) {
-        const auto arrayMapIter = mStringMap.find(array);
-        if (arrayMapIter == mStringMap.end()) return;
-        arrayMapIter->second.erase(idx);
-        if (arrayMapIter->second.empty()) mStringMap.erase(arrayMapIter);
+        NewStringArray* const strings = this->findNewStrings(array);
+        if (strings) strings->mIds[idx] = 0;
     }
 
-    /// @brief  Insert all new point strings stored across all collected string
-    ///         attribute arrays into a StringMetaInserter. Returns false if the
-    ///         inserter was not accessed and true if it was potentially modified.
+    /// @brief  Returns true if new string data has been set on any string attribute
+    ///         array
     ///
-    /// @param  inserter  The string meta inserter to update
+    inline bool hasNewStrings() const {
+        return !mStringRanges.empty();
+    }
+
+    /// @brief  Insert all new strings held across all collected string attribute
+    ///         arrays into a set. Used to compute the unique strings of all leaf
+    ///         nodes before they are added to the descriptor metadata
     ///
-    inline bool
-    insertNewStrings(points::StringMetaInserter& inserter) const {
-        for (const auto& arrayIter : mStringMap) {
-            for (const auto& iter : arrayIter.second) {
-                inserter.insert(iter.second);
-            }
+    /// @param  strings  The set to insert into
+    ///
+    inline void
+    getNewStrings(std::set<std::string>& strings) const {
+        // strings which have been overwritten or removed are still stored, so only
+        // those held by a point are inserted
+        std::vector<bool> held(mStringRanges.size() + 1, false);
+        for (const NewStringArray& array : mStringArrays) {
+            for (const Index id : array.mIds) held[id] = true;
+        }
+        for (size_t i = 0; i < mStringRanges.size(); ++i) {
+            if (!held[i + 1]) continue;
+            const std::pair<size_t, size_t>& range = mStringRanges[i];
+            strings.emplace(mStringArena.data() + range.first, range.second);
         }
-        return !mStringMap.empty();
     }
 
-    /// @brief  Returns a const reference to the string array map
+    /// @brief  Write the new strings of every collected string attribute array. The
+    ///         metadata index of each stored string is looked up once, and the indices
+    ///         of the points are then written in a single pass over each array
     ///
-    inline const StringArrayMap& getStringArrayMap() const {
-        return mStringMap;
+    /// @param  indices  The metadata indices of the new strings
+    ///
+    inline void
+    writeNewStrings(const StringIndexMap& indices) const {
+        if (mStringArrays.empty()) return;
+
+        std::vector<Index> resolved(mStringRanges.size() + 1, 0);
+        for (size_t i = 0; i < mStringRanges.size(); ++i) {
+            const std::pair<size_t, size_t>& range = mStringRanges[i];
+            const auto iter = indices.find(
+                std::string(mStringArena.data() + range.first, range.second));
+            if (iter != indices.end()) resolved[i + 1] = iter->second;
+        }
+
+        for (const NewStringArray& strings : mStringArrays) {
+            points::AttributeWriteHandle<Index, points::StringCodec<false>> handle(*strings.mArray);
+            for (size_t n = 0; n < strings.mIds.size(); ++n) {
+                const Index id = strings.mIds[n];
+                if (id != 0) handle.set(Index(n), resolved[id]);
+            }
+        }
     }
 
 
@@ -233,69 +326,373 @@ struct LeafLocalData
 
     /// Position methods
 
-    /// @brief Initialises the position vector for the all of the points in the leaf
-    ///        that are included in the filter, other points have values of zero initialised
+    /// @brief Initialises access to the world space positions of the points in the leaf.
+    ///        Positions are computed on demand from the voxel coordinate and index space
+    ///        offset of each point, and are only stored for the points which are written.
+    ///        Linear transforms are applied with a precomputed matrix.
 
-    /// @tparam FilterT    The filter type of the filter argument
-    /// @param  leaf       The leaf node whose positions to cache
+    /// @param  leaf       The leaf node whose positions to access
     /// @param  transform  The world-space transform of the grid
-    /// @param  filter     A filter on the leaf to determine which points we need positions for
+    /// @param  arena      The arena in which the storage used to read positions is
+    ///                    allocated
+    /// @note   The leaf, transform and arena must outlive any position reads, which are
+    ///         only valid until releasePositions is called or the arena is reset
 
-    template<typename FilterT = openvdb::points::NullFilter>
-    inline void initPositions(const LeafNode& leaf, const openvdb::math::Transform& transform,
-                              FilterT filter = FilterT()) {
+    inline void initPositions(const LeafNode& leaf,
+                              const openvdb::math::Transform& transform,
+                              LeafArena& arena) {
 
-        mPositions.reserve(mPointCount);
+        mLeaf = &leaf;
+        mTransform = &transform;
+        mLinear = transform.isLinear();
+        if (mLinear) mMatrix = transform.baseMap()->getAffineMap()->getConstMat4();
 
         const openvdb::points::AttributeSet& attributeSet = leaf.attributeSet();
         const size_t pos = attributeSet.find("P");
         assert(pos != openvdb::points::AttributeSet::INVALID_POS);
 
-        const openvdb::points::AttributeHandle<openvdb::Vec3f>::Ptr
-            position = openvdb::points::AttributeHandle<openvdb::Vec3f>::create(leaf.constAttributeArray(pos));
+        // positions are commonly quantised, so are decoded in bulk where possible
 
-        filter.reset(leaf);
-
-        for (auto voxel = leaf.cbeginValueAll(); voxel; ++voxel) {
-            const openvdb::Coord& coord = voxel.getCoord();
-            auto iter = leaf.beginIndexVoxel(coord);
-            for (; iter; ++iter) {
-                if (filter.valid(iter)) {
-                    mPositions.emplace_back(transform.indexToWorld(coord.asVec3d() + position->get(*(iter))));
-                }
-                else mPositions.emplace_back(PositionT::zero());
-            }
+        const points::AttributeArray& array = leaf.constAttributeArray(pos);
+        if (canDecodeAttributeArray<PositionT>(array)) {
+            PositionT* positions = arena.createArray<PositionT>(array.size());
+            decodeAttributeArray(array, positions);
+            mDecodedPositions = positions;
+            mPositionHandle = nullptr;
+        }
+        else {
+            mDecodedPositions = nullptr;
+            mPositionHandle = arena.create<openvdb::points::AttributeHandle<PositionT>>(array);
         }
+
+        mVoxelOffset = 0;
+        mVoxelBegin = 0;
+        mVoxelEnd = 0;
     }
 
-    /// @brief  Updates the position value in the the position vector
+    /// @brief  Ends access to the positions of the leaf. The storage used to read
+    ///         positions is freed when the arena is reset. Written positions are kept
+    ///         until this object is destroyed
+    ///
+    inline void releasePositions() {
+        mLeaf = nullptr;
+        mPositionHandle = nullptr;
+        mDecodedPositions = nullptr;
+    }
+
+    /// @brief  Updates the world space position of a point
     ///
     /// @param  pos   The position to be assigned
-    /// @param  index The index of the element the vector to assign to
+    /// @param  index The index of the point
     ///
 
     inline void setPosition(const PositionT& pos, const size_t index) {
-        mPositions[index] = pos;
+
+        // points are written in increasing order by the generated code, so the new
+        // position is almost always appended
+
+        if (mWrittenPositions.empty() || mWrittenPositions.back().first < index) {
+            mWrittenPositions.emplace_back(Index(index), pos);
+            return;
+        }
+
+        auto iter = this->findWrittenPosition(index);
+        if (iter != mWrittenPositions.end() && iter->first == index) iter->second = pos;
+        else mWrittenPositions.emplace(iter, Index(index), pos);
     }
 
-    /// @brief  Returns a const reference to the position vector
+    /// @brief  Returns the world space position of a point
     ///
-    /// @note   The position vector must have been initialised
+    /// @param  index The index of the point
+    /// @note   initPositions must have been called
     ///
 
-    inline const PositionVector& getPositions() const {
-        return mPositions;
+    inline PositionT getPosition(const size_t index) {
+
+        PositionT pos;
+        if (this->getWrittenPosition(index, pos)) return pos;
+
+        assert(mLeaf);
+        const Vec3d voxel = this->voxelCoord(Index(index)).asVec3d();
+        const PositionT offset = mDecodedPositions ?
+            mDecodedPositions[index] : mPositionHandle->get(Index(index));
+
+        if (mLinear) return PositionT(mMatrix.transform(voxel + Vec3d(offset)));
+        return PositionT(mTransform->indexToWorld(voxel + Vec3d(offset)));
+    }
+
+    /// @brief  Writes the new index space offsets of the points whose written positions
+    ///         remain within their voxel directly to the leaf. The written positions of
+    ///         these points are discarded, so that only the points which cross into
+    ///         another voxel remain to be moved. Returns the number of these points.
+    ///
+    /// @param  leaf       The leaf node whose positions were written
+    /// @param  transform  The world-space transform of the grid
+    ///
+
+    inline size_t updatePositions(LeafNode& leaf, const openvdb::math::Transform& transform) {
+
+        if (mWrittenPositions.empty()) return 0;
+
+        mLeaf = &leaf;
+        mVoxelOffset = 0;
+        mVoxelBegin = 0;
+        mVoxelEnd = 0;
+
+        openvdb::points::AttributeWriteHandle<PositionT> handle(leaf.attributeArray("P"));
+
+        auto moved = mWrittenPositions.begin();
+        for (const WrittenPosition& written : mWrittenPositions) {
+            const Vec3d ijk = transform.worldToIndex(written.second);
+            const Coord voxel = Coord::round(ijk);
+            if (voxel == this->voxelCoord(written.first)) {
+                handle.set(written.first, PositionT(ijk - voxel.asVec3d()));
+            }
+            else *moved++ = written;
+        }
+
+        mWrittenPositions.erase(moved, mWrittenPositions.end());
+        mLeaf = nullptr;
+
+        return mWrittenPositions.size();
+    }
+
+    /// @brief  Retrieves the position written to a point. Returns false if the
+    ///         position of the point has not been written
+    ///
+    /// @param  index The index of the point
+    /// @param  pos   The written position
+    ///
+
+    inline bool getWrittenPosition(const size_t index, PositionT& pos) const {
+        if (mWrittenPositions.empty()) return false;
+        const auto iter = this->findWrittenPosition(index);
+        if (iter == mWrittenPositions.end() || iter->first != index) return false;
+        pos = iter->second;
+        return true;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Deletion methods
+
+    /// @brief  Marks a point to be deleted once the leaf has been executed
+    ///
+    /// @param  index  The index of the point
+    ///
+    inline void deletePoint(const uint64_t index) {
+        assert(index < mPointCount);
+        if (mDeleted.empty()) mDeleted.resize((mPointCount + 63) / 64, 0);
+        mDeleted[index >> 6] |= uint64_t(1) << (index & 63);
+    }
+
+    /// @brief  Returns true if any point is marked for deletion
+    ///
+    inline bool hasDeletedPoints() const { return !mDeleted.empty(); }
+
+    /// @brief  Returns the number of points which have been removed from the leaf by
+    ///         removeDeletedPoints
+    ///
+    inline size_t deletedPoints() const { return mDeletedCount; }
+
+    /// @brief  Removes the points marked for deletion from the leaf. The attribute
+    ///         arrays of the leaf are rebuilt from the remaining points, and the new
+    ///         groups, strings and positions held by this object are compacted to match
+    ///         so that they can be applied as usual. Returns the number of points removed.
+    ///
+    /// @param  leaf  The leaf node whose points were deleted
+    /// @note   Any handles to the arrays of the leaf, or to the new groups of this
+    ///         object, are invalidated
+    ///
+    inline size_t removeDeletedPoints(LeafNode& leaf) {
+
+        if (mDeleted.empty()) return 0;
+
+        // the previous index of each remaining point, in order
+
+        std::vector<Index> kept;
+        kept.reserve(mPointCount);
+        for (size_t n = 0; n < mPointCount; ++n) {
+            if (!(mDeleted[n >> 6] & (uint64_t(1) << (n & 63)))) kept.emplace_back(Index(n));
+        }
+        mDeleted.clear();
+
+        const Index count = Index(kept.size());
+        const size_t removed = mPointCount - count;
+        if (removed == 0) return 0;
+
+        // copy the values of the remaining points into arrays of the new size. Values
+        // are copied by index, so the strings of string attributes are unchanged
+
+        const points::AttributeSet& existing = leaf.attributeSet();
+        std::unique_ptr<points::AttributeSet> attributeSet(new points::AttributeSet(existing, count));
+
+        for (size_t pos = 0; pos < existing.size(); ++pos) {
+            const points::AttributeArray* source = existing.getConst(pos);
+            points::AttributeArray* target = attributeSet->get(pos);
+            if (!source->hasConstantStride() || source->stride() != target->stride()) {
+                OPENVDB_THROW(TypeError, "Unable to delete points from an attribute "
+                    "array of varying stride.");
+            }
+
+            const Index stride = source->stride();
+            for (Index n = 0; n < count; ++n) {
+                for (Index i = 0; i < stride; ++i) {
+                    target->set(n * stride + i, *source, kept[n] * stride + i);
+                }
+            }
+            target->compact();
+
+            // new strings are keyed by the array they are written to
+
+            for (NewStringArray& strings : mStringArrays) {
+                if (strings.mArray == source) strings.mArray = target;
+            }
+        }
+
+        // the end offset of each voxel is the number of remaining points before it
+
+        std::vector<LeafNode::ValueType> offsets(LeafNode::SIZE);
+        Index next = 0;
+        for (Index offset = 0; offset < LeafNode::SIZE; ++offset) {
+            const LeafNode::ValueType end = leaf.getValue(offset);
+            while (next < count && kept[next] < end) ++next;
+            offsets[offset] = next;
+        }
+
+        leaf.replaceAttributeSet(attributeSet.release());
+        leaf.setOffsets(offsets);
+
+        // compact the new data of this object
+
+        for (auto& array : mArrays) {
+            std::unique_ptr<GroupArrayT> compacted(new GroupArrayT(count));
+            for (Index n = 0; n < count; ++n) compacted->set(n, *array, kept[n]);
+            compacted->compact();
+            for (auto& iter : mHandles) {
+                NewGroup& group = iter.second;
+                if (group.mArray != array.get()) continue;
+                group.mArray = compacted.get();
+                group.mHandle.reset(new GroupHandleT(*compacted, group.mOffset));
+            }
+            array = std::move(compacted);
+        }
+
+        for (NewStringArray& strings : mStringArrays) {
+            for (Index n = 0; n < count; ++n) strings.mIds[n] = strings.mIds[kept[n]];
+            strings.mIds.resize(count);
+        }
+
+        auto written = mWrittenPositions.begin();
+        for (const WrittenPosition& position : mWrittenPositions) {
+            const auto iter = std::lower_bound(kept.begin(), kept.end(), position.first);
+            if (iter == kept.end() || *iter != position.first) continue;
+            *written++ = WrittenPosition(Index(iter - kept.begin()), position.second);
+        }
+        mWrittenPositions.erase(written, mWrittenPositions.end());
+
+        mPointCount = count;
+        mDeletedCount += removed;
+        return removed;
     }
 
 
 private:
 
-    const size_t mPointCount;
+    /// @brief  A group inserted into this object, held at an offset of one of its arrays
+    struct NewGroup
+    {
+        std::unique_ptr<GroupHandleT> mHandle;
+        GroupArrayT* mArray = nullptr;
+        points::GroupType mOffset = 0;
+    };
+
+    static inline size_t maxGroupsInArray() {
+        static const size_t bits = points::point_group_internal::GroupInfo::groupBits();
+        return bits;
+    }
+
+    size_t mPointCount;
     std::vector<std::unique_ptr<GroupArrayT>> mArrays;
     points::GroupType mOffset;
-    std::map<std::string, std::unique_ptr<GroupHandleT>> mHandles;
-    StringArrayMap mStringMap;
-    PositionVector mPositions;
+    std::map<std::string, NewGroup> mHandles;
+    /// @brief  The new strings of a string attribute array, held as the index of the
+    ///         string stored for each point plus one, or zero if none is stored
+    struct NewStringArray
+    {
+        points::AttributeArray* mArray;
+        std::vector<Index> mIds;
+    };
+
+    inline const NewStringArray* findNewStrings(const points::AttributeArray* array) const {
+        for (const NewStringArray& strings : mStringArrays) {
+            if (strings.mArray == array) return &strings;
+        }
+        return nullptr;
+    }
+
+    inline NewStringArray* findNewStrings(const points::AttributeArray* array) {
+        for (NewStringArray& strings : mStringArrays) {
+            if (strings.mArray == array) return &strings;
+        }
+        return nullptr;
+    }
+
+    std::vector<NewStringArray> mStringArrays;
+    std::vector<char> mStringArena;
+    std::vector<std::pair<size_t, size_t>> mStringRanges;
+
+    using WrittenPosition = std::pair<Index, PositionT>;
+    using WrittenPositionVector = std::vector<WrittenPosition>;
+
+    /// @brief  Returns the first written position with an index not less than index
+    inline WrittenPositionVector::const_iterator findWrittenPosition(const size_t index) const {
+        if (mWrittenPositions.back().first == index) return mWrittenPositions.end() - 1;
+        return std::lower_bound(mWrittenPositions.begin(), mWrittenPositions.end(), index,
+            [](const WrittenPosition& written, const size_t i) { return written.first < i; });
+    }
+
+    inline WrittenPositionVector::iterator findWrittenPosition(const size_t index) {
+        const auto iter = static_cast<const LeafLocalData*>(this)->findWrittenPosition(index);
+        return mWrittenPositions.begin() + (iter - mWrittenPositions.cbegin());
+    }
+
+    /// @brief  Returns the coordinate of the voxel containing a point. Points are mostly
+    ///         accessed in increasing order, so the search begins from the voxel of the
+    ///         previous access
+    inline Coord voxelCoord(const Index index) {
+        if (index < mVoxelBegin || index >= mVoxelEnd) {
+            const auto* const begin = mLeaf->buffer().data();
+            const auto* const end = begin + LeafNode::SIZE;
+            const auto* const first = index >= mVoxelEnd ? begin + mVoxelOffset : begin;
+            const auto* const iter = std::upper_bound(first, end, index,
+                [](const Index i, const Index value) { return i < value; });
+            assert(iter != end);
+            mVoxelOffset = Index(iter - begin);
+            mVoxelBegin = mVoxelOffset == 0 ? 0 : Index(*(iter - 1));
+            mVoxelEnd = Index(*iter);
+        }
+        return mLeaf->offsetToGlobalCoord(mVoxelOffset);
+    }
+
+    // position reads
+    const LeafNode* mLeaf = nullptr;
+    const openvdb::math::Transform* mTransform = nullptr;
+    bool mLinear = false;
+    math::Mat4d mMatrix;
+    const openvdb::points::AttributeHandle<PositionT>* mPositionHandle = nullptr;
+    const PositionT* mDecodedPositions = nullptr;
+    Index mVoxelOffset = 0;
+    Index mVoxelBegin = 0;
+    Index mVoxelEnd = 0;
+
+    // sorted by point index
+    WrittenPositionVector mWrittenPositions;
+
+    // a bit per point, only allocated once a point is deleted
+    std::vector<uint64_t> mDeleted;
+    size_t mDeletedCount;
 };
 
 }
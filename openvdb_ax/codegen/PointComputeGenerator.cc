@@ -38,6 +38,7 @@
 #include "Types.h"
 #include "Utils.h"
 
+#include <openvdb_ax/ast/Scanners.h>
 #include <openvdb_ax/Exceptions.h>
 
 #include <llvm/ADT/SmallVector.h>
@@ -52,9 +53,14 @@
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Metadata.h>
 #include <llvm/Pass.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/MathExtras.h>
 
+#include <algorithm>
+#include <set>
+
 namespace openvdb {
 OPENVDB_USE_VERSION_NAMESPACE
 namespace OPENVDB_VERSION_NAME {
@@ -62,30 +68,273 @@ namespace OPENVDB_VERSION_NAME {
 namespace ax {
 namespace codegen {
 
+namespace {
+
+/// @brief  Returns loop metadata which forces the vectorisation of a loop to a given width
+llvm::MDNode* vectorizeLoopMetadata(llvm::LLVMContext& context, const size_t width)
+{
+    llvm::Metadata* enable[] = {
+        llvm::MDString::get(context, "llvm.loop.vectorize.enable"),
+        llvm::ConstantAsMetadata::get(llvm::ConstantInt::getTrue(context))
+    };
+    llvm::Metadata* vectorWidth[] = {
+        llvm::MDString::get(context, "llvm.loop.vectorize.width"),
+        llvm::ConstantAsMetadata::get(LLVMType<int32_t>::get(context, static_cast<int32_t>(width)))
+    };
+
+    // the first operand of a loop id is a reference to itself
+
+    llvm::TempMDTuple temp = llvm::MDNode::getTemporary(context, llvm::None);
+    llvm::Metadata* operands[] = {
+        temp.get(),
+        llvm::MDNode::get(context, enable),
+        llvm::MDNode::get(context, vectorWidth)
+    };
+
+    llvm::MDNode* loop = llvm::MDNode::get(context, operands);
+    loop->replaceOperandWith(0, loop);
+    return loop;
+}
+
+/// @brief  Generates the body of the group range function, which calls compute_point for
+///         every point whose group bit is set. Group values are loaded eight at a time and
+///         the set bits of each word visited with cttz. The remaining values are tested
+///         individually.
+void generateGroupRange(llvm::Function* computeGroupRange, llvm::Function* computePoint)
+{
+    llvm::LLVMContext& context = computeGroupRange->getContext();
+    llvm::IRBuilder<> builder(context);
+
+    std::vector<llvm::Value*> args;
+    for (llvm::Argument& arg : computeGroupRange->args()) args.emplace_back(&arg);
+    assert(args.size() == ComputePointFunction::N_ARGS + 2);
+
+    const size_t indexArg =
+        std::find(ComputePointFunction::ArgumentKeys.cbegin(),
+            ComputePointFunction::ArgumentKeys.cend(), "point_index") -
+        ComputePointFunction::ArgumentKeys.cbegin();
+
+    llvm::Value* const count = args[indexArg];
+    llvm::Value* const group = args[ComputePointFunction::N_ARGS];
+    llvm::Value* const mask = args[ComputePointFunction::N_ARGS + 1];
+
+    // calls compute_point with the arguments of this function for a given point
+
+    auto callComputePoint = [&](llvm::Value* index) {
+        std::vector<llvm::Value*> pointArgs(args.begin(), args.begin() + ComputePointFunction::N_ARGS);
+        pointArgs[indexArg] = index;
+        builder.CreateCall(computePoint, pointArgs);
+    };
+
+    llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "__entry_group", computeGroupRange);
+    llvm::BasicBlock* wordCond = llvm::BasicBlock::Create(context, "__word_cond", computeGroupRange);
+    llvm::BasicBlock* wordBody = llvm::BasicBlock::Create(context, "__word_body", computeGroupRange);
+    llvm::BasicBlock* bitCond = llvm::BasicBlock::Create(context, "__bit_cond", computeGroupRange);
+    llvm::BasicBlock* bitBody = llvm::BasicBlock::Create(context, "__bit_body", computeGroupRange);
+    llvm::BasicBlock* wordEnd = llvm::BasicBlock::Create(context, "__word_end", computeGroupRange);
+    llvm::BasicBlock* tailCond = llvm::BasicBlock::Create(context, "__tail_cond", computeGroupRange);
+    llvm::BasicBlock* tailBody = llvm::BasicBlock::Create(context, "__tail_body", computeGroupRange);
+    llvm::BasicBlock* tailCall = llvm::BasicBlock::Create(context, "__tail_call", computeGroupRange);
+    llvm::BasicBlock* tailEnd = llvm::BasicBlock::Create(context, "__tail_end", computeGroupRange);
+    llvm::BasicBlock* exit = llvm::BasicBlock::Create(context, "__exit_group", computeGroupRange);
+
+    // replicate the group bit into every byte of a word
+
+    builder.SetInsertPoint(entry);
+    llvm::Value* words = builder.CreateLShr(count, builder.getInt64(3));
+    llvm::Value* wordMask = builder.CreateMul(builder.CreateZExt(mask, builder.getInt64Ty()),
+        builder.getInt64(0x0101010101010101ULL));
+    llvm::Value* wordPtr = builder.CreateBitCast(group, builder.getInt64Ty()->getPointerTo());
+    builder.CreateBr(wordCond);
+
+    builder.SetInsertPoint(wordCond);
+    llvm::PHINode* word = builder.CreatePHI(builder.getInt64Ty(), 2, "word");
+    word->addIncoming(builder.getInt64(0), entry);
+    builder.CreateCondBr(builder.CreateICmpULT(word, words), wordBody, tailCond);
+
+    builder.SetInsertPoint(wordBody);
+    llvm::LoadInst* value = builder.CreateLoad(builder.CreateGEP(wordPtr, word));
+    value->setAlignment(1);
+    llvm::Value* wordBits = value;
+    if (llvm::sys::IsBigEndianHost) {
+        llvm::Function* bswap = llvm::Intrinsic::getDeclaration(computeGroupRange->getParent(),
+            llvm::Intrinsic::bswap, builder.getInt64Ty());
+        wordBits = builder.CreateCall(bswap, wordBits);
+    }
+    wordBits = builder.CreateAnd(wordBits, wordMask);
+    builder.CreateBr(bitCond);
+
+    // each byte holds at most one set bit, the lowest of which gives the next point
+
+    builder.SetInsertPoint(bitCond);
+    llvm::PHINode* bits = builder.CreatePHI(builder.getInt64Ty(), 2, "bits");
+    bits->addIncoming(wordBits, wordBody);
+    builder.CreateCondBr(builder.CreateICmpNE(bits, builder.getInt64(0)), bitBody, wordEnd);
+
+    builder.SetInsertPoint(bitBody);
+    llvm::Function* cttz = llvm::Intrinsic::getDeclaration(computeGroupRange->getParent(),
+        llvm::Intrinsic::cttz, builder.getInt64Ty());
+    llvm::Value* zeros = builder.CreateCall(cttz, { bits, builder.getTrue() });
+    callComputePoint(builder.CreateAdd(builder.CreateShl(word, builder.getInt64(3)),
+        builder.CreateLShr(zeros, builder.getInt64(3))));
+    bits->addIncoming(builder.CreateAnd(bits, builder.CreateSub(bits, builder.getInt64(1))),
+        bitBody);
+    builder.CreateBr(bitCond);
+
+    builder.SetInsertPoint(wordEnd);
+    word->addIncoming(builder.CreateAdd(word, builder.getInt64(1)), wordEnd);
+    builder.CreateBr(wordCond);
+
+    // the points after the last whole word
+
+    builder.SetInsertPoint(tailCond);
+    llvm::PHINode* index = builder.CreatePHI(builder.getInt64Ty(), 2, "i");
+    index->addIncoming(builder.CreateShl(words, builder.getInt64(3)), wordCond);
+    builder.CreateCondBr(builder.CreateICmpULT(index, count), tailBody, exit);
+
+    builder.SetInsertPoint(tailBody);
+    llvm::Value* byte = builder.CreateLoad(builder.CreateGEP(group, index));
+    builder.CreateCondBr(builder.CreateICmpNE(builder.CreateAnd(byte, mask), builder.getInt8(0)),
+        tailCall, tailEnd);
+
+    builder.SetInsertPoint(tailCall);
+    callComputePoint(index);
+    builder.CreateBr(tailEnd);
+
+    builder.SetInsertPoint(tailEnd);
+    index->addIncoming(builder.CreateAdd(index, builder.getInt64(1)), tailEnd);
+    builder.CreateBr(tailCond);
+
+    builder.SetInsertPoint(exit);
+    builder.CreateRetVoid();
+}
+
+}
+
 const std::string ComputePointFunction::Name = "compute_point";
 const std::string ComputePointRangeFunction::Name = "compute_point_range";
+const std::string ComputePointGroupRangeFunction::Name = "compute_point_group_range";
 
 const std::array<std::string, ComputePointFunction::N_ARGS> ComputePointFunction::ArgumentKeys =
+{
+    "kernel_context",
+    "point_index"
+};
+
+const std::array<std::string, ComputePointFunction::Context::N_MEMBERS>
+ComputePointFunction::Context::Keys =
 {
     "custom_data",
     "attribute_set",
-    "point_index",
     "attribute_handles",
+    "attribute_arrays",
     "group_handles",
+    "group_arrays",
+    "group_masks",
+    "strings",
+    "string_literals",
     "leaf_data"
 };
 
+llvm::StructType* ComputePointFunction::Context::llvmType(llvm::LLVMContext& C)
+{
+    llvm::Type* members[] = {
+        LLVMType<const void*>::get(C),
+        LLVMType<const void*>::get(C),
+        LLVMType<void**>::get(C),
+        LLVMType<void**>::get(C),
+        LLVMType<void**>::get(C),
+        LLVMType<void**>::get(C),
+        LLVMType<uint8_t*>::get(C),
+        LLVMType<char**>::get(C),
+        LLVMType<Index*>::get(C),
+        LLVMType<void*>::get(C)
+    };
+    static_assert(sizeof(members) / sizeof(llvm::Type*) == N_MEMBERS,
+        "Mismatching point kernel context members.");
+    return llvm::StructType::get(C, members);
+}
+
 PointComputeGenerator::PointComputeGenerator(llvm::Module& module,
                                              CustomData* customData,
                                              const FunctionOptions& options,
                                              FunctionRegistry& functionRegistry,
-                                             std::vector<std::string>* const warnings)
+                                             std::vector<std::string>* const warnings,
+                                             const size_t vectorWidth)
     : ComputeGenerator(module, customData, options, functionRegistry, warnings)
     , mLLVMArguments()
-    , mAttributeVisitCount(0) {}
+    , mAttributeVisitCount(0)
+    , mStringIndices()
+    , mVectorWidth(vectorWidth) {}
+
+bool PointComputeGenerator::isPointInvariant(const ast::Tree& tree,
+                                             FunctionRegistry& functionRegistry,
+                                             const FunctionOptions& options)
+{
+    bool invariant = true;
+
+    ast::visitNodeType<ast::Attribute>(tree,
+        [&](const ast::Attribute& node) {
+            if (node.mName == "P" || node.mType == "string") invariant = false;
+        });
+    ast::visitNodeType<ast::FunctionCall>(tree,
+        [&](const ast::FunctionCall& node) {
+            // functions which are unknown or not explicitly pure may edit the point
+            // data or depend on the order of evaluation
+            const FunctionBase::Ptr function =
+                functionRegistry.getOrInsert(node.mFunction, options, false);
+            if (!function || !function->isPure()) invariant = false;
+        });
+
+    return invariant;
+}
+
+bool PointComputeGenerator::isGroupAccess(const ast::FunctionCall& node,
+                                          std::string& name,
+                                          bool& write)
+{
+    name.clear();
+
+    if (node.mFunction != "ingroup" &&
+        node.mFunction != "addtogroup" &&
+        node.mFunction != "removefromgroup") return false;
+
+    write = node.mFunction != "ingroup";
+
+    // empty names are never groups, so are left to the runtime functions
+
+    if (node.mArguments && node.mArguments->mList.size() == 1) {
+        const ast::Value<std::string>* const literal =
+            dynamic_cast<const ast::Value<std::string>*>(node.mArguments->mList.front().get());
+        if (literal) name = literal->mValue;
+    }
+
+    return true;
+}
+
+bool PointComputeGenerator::isVectorizable(const ast::Tree& tree,
+                                           FunctionRegistry& functionRegistry,
+                                           const FunctionOptions& options)
+{
+    bool vectorizable = isPointInvariant(tree, functionRegistry, options);
 
-void PointComputeGenerator::init(const ast::Tree&)
+    ast::visitNodeType<ast::DeclareLocal>(tree,
+        [&](const ast::DeclareLocal& node) {
+            if (node.mType == "string") vectorizable = false;
+        });
+    ast::visitNodeType<ast::Value<std::string>>(tree,
+        [&](const ast::Value<std::string>&) { vectorizable = false; });
+
+    return vectorizable;
+}
+
+void PointComputeGenerator::init(const ast::Tree& tree)
 {
+    if (mVectorWidth != 0 && mVectorWidth != 4 && mVectorWidth != 8 && mVectorWidth != 16) {
+        OPENVDB_THROW(AXCompilerError, "Unsupported point vector width " +
+            std::to_string(mVectorWidth) + ". Must be 4, 8 or 16.");
+    }
+
     std::vector<llvm::Type*> argTypes;
     llvmTypesFromSignature<ComputePointFunction::Signature>(mContext, &argTypes);
     assert(argTypes.size() == ComputePointFunction::N_ARGS);
@@ -124,6 +373,37 @@ void PointComputeGenerator::init(const ast::Tree&)
             + "\" already exists!");
     }
 
+    argTypes.clear();
+    llvmTypesFromSignature<ComputePointGroupRangeFunction::Signature>(mContext, &argTypes);
+
+    llvm::FunctionType* groupRangeFunctionType =
+        llvm::FunctionType::get(/*Return*/LLVMType<ComputePointFunction::ReturnT>::get(mContext),
+                          llvm::ArrayRef<llvm::Type*>(argTypes),
+                          /*Variable args*/ false);
+
+    llvm::Function* computePointGroupRange =
+        llvm::Function::Create(groupRangeFunctionType,
+                               llvm::Function::ExternalLinkage,
+                               ComputePointGroupRangeFunction::Name,
+                               &mModule);
+
+    if (computePointGroupRange->getName() != ComputePointGroupRangeFunction::Name) {
+        OPENVDB_THROW(LLVMModuleError, "Function \"" + ComputePointGroupRangeFunction::Name
+            + "\" already exists!");
+    }
+
+    // the context is only read by the generated functions and is not accessible
+    // through any other argument, which allows its loads to be hoisted out of the
+    // point loops
+
+    for (llvm::Function* function : { computePoint, computePointRange, computePointGroupRange }) {
+        function->addParamAttr(0, llvm::Attribute::NoAlias);
+        function->addParamAttr(0, llvm::Attribute::NoCapture);
+        function->addParamAttr(0, llvm::Attribute::ReadOnly);
+    }
+
+    generateGroupRange(computePointGroupRange, computePoint);
+
     // Set up arguments for initial entry
 
     llvm::Function::arg_iterator argIter = computePointRange->arg_begin();
@@ -142,7 +422,7 @@ void PointComputeGenerator::init(const ast::Tree&)
     {
         // For the computePointRange function, simply create a for loop which calls
         // compute_point for every point index 0 to mPointCount. The argument types for
-        // computePointRange and compute_point are the same, but the third argument for
+        // computePointRange and compute_point are the same, but the second argument for
         // compute_point is the point index rather than the point range
 
         llvm::BasicBlock* preLoop = llvm::BasicBlock::Create(mContext, "__entry_compute", computePointRange);
@@ -179,7 +459,17 @@ void PointComputeGenerator::init(const ast::Tree&)
         llvm::BasicBlock* loopEnd = mBuilder.GetInsertBlock();
 
         llvm::BasicBlock* postLoop = llvm::BasicBlock::Create(mContext, "__post_loop_compute", computePointRange);
-        mBuilder.CreateCondBr(endCondition, loop, postLoop);
+        llvm::BranchInst* branch = mBuilder.CreateCondBr(endCondition, loop, postLoop);
+
+        // evaluate several points per iteration by inlining compute_point and
+        // vectorising the loop
+
+        if (mVectorWidth != 0 && isVectorizable(tree, mFunctionRegistry, mOptions)) {
+            computePoint->addFnAttr(llvm::Attribute::AlwaysInline);
+            branch->setMetadata(llvm::LLVMContext::MD_loop,
+                vectorizeLoopMetadata(mContext, mVectorWidth));
+        }
+
         mBuilder.SetInsertPoint(postLoop);
         incr->addIncoming(next, loopEnd);
 
@@ -201,6 +491,25 @@ void PointComputeGenerator::init(const ast::Tree&)
     mBuilder.SetInsertPoint(mBlocks.top());
     mCurrentBlock = 1;
 
+    // Load the leaf bindings from the kernel context. The context is a noalias readonly
+    // argument, so once compute_point is inlined into the range loops LICM hoists
+    // these loads out of the loop. They must not be marked as invariant loads, as the
+    // context is rewritten for every leaf
+
+    llvm::StructType* contextType = ComputePointFunction::Context::llvmType(mContext);
+    llvm::Value* context = mBuilder.CreateBitCast(mLLVMArguments.get("kernel_context"),
+        contextType->getPointerTo());
+
+    for (size_t i = 0; i < ComputePointFunction::Context::N_MEMBERS; ++i) {
+        const std::string& key = ComputePointFunction::Context::Keys[i];
+        llvm::LoadInst* member =
+            mBuilder.CreateLoad(mBuilder.CreateStructGEP(contextType, context, i), key);
+        if (!mLLVMArguments.insert(key, member)) {
+            OPENVDB_THROW(LLVMFunctionError, "Function \"" + ComputePointFunction::Name
+                + "\" has been setup with non-unique argument keys.");
+        }
+    }
+
     // Set the base code generator function to the compute point function
 
     mFunction = computePoint;
@@ -255,6 +564,10 @@ void PointComputeGenerator::visit(const ast::AssignExpression& node)
     const std::string& type = attribute->mType;
     const bool usingPosition = (attribute->mName == "P");
 
+    if (type == "string") {
+        OPENVDB_THROW(AXCompilerError, "Writing to string attributes not yet supported.");
+    }
+
     // attribute should already exist
     assert(usingPosition || this->globals().exists(getGlobalAttributeAccess(attribute->mName, type)));
 
@@ -324,6 +637,21 @@ void PointComputeGenerator::visit(const ast::AssignExpression& node)
         }
     }
 
+    // store directly into the attribute's values where possible
+
+    llvm::BasicBlock* handleBlock = nullptr;
+    llvm::BasicBlock* continueBlock = nullptr;
+
+    llvm::Value* array = (usingPosition || lhsIsString) ? nullptr :
+        this->attributeArray(attribute->mName, type);
+
+    if (array) {
+        llvm::Value* value = this->beginDirectAccess(array, lhsType, handleBlock, continueBlock);
+        mBuilder.CreateStore(rhs->getType()->isPointerTy() ? mBuilder.CreateLoad(rhs) : rhs, value);
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(handleBlock);
+    }
+
     // construct function arguments
     std::vector<llvm::Value*> argumentValues;
     argumentValues.reserve(lhsIsString ? 4 : 3);
@@ -345,6 +673,11 @@ void PointComputeGenerator::visit(const ast::AssignExpression& node)
         const FunctionBase::Ptr function = this->getFunction("setattribute", mOptions, true);
         function->execute(argumentValues, mLLVMArguments.map(), mBuilder, mModule);
     }
+
+    if (array) {
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(continueBlock);
+    }
 }
 
 void PointComputeGenerator::visit(const ast::Crement& node)
@@ -357,6 +690,12 @@ void PointComputeGenerator::visit(const ast::Crement& node)
 
     --mAttributeVisitCount;
 
+    const ast::Attribute* const attribute =
+        dynamic_cast<const ast::Attribute*>(node.mVariable.get());
+    if (attribute && attribute->mType == "string") {
+        OPENVDB_THROW(AXCompilerError, "Writing to string attributes not yet supported.");
+    }
+
     llvm::Value* rhs = mValues.top(); mValues.pop();
     llvm::Value* lhs = mValues.top(); mValues.pop();
 
@@ -394,6 +733,24 @@ void PointComputeGenerator::visit(const ast::Crement& node)
     }
 
     assert(node.mVariable);
+    const ast::Attribute* const attribute =
+        static_cast<const ast::Attribute* const>(node.mVariable.get());
+    assert(attribute);
+
+    // store directly into the attribute's values where possible
+
+    llvm::BasicBlock* handleBlock = nullptr;
+    llvm::BasicBlock* continueBlock = nullptr;
+
+    llvm::Value* array = attribute->mName == "P" ? nullptr :
+        this->attributeArray(attribute->mName, attribute->mType);
+
+    if (array) {
+        llvm::Value* value = this->beginDirectAccess(array, type, handleBlock, continueBlock);
+        mBuilder.CreateStore(rhs, value);
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(handleBlock);
+    }
 
     std::vector<llvm::Value*> argumentValues;
     argumentValues.reserve(3);
@@ -403,9 +760,6 @@ void PointComputeGenerator::visit(const ast::Crement& node)
     argumentValues.emplace_back(rhs);
 
     // @TODO: if supporting vector crement, reenable this
-    // const ast::Attribute* const attribute =
-    //     static_cast<const ast::Attribute* const>(node.mVariable.get());
-    // assert(attribute);
     // if (attribute->mName == "P") {
     //     const FunctionBase::Ptr function = getFunctionFromRegistry("__setpointpws", mOptions);
     //     function->execute(argumentValues, mLLVMArguments.map(), mBuilder, mModule);
@@ -413,6 +767,11 @@ void PointComputeGenerator::visit(const ast::Crement& node)
     const FunctionBase::Ptr function = this->getFunction("setattribute", mOptions, true);
     function->execute(argumentValues, mLLVMArguments.map(), mBuilder, mModule);
 
+    if (array) {
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(continueBlock);
+    }
+
     // decide what to put on the expression stack
 
     if (node.mPost) {
@@ -436,12 +795,16 @@ void PointComputeGenerator::visit(const ast::FunctionCall& node)
         this->getFunction(node.mFunction, mOptions, /*no internal access*/false);
     assert(function);
 
-    if (function->context() & FunctionBase::Base) {
-        ComputeGenerator::visit(node);
-        return;
-    }
+    // prefer the point context where available so that any custom data is accessed
+    // through the kernel arguments rather than a baked address, keeping the
+    // compiled object relocatable (required for object caching)
 
     if (!(function->context() & FunctionBase::Point)) {
+        if (function->context() & FunctionBase::Base) {
+            ComputeGenerator::visit(node);
+            return;
+        }
+
         OPENVDB_THROW(LLVMContextError, "\"" + node.mFunction +
             "\" called within an invalid context");
     }
@@ -452,6 +815,16 @@ void PointComputeGenerator::visit(const ast::FunctionCall& node)
     argumentsFromStack(mValues, args, arguments);
     parseDefaultArgumentState(arguments, mBuilder);
 
+    // groups named by literals are resolved when the program is compiled
+
+    std::string group;
+    bool write;
+    if (isGroupAccess(node, group, write) && !group.empty() && arguments.size() == 1) {
+        llvm::Value* result = this->groupAccess(node.mFunction, group, arguments.front());
+        if (result) mValues.push(result);
+        return;
+    }
+
     std::vector<llvm::Value*> results;
     llvm::Value* result = function->execute(arguments, mLLVMArguments.map(), mBuilder, mModule, &results);
     llvm::Type* resultType = result->getType();
@@ -471,9 +844,6 @@ void PointComputeGenerator::visit(const ast::FunctionCall& node)
 
 void PointComputeGenerator::visit(const ast::Attribute& node)
 {
-    if (node.mType == "string") {
-        OPENVDB_THROW(AXCompilerError, "Access to string attributes not yet supported.");
-    }
     if (node.mName == "P") {
         // if accessing position the ptr we push back is actually to the leaf_data
         llvm::Value* leafDataPtr = mLLVMArguments.get("leaf_data");
@@ -541,26 +911,43 @@ void PointComputeGenerator::visit(const ast::AttributeValue& node)
 
     const bool usingString(!usingPosition && type == "string");
     if (usingString) {
-        OPENVDB_THROW(AXCompilerError, "Access to string attributes not yet supported.");
-        // const FunctionBase::Ptr function = this->getFunction("strattribsize", mOptions, true);
-        // llvm::Value* size =
-        //     function->execute({handlePtr, mLLVMArguments.get("point_index"), mLLVMArguments.get("leaf_data")},
-        //         mLLVMArguments.map(), mBuilder, mModule, nullptr, true);
-
-        // returnValue = mBuilder.CreateAlloca(returnType, size);
-        // args.reserve(4);
+        // strings are not copied, the pushed value points into the metadata shared by
+        // the leaves. The metadata index of the string is kept so that it can be
+        // compared directly, see visit(ast::BinaryOperator)
+
+        llvm::Value* indices = mBuilder.CreatePointerCast(this->attributeArray(name, type),
+            LLVMType<Index*>::get(mContext));
+        llvm::Value* index =
+            mBuilder.CreateLoad(mBuilder.CreateGEP(indices, mLLVMArguments.get("point_index")));
+        llvm::Value* string =
+            mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("strings"), index));
+
+        mStringIndices[string] = index;
+        mValues.push(string);
+        return;
     }
-    else {
-        returnValue = mBuilder.CreateAlloca(returnType);
-        args.reserve(3);
+
+    returnValue = mBuilder.CreateAlloca(returnType);
+    args.reserve(3);
+
+    // load directly from the attribute's values where possible
+
+    llvm::BasicBlock* handleBlock = nullptr;
+    llvm::BasicBlock* continueBlock = nullptr;
+
+    llvm::Value* array = usingPosition ? nullptr : this->attributeArray(name, type);
+
+    if (array) {
+        llvm::Value* value = this->beginDirectAccess(array, returnType, handleBlock, continueBlock);
+        mBuilder.CreateStore(mBuilder.CreateLoad(value), returnValue);
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(handleBlock);
     }
 
     args.emplace_back(handlePtr);
     args.emplace_back(mLLVMArguments.get("point_index"));
     args.emplace_back(returnValue);
 
-    if (usingString) args.emplace_back(mLLVMArguments.get("leaf_data"));
-
     if (usingPosition) {
         const FunctionBase::Ptr function = this->getFunction("getpointpws", mOptions, true);
         function->execute(args, mLLVMArguments.map(), mBuilder, mModule, nullptr, /*add output args*/false);
@@ -570,9 +957,200 @@ void PointComputeGenerator::visit(const ast::AttributeValue& node)
         function->execute(args, mLLVMArguments.map(), mBuilder, mModule, nullptr, /*add output args*/false);
     }
 
+    if (array) {
+        mBuilder.CreateBr(continueBlock);
+        mBuilder.SetInsertPoint(continueBlock);
+    }
+
     mValues.push(returnValue);
 }
 
+llvm::Value*
+PointComputeGenerator::attributeArray(const std::string& name, const std::string& type)
+{
+    // booleans are stored as bytes, see rawAttributeData. The values of string
+    // attributes are always the metadata indices of their strings, see stringIndices
+
+    if (type == "bool") return nullptr;
+
+    const std::string globalName = getGlobalAttributeAccess(name, type);
+    assert(this->globals().exists(globalName));
+
+    // the array pointers are rebound for every leaf, so these loads are left to LICM,
+    // which hoists them out of the point loop as the arrays are reached through the
+    // noalias kernel context
+
+    llvm::Value* index = mBuilder.CreateLoad(llvm::cast<llvm::GlobalVariable>
+        (mModule.getOrInsertGlobal(globalName, LLVMType<int64_t>::get(mContext))));
+
+    return mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("attribute_arrays"), index));
+}
+
+void PointComputeGenerator::visit(const ast::BinaryOperator& node)
+{
+    // strings read from attributes are compared by their metadata index, as the
+    // metadata holds each string once. They may be compared against each other or
+    // against string literals
+
+    const bool equality = node.mOperation == ast::tokens::EQUALSEQUALS ||
+        node.mOperation == ast::tokens::NOTEQUALS;
+
+    if (!equality || mStringIndices.empty()) {
+        ComputeGenerator::visit(node);
+        return;
+    }
+
+    llvm::Value* rhs = mValues.top(); mValues.pop();
+    llvm::Value* lhs = mValues.top();
+    mValues.push(rhs);
+
+    const auto lhsIter = mStringIndices.find(lhs);
+    const auto rhsIter = mStringIndices.find(rhs);
+
+    const ast::Value<std::string>* const lhsLiteral =
+        dynamic_cast<const ast::Value<std::string>*>(node.mLeft.get());
+    const ast::Value<std::string>* const rhsLiteral =
+        dynamic_cast<const ast::Value<std::string>*>(node.mRight.get());
+
+    const bool lhsString = lhsIter != mStringIndices.end();
+    const bool rhsString = rhsIter != mStringIndices.end();
+
+    if (!(lhsString && (rhsString || rhsLiteral)) && !(rhsString && lhsLiteral)) {
+        ComputeGenerator::visit(node);
+        return;
+    }
+
+    mValues.pop();
+    mValues.pop();
+
+    llvm::Value* lhsIndex = lhsString ? lhsIter->second : this->stringLiteral(lhsLiteral->mValue);
+    llvm::Value* rhsIndex = rhsString ? rhsIter->second : this->stringLiteral(rhsLiteral->mValue);
+
+    llvm::Value* result = node.mOperation == ast::tokens::EQUALSEQUALS ?
+        mBuilder.CreateICmpEQ(lhsIndex, rhsIndex) : mBuilder.CreateICmpNE(lhsIndex, rhsIndex);
+
+    llvm::Value* store = mBuilder.CreateAlloca(result->getType());
+    mBuilder.CreateStore(result, store);
+    mValues.push(store);
+}
+
+llvm::Value*
+PointComputeGenerator::stringLiteral(const std::string& string)
+{
+    const std::string globalName = getGlobalStringAccess(string);
+
+    llvm::Value* slot = llvm::cast<llvm::GlobalVariable>
+        (mModule.getOrInsertGlobal(globalName, LLVMType<int64_t>::get(mContext)));
+    this->globals().insert(globalName, slot);
+
+    // the metadata indices are resolved for every execution, so these loads are left
+    // to LICM to hoist out of the point loop
+
+    llvm::Value* index = mBuilder.CreateLoad(slot);
+    return mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("string_literals"), index));
+}
+
+llvm::Value*
+PointComputeGenerator::groupAccess(const std::string& function,
+                                   const std::string& group,
+                                   llvm::Value* name)
+{
+    // insert the group into the map of global variables. The global holds the slot of
+    // the group's bindings, which is assigned once all accesses are known
+
+    const std::string globalName = getGlobalGroupAccess(group);
+
+    llvm::GlobalVariable* global = llvm::cast<llvm::GlobalVariable>
+        (mModule.getOrInsertGlobal(globalName, LLVMType<int64_t>::get(mContext)));
+    this->globals().insert(globalName, global);
+
+    // the bindings are rebound for every leaf, so these loads are left to LICM to
+    // hoist out of the point loop
+
+    llvm::Value* index = mBuilder.CreateLoad(global);
+    llvm::Value* array =
+        mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("group_arrays"), index));
+    llvm::Value* mask =
+        mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("group_masks"), index));
+
+    const bool read = function == "ingroup";
+    const bool flag = function != "removefromgroup";
+
+    llvm::Value* result = read ? mBuilder.CreateAlloca(LLVMType<bool>::get(mContext)) : nullptr;
+
+    // test or set the group's bit directly where possible
+
+    llvm::BasicBlock* handleBlock = nullptr;
+    llvm::BasicBlock* continueBlock = nullptr;
+
+    llvm::Value* value =
+        this->beginDirectAccess(array, LLVMType<uint8_t>::get(mContext), handleBlock, continueBlock);
+    llvm::Value* bits = mBuilder.CreateLoad(value);
+
+    if (read) {
+        mBuilder.CreateStore(mBuilder.CreateICmpNE(mBuilder.CreateAnd(bits, mask),
+            mBuilder.getInt8(0)), result);
+    }
+    else if (flag) {
+        mBuilder.CreateStore(mBuilder.CreateOr(bits, mask), value);
+    }
+    else {
+        mBuilder.CreateStore(mBuilder.CreateAnd(bits, mBuilder.CreateNot(mask)), value);
+    }
+
+    mBuilder.CreateBr(continueBlock);
+    mBuilder.SetInsertPoint(handleBlock);
+
+    // otherwise call the group function with the bound handle, which is a null pointer
+    // for groups which do not exist in the leaf
+
+    llvm::Value* handle =
+        mBuilder.CreateLoad(mBuilder.CreateGEP(mLLVMArguments.get("group_handles"), index));
+
+    std::vector<llvm::Value*> args {
+        name,
+        mLLVMArguments.get("point_index"),
+        handle,
+        mLLVMArguments.get("leaf_data"),
+        llvm::ConstantPointerNull::get(LLVMType<void*>::get(mContext))
+    };
+
+    if (read) {
+        const FunctionBase::Ptr internal = this->getFunction("internal_ingroup", mOptions, true);
+        mBuilder.CreateStore(internal->execute(args, mLLVMArguments.map(), mBuilder, mModule), result);
+    }
+    else {
+        args.emplace_back(llvm::ConstantInt::get(LLVMType<bool>::get(mContext), flag));
+        const FunctionBase::Ptr internal = this->getFunction(flag ?
+            "internal_addtogroup" : "internal_removefromgroup", mOptions, true);
+        internal->execute(args, mLLVMArguments.map(), mBuilder, mModule);
+    }
+
+    mBuilder.CreateBr(continueBlock);
+    mBuilder.SetInsertPoint(continueBlock);
+
+    return result;
+}
+
+llvm::Value*
+PointComputeGenerator::beginDirectAccess(llvm::Value* array,
+                                         llvm::Type* type,
+                                         llvm::BasicBlock*& handleBlock,
+                                         llvm::BasicBlock*& continueBlock)
+{
+    llvm::BasicBlock* directBlock = llvm::BasicBlock::Create(mContext, "attribute_direct", mFunction);
+    handleBlock = llvm::BasicBlock::Create(mContext, "attribute_handle", mFunction);
+    continueBlock = llvm::BasicBlock::Create(mContext, "attribute_continue", mFunction);
+
+    llvm::Value* isDirect = mBuilder.CreateICmpNE(array,
+        llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(array->getType())));
+    mBuilder.CreateCondBr(isDirect, directBlock, handleBlock);
+
+    mBuilder.SetInsertPoint(directBlock);
+    llvm::Value* values = mBuilder.CreateBitCast(array, type->getPointerTo());
+    return mBuilder.CreateGEP(values, mLLVMArguments.get("point_index"));
+}
+
 }
 }
 }
@@ -39,8 +39,10 @@
 #ifndef OPENVDB_AX_POINT_COMPUTE_GENERATOR_HAS_BEEN_INCLUDED
 #define OPENVDB_AX_POINT_COMPUTE_GENERATOR_HAS_BEEN_INCLUDED
 
+#include "AttributeCodecs.h"
 #include "ComputeGenerator.h"
 #include "FunctionTypes.h"
+#include "LeafArena.h"
 #include "LeafLocalData.h"
 #include "Types.h"
 #include "Utils.h"
@@ -49,12 +51,15 @@
 #include <openvdb_ax/compiler/TargetRegistry.h>
 
 #include <openvdb/math/Transform.h>
+#include <openvdb/points/AttributeArrayString.h>
 #include <openvdb/points/AttributeGroup.h>
 #include <openvdb/points/PointConversion.h>
 
 #include <llvm/IR/Module.h>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 // fwd declaration
 namespace llvm
@@ -71,57 +76,209 @@ namespace codegen {
 
 /// @brief  Base untyped handle struct for container storage
 ///
-struct Handles { using UniquePtr = std::unique_ptr<Handles>; };
+struct Handles
+{
+    virtual ~Handles() = default;
+
+    /// @brief  Writes any values which were decoded for direct access back to the
+    ///         attribute array. Called once the generated function has completed
+    virtual void flush() {}
+};
+
+/// @brief  Returns a pointer to the values of an attribute array if they can be loaded
+///         and stored directly by generated code. This requires the array to be in-core,
+///         uncompressed, non-uniform, of stride one and to store ValueT without a codec.
+///         Otherwise returns a nullptr, in which case the array is decoded into a buffer
+///         if its codec is known (see decodeAttributeArray) or is accessed through its
+///         attribute handle.
+///
+template <typename ValueT>
+inline void*
+rawAttributeData(const points::AttributeArray& array)
+{
+    using ArrayT = points::TypedAttributeArray<ValueT, points::NullCodec>;
+
+    if (!array.isType<ArrayT>()) return nullptr;
+    if (array.isUniform() || array.isCompressed() || array.isOutOfCore()) return nullptr;
+    if (array.stride() != 1) return nullptr;
+
+    const ArrayT& typed = static_cast<const ArrayT&>(array);
+    return const_cast<void*>(static_cast<const void*>(typed.data()));
+}
+
+// booleans are stored as bytes rather than the bits of their llvm type
+template <>
+inline void* rawAttributeData<bool>(const points::AttributeArray&) { return nullptr; }
+
+// strings are indices into string metadata
+template <>
+inline void* rawAttributeData<Name>(const points::AttributeArray&) { return nullptr; }
+
+/// @brief  Returns the metadata indices of the strings held by a string attribute array.
+///         The indices are accessed in place where possible, otherwise they are decoded
+///         into the arena
+inline Index* stringIndices(LeafArena& arena, const points::AttributeArray& array)
+{
+    using ArrayT = points::StringAttributeArray;
+    assert(array.isType<ArrayT>());
+
+    if (!array.isUniform() && !array.isCompressed() && !array.isOutOfCore()) {
+        return const_cast<Index*>(static_cast<const ArrayT&>(array).data());
+    }
+
+    Index* indices = arena.createArray<Index>(array.size());
+    const points::AttributeHandle<Index, points::StringCodec<false>> handle(array);
+    for (Index i = 0; i < array.size(); ++i) indices[i] = handle.get(i);
+    return indices;
+}
+
+/// @brief  Creates the attribute handles of a leaf in an arena
+///
+template <typename ValueT>
+struct HandleFactory
+{
+    using LeafT = points::PointDataTree::LeafNodeType;
+    using HandleT = points::AttributeHandle<ValueT>;
+    using WriteHandleT = points::AttributeWriteHandle<ValueT>;
+
+    static inline HandleT*
+    read(LeafArena& arena, const LeafT& leaf, const size_t pos) {
+        return arena.create<HandleT>(leaf.constAttributeArray(pos));
+    }
+
+    /// @param expand  Whether to expand a uniform array. An unexpanded array may only
+    ///                have its first value set, which sets the value of every point
+    static inline WriteHandleT*
+    write(LeafArena& arena, LeafT& leaf, const size_t pos, const bool expand) {
+        return arena.create<WriteHandleT>(leaf.attributeArray(pos), expand);
+    }
+};
+
+template <>
+struct HandleFactory<Name>
+{
+    using LeafT = points::PointDataTree::LeafNodeType;
+    using HandleT = points::StringAttributeHandle;
+    using WriteHandleT = points::StringAttributeWriteHandle;
+
+    static inline HandleT*
+    read(LeafArena& arena, const LeafT& leaf, const size_t pos) {
+        return arena.create<HandleT>(leaf.constAttributeArray(pos),
+            leaf.attributeSet().descriptor().getMetadata());
+    }
+
+    static inline WriteHandleT*
+    write(LeafArena& arena, LeafT& leaf, const size_t pos, const bool expand) {
+        return arena.create<WriteHandleT>(leaf.attributeArray(pos),
+            leaf.attributeSet().descriptor().getMetadata(), expand);
+    }
+};
 
 /// @brief  A wrapper around a VDB Points Attribute Handle, allowing for
-///         typed storage of a read or write handle. This is used for
-///         automatic memory management and void pointer passing into the
-///         generated point functions
+///         typed storage of a read or write handle. The handle and any decoded
+///         values are allocated in the arena of the leaf, and passed as void
+///         pointers into the generated point functions
 ///
 template <typename ValueT>
 struct TypedHandle : public Handles
 {
-    using UniquePtr = std::unique_ptr<TypedHandle<ValueT>>;
-    using HandleTraits = points::point_conversion_internal::ConversionTraits<ValueT>;
-    using HandleT = typename HandleTraits::Handle;
-
     using LeafT = points::PointDataTree::LeafNodeType;
 
     inline void*
-    initReadHandle(const LeafT& leaf, const size_t pos) {
-        mHandle = HandleTraits::handleFromLeaf(const_cast<LeafT&>(leaf), pos);
-        return static_cast<void*>(mHandle.get());
+    initReadHandle(LeafArena& arena, const LeafT& leaf, const size_t pos) {
+        void* handle = HandleFactory<ValueT>::read(arena, leaf, pos);
+        this->initData(arena, leaf.constAttributeArray(pos));
+        mArray = nullptr;
+        return handle;
     }
 
+    /// @param expand  Whether to expand a uniform array. An unexpanded array may only
+    ///                have its first value set, which sets the value of every point
     inline void*
-    initWriteHandle(LeafT& leaf, const size_t pos) {
-        mHandle = HandleTraits::writeHandleFromLeaf(leaf, pos);
-        return static_cast<void*>(mHandle.get());
+    initWriteHandle(LeafArena& arena, LeafT& leaf, const size_t pos, const bool expand = true) {
+        // write handles expand uniform arrays, so the raw data is retrieved after
+        void* handle = HandleFactory<ValueT>::write(arena, leaf, pos, expand);
+        const bool decoded = this->initData(arena, leaf.constAttributeArray(pos));
+        if (decoded) this->initDecoded(arena, leaf.constAttributeArray(pos).size());
+        mArray = decoded ? &leaf.attributeArray(pos) : nullptr;
+        return handle;
+    }
+
+    /// @brief  Returns the values of the attribute array, or a nullptr if they may only
+    ///         be accessed through the handle. Arrays stored with a known codec are
+    ///         decoded into a buffer, others are accessed in place. See rawAttributeData
+    inline void* data() const { return mData; }
+
+    /// @brief  Encodes the decoded values of a write handle which have changed back into
+    ///         its array
+    inline void flush() override {
+        if (mArray) encodeAttributeArray<ValueT>(*mArray, mValues, mDecoded);
     }
 
 private:
-    typename HandleT::Ptr mHandle;
+    /// @brief  Returns true if the values were decoded into a buffer
+    inline bool initData(LeafArena& arena, const points::AttributeArray& array) {
+        mData = rawAttributeData<ValueT>(array);
+        if (mData || !canDecodeAttributeArray<ValueT>(array)) return false;
+        mValues = arena.createArray<ValueT>(array.size());
+        decodeAttributeArray<ValueT>(array, mValues);
+        mData = mValues;
+        return true;
+    }
+
+    /// @brief  Keeps a copy of the decoded values of a write handle, against which
+    ///         changes are found when the values are encoded
+    inline void initDecoded(LeafArena& arena, const size_t size) {
+        mDecoded = arena.createArray<ValueT>(size);
+        std::copy(mValues, mValues + size, mDecoded);
+    }
+
+    void* mData = nullptr;
+    ValueT* mValues = nullptr;
+    ValueT* mDecoded = nullptr;
+    points::AttributeArray* mArray = nullptr;
 };
 
+/// @brief  Returns the values of a group array if they can be accessed directly,
+///         otherwise a nullptr
+inline const uint8_t* groupArrayData(const points::AttributeArray& array)
+{
+    if (array.isUniform() || array.isCompressed() || array.isOutOfCore()) return nullptr;
+    if (!array.isType<points::GroupAttributeArray>()) return nullptr;
+    return static_cast<const points::GroupAttributeArray&>(array).data();
+}
+
 /// @brief  The function definition and signature which is built by the
 ///         PointComputeGenerator.
 ///
 ///         The argument structure is as follows:
 ///
+///           1) - A void pointer to the Context of the current leaf
+///           2) - An unsigned integer, representing the leaf relative point
+///                id being executed
+///
+///         The Context holds the bindings of a leaf, which are loaded by the generated
+///         function:
+///
 ///           1) - A void pointer to the CustomData
 ///           2) - A void pointer to the leaf AttributeSet
-///           3) - A void pointer to an object of type openvdb::math::Transform,
-///                representing the current grids transform
-///           4) - A void pointer to an object of type openvdb::Coord,
-///                representing the current voxel being executed
-///           5) - An unsigned integer, representing the leaf relative point
-///                id being executed
-///           6) - A void pointer to a vector of void pointers, representing an
+///           3) - A void pointer to a vector of void pointers, representing an
 ///                array of attribute handles
-///           7) - A void pointer to a vector of void pointers, representing an
-///                array of group handles
-///           8) - A void pointer to a NewData object, used to track newly
-///                initialized attributes and arrays
+///           4) - A void pointer to a vector of void pointers, representing the
+///                raw values of each attribute handle, or null pointers for
+///                attributes which must be accessed through their handle
+///           5) - A void pointer to a vector of void pointers, representing an
+///                array of group handles in the order of the groups in the registry
+///           6) - A void pointer to a vector of void pointers, representing the
+///                raw values of each group handle's array, or null pointers for
+///                groups which must be accessed through their handle
+///           7) - A pointer to the bit of each group within its array's values
+///           8) - A pointer to the null terminated strings of the metadata shared by
+///                the leaves, indexed by the values of string attributes
+///           9) - A pointer to the metadata index of each string literal compared
+///                against string attributes, in the order of the registry
+///           10) - A void pointer to a NewData object, used to track newly
+///                 initialized attributes and arrays
 ///
 struct ComputePointFunction
 {
@@ -131,11 +288,7 @@ struct ComputePointFunction
     /// The signature of the generated function
     using Signature =
         void(const void* const,
-             const void* const,
-             uint64_t,
-             void**,
-             void**,
-             void*);
+             uint64_t);
 
     using SignaturePtr = std::add_pointer<Signature>::type;
     using FunctionT = std::function<Signature>;
@@ -147,39 +300,116 @@ struct ComputePointFunction
     /// The argument key names available during code generation
     static const std::array<std::string, N_ARGS> ArgumentKeys;
 
-    /// @brief  The arguments of the generated function
+    /// @brief  The bindings of a leaf, passed to the generated function by pointer. The
+    ///         layout must match that of llvmType(). The generated function may assume
+    ///         that the context is not modified or accessed through any other pointer
+    ///         while it runs.
+    ///
+    struct Context
+    {
+        const void* mCustomData;
+        const void* mAttributeSet;
+        void** mAttributeHandles;
+        void** mAttributeArrays;
+        void** mGroupHandles;
+        void** mGroupArrays;
+        uint8_t* mGroupMasks;
+        const char* const* mStrings;
+        const Index* mStringLiterals;
+        void* mLeafData;
+
+        /// The number of members of the context
+        static const size_t N_MEMBERS = 10;
+
+        /// The key names of each member available during code generation
+        static const std::array<std::string, N_MEMBERS> Keys;
+
+        /// @brief  Returns the llvm type of the context
+        static llvm::StructType* llvmType(llvm::LLVMContext& C);
+    };
+
+    static_assert(std::is_standard_layout<Context>::value,
+        "The point kernel context must be a standard layout type.");
+
+    /// @brief  The arguments of the generated function. The bindings of each leaf are
+    ///         allocated in an arena, which is reset for the next leaf.
     ///
     struct Arguments
     {
-        Arguments(const CustomData& customData,
-                  const points::AttributeSet& attributeSet,
-                  const size_t pointCount)
-            : mCustomData(&customData)
-            , mAttributeSet(&attributeSet)
-            , mIndex(0)
-            , mLeafLocalData(new LeafLocalData(pointCount))
-            , mVoidAttributeHandles()
-            , mAttributeHandles()
-            , mVoidGroupHandles()
-            , mGroupHandles() {}
-
-        /// @brief  Given a built version of the function signature, automatically
-        ///         bind the current arguments and return a callable function
-        ///         which takes no arguments
+        /// @param  customData  The custom data of the executable
+        /// @param  arena       The arena from which the bindings are allocated. Objects
+        ///                     in the arena are destroyed by each call to reset
+        Arguments(const CustomData& customData, LeafArena& arena)
+            : mIndex(0)
+            , mLeafLocalData(nullptr)
+            , mContext()
+            , mArena(arena)
+            , mAttributeHandles(nullptr)
+            , mAttributeCount(0)
+            , mMaxAttributes(0)
+            , mGroupCount(0)
+            , mMaxGroups(0)
+        {
+            mContext.mCustomData = &customData;
+        }
+
+        /// @brief  Destroys the bindings of the previous leaf and prepares those of a
+        ///         new leaf
+        ///
+        /// @param  attributeSet  The attribute set of the leaf
+        /// @param  leafData      The local data of the leaf
+        /// @param  attributes    The number of attribute handles which will be added
+        /// @param  groups        The number of group handles which will be added
+        ///
+        inline void
+        reset(const points::AttributeSet& attributeSet,
+              LeafLocalData& leafData,
+              const size_t attributes,
+              const size_t groups)
+        {
+            mArena.reset();
+            mIndex = 0;
+            mLeafLocalData = &leafData;
+
+            mContext.mAttributeSet = &attributeSet;
+            mContext.mAttributeHandles = mArena.createArray<void*>(attributes);
+            mContext.mAttributeArrays = mArena.createArray<void*>(attributes);
+            mContext.mGroupHandles = mArena.createArray<void*>(groups);
+            mContext.mGroupArrays = mArena.createArray<void*>(groups);
+            mContext.mGroupMasks = mArena.createArray<uint8_t>(groups);
+            mContext.mLeafData = &leafData;
+
+            mAttributeHandles = mArena.createArray<Handles*>(attributes);
+            mAttributeCount = 0;
+            mMaxAttributes = attributes;
+            mGroupCount = 0;
+            mMaxGroups = groups;
+        }
+
+        /// @brief  Calls a built version of the function signature with the current
+        ///         arguments
         ///
         /// @param  function  The fully generated function built from the
         ///                   PointComputeGenerator
         ///
-        inline std::function<ReturnT()>
-        bind(Signature function)
+        inline void
+        call(SignaturePtr function)
+        {
+            function(&mContext, mIndex);
+        }
+
+        /// @brief  Calls a group range function with the current arguments. See
+        ///         ComputePointGroupRangeFunction
+        ///
+        /// @param  function   The group range function
+        /// @param  groupData  The values of the leaf's group attribute array
+        /// @param  groupMask  The bit of the group within each value
+        ///
+        template <typename GroupSignature>
+        inline void
+        call(GroupSignature* function, const uint8_t* groupData, const uint8_t groupMask)
         {
-            return std::bind(function,
-                static_cast<FunctionTraitsT::Arg<0>::Type>(mCustomData),
-                static_cast<FunctionTraitsT::Arg<1>::Type>(mAttributeSet),
-                static_cast<FunctionTraitsT::Arg<2>::Type>(mIndex),
-                static_cast<FunctionTraitsT::Arg<3>::Type>(mVoidAttributeHandles.data()),
-                static_cast<FunctionTraitsT::Arg<4>::Type>(mVoidGroupHandles.data()),
-                static_cast<FunctionTraitsT::Arg<5>::Type>(mLeafLocalData.get()));
+            function(&mContext, mIndex, groupData, groupMask);
         }
 
         template <typename ValueT>
@@ -187,51 +417,126 @@ struct ComputePointFunction
         addHandle(const points::PointDataTree::LeafNodeType& leaf,
                   const size_t pos)
         {
-            typename TypedHandle<ValueT>::UniquePtr handle(new TypedHandle<ValueT>());
-            mVoidAttributeHandles.emplace_back(handle->initReadHandle(leaf, pos));
-            mAttributeHandles.emplace_back(std::move(handle));
+            assert(mAttributeCount < mMaxAttributes);
+            TypedHandle<ValueT>* handle = mArena.create<TypedHandle<ValueT>>();
+            mContext.mAttributeHandles[mAttributeCount] = handle->initReadHandle(mArena, leaf, pos);
+            mContext.mAttributeArrays[mAttributeCount] = handle->data();
+            mAttributeHandles[mAttributeCount++] = handle;
         }
 
         template <typename ValueT>
         inline void
         addWriteHandle(points::PointDataTree::LeafNodeType& leaf,
-                       const size_t pos)
+                       const size_t pos,
+                       const bool expand = true)
+        {
+            assert(mAttributeCount < mMaxAttributes);
+            TypedHandle<ValueT>* handle = mArena.create<TypedHandle<ValueT>>();
+            mContext.mAttributeHandles[mAttributeCount] =
+                handle->initWriteHandle(mArena, leaf, pos, expand);
+            mContext.mAttributeArrays[mAttributeCount] = handle->data();
+            mAttributeHandles[mAttributeCount++] = handle;
+        }
+
+        /// @brief  Binds a string attribute which is only read by the program. The
+        ///         program reads the metadata index of the string held by each point
+        ///         directly, see stringIndices
+        inline void
+        addStringHandle(const points::PointDataTree::LeafNodeType& leaf,
+                        const size_t pos)
         {
-            typename TypedHandle<ValueT>::UniquePtr handle(new TypedHandle<ValueT>());
-            mVoidAttributeHandles.emplace_back(handle->initWriteHandle(leaf, pos));
-            mAttributeHandles.emplace_back(std::move(handle));
+            assert(mAttributeCount < mMaxAttributes);
+            TypedHandle<Name>* handle = mArena.create<TypedHandle<Name>>();
+            mContext.mAttributeHandles[mAttributeCount] = handle->initReadHandle(mArena, leaf, pos);
+            mContext.mAttributeArrays[mAttributeCount] =
+                stringIndices(mArena, leaf.constAttributeArray(pos));
+            mAttributeHandles[mAttributeCount++] = handle;
         }
 
+        /// @brief  Sets the strings read from string attributes, which are shared by
+        ///         every leaf and must outlive the calls
+        /// @param  strings   The strings of the metadata, indexed by the values of
+        ///                   string attributes
+        /// @param  literals  The metadata index of each registered string literal
         inline void
-        addGroupHandle(const points::PointDataTree::LeafNodeType& leaf,
-                       const std::string& name)
+        setStrings(const char* const* strings, const Index* literals)
         {
-            assert(leaf.attributeSet().descriptor().hasGroup(name));
-            mGroupHandles.emplace_back(new points::GroupHandle(leaf.groupHandle(name)));
-            mVoidGroupHandles.emplace_back(static_cast<void*>(mGroupHandles.back().get()));
+            mContext.mStrings = strings;
+            mContext.mStringLiterals = literals;
         }
 
+        /// @brief  Binds a group which is only read by the program
+        /// @param  array   The leaf's array holding the group
+        /// @param  offset  The offset of the group within the array
         inline void
-        addGroupWriteHandle(points::PointDataTree::LeafNodeType& leaf,
-                            const std::string& name)
+        addGroupHandle(const points::AttributeArray& array,
+                       const points::GroupType offset)
         {
-            assert(leaf.attributeSet().descriptor().hasGroup(name));
-            mGroupHandles.emplace_back(new points::GroupWriteHandle(leaf.groupWriteHandle(name)));
-            mVoidGroupHandles.emplace_back(static_cast<void*>(mGroupHandles.back().get()));
+            assert(mGroupCount < mMaxGroups);
+            mContext.mGroupHandles[mGroupCount] = mArena.create<points::GroupHandle>
+                (points::GroupAttributeArray::cast(array), offset);
+            mContext.mGroupArrays[mGroupCount] =
+                const_cast<uint8_t*>(groupArrayData(array));
+            mContext.mGroupMasks[mGroupCount++] = uint8_t(1 << offset);
         }
 
-        inline void addNullGroupHandle() { mVoidGroupHandles.emplace_back(nullptr); }
+        /// @brief  Binds a group which is edited by the program. The array must be
+        ///         unique to the leaf, and is accessed directly if it has been expanded
+        /// @param  array   The leaf's array holding the group
+        /// @param  offset  The offset of the group within the array
+        inline void
+        addGroupWriteHandle(points::AttributeArray& array,
+                            const points::GroupType offset)
+        {
+            assert(mGroupCount < mMaxGroups);
+            mContext.mGroupHandles[mGroupCount] = mArena.create<points::GroupWriteHandle>
+                (points::GroupAttributeArray::cast(array), offset);
+            mContext.mGroupArrays[mGroupCount] =
+                const_cast<uint8_t*>(groupArrayData(array));
+            mContext.mGroupMasks[mGroupCount++] = uint8_t(1 << offset);
+        }
+
+        /// @brief  Binds a group which does not exist in the leaf. Any points added
+        ///         to it are stored in the leaf local data
+        inline void
+        addNullGroupHandle()
+        {
+            assert(mGroupCount < mMaxGroups);
+            mContext.mGroupHandles[mGroupCount] = nullptr;
+            mContext.mGroupArrays[mGroupCount] = nullptr;
+            mContext.mGroupMasks[mGroupCount++] = 0;
+        }
+
+        /// @brief  Returns the arena from which the bindings are allocated
+        inline LeafArena& arena() { return mArena; }
+
+        /// @brief  Writes back any attribute values which were decoded for direct
+        ///         access. Must be called once the called function has completed
+        inline void flush()
+        {
+            for (size_t i = 0; i < mAttributeCount; ++i) mAttributeHandles[i]->flush();
+        }
+
+        /// @brief  Destroys the bindings of the current leaf before the next call to
+        ///         reset. Required if the arrays of the leaf are to be replaced
+        inline void release()
+        {
+            mArena.reset();
+            mAttributeCount = 0;
+            mGroupCount = 0;
+        }
 
-        const CustomData* const mCustomData;
-        const points::AttributeSet* const mAttributeSet;
         uint64_t mIndex;
-        LeafLocalData::UniquePtr mLeafLocalData;
+        LeafLocalData* mLeafLocalData;
 
     private:
-        std::vector<void*> mVoidAttributeHandles;
-        std::vector<Handles::UniquePtr> mAttributeHandles;
-        std::vector<void*> mVoidGroupHandles;
-        std::vector<points::GroupHandle::Ptr> mGroupHandles;
+        Context mContext;
+        LeafArena& mArena;
+        Handles** mAttributeHandles;
+        size_t mAttributeCount;
+        size_t mMaxAttributes;
+        size_t mGroupCount;
+        size_t mMaxGroups;
     };
 };
 
@@ -243,6 +548,34 @@ struct ComputePointRangeFunction : public ComputePointFunction
     static const std::string Name;
 };
 
+/// @brief  An additional function built by the PointComputeGenerator which calls the
+///         compute function for each point of a leaf in a group. The group's array is
+///         scanned a word at a time for set bits. The arguments are those of the
+///         compute range function, followed by:
+///
+///           3) - A pointer to the values of the leaf's group attribute array
+///           4) - The bit of the group within each value
+///
+struct ComputePointGroupRangeFunction
+{
+    static const std::string Name;
+
+    using Signature =
+        void(const void* const,
+             uint64_t,
+             const uint8_t*,
+             uint8_t);
+
+    using SignaturePtr = std::add_pointer<Signature>::type;
+
+    /// @brief  Returns the values of a group array if they can be scanned by the group
+    ///         range function, otherwise a nullptr
+    static inline const uint8_t* groupData(const points::AttributeArray& array)
+    {
+        return groupArrayData(array);
+    }
+};
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -263,11 +596,14 @@ struct PointComputeGenerator : public ComputeGenerator
     ///                         for function calls
     /// @param warnings         Vector which will hold compiler warnings.  If null, no warnings will
     ///                         be stored.
+    /// @param vectorWidth      The number of points to evaluate per iteration of the point loop,
+    ///                         see CompilerOptions::pointVectorWidth. 0 generates a scalar loop.
     PointComputeGenerator(llvm::Module& module,
                           CustomData* customData,
                           const FunctionOptions& options,
                           FunctionRegistry& functionRegistry,
-                          std::vector<std::string>* const warnings = nullptr);
+                          std::vector<std::string>* const warnings = nullptr,
+                          const size_t vectorWidth = 0);
 
     /// @brief Retrieves the names of the generated IR functions
     /// @param list Vector of strings into which the function names will be retrieved
@@ -276,10 +612,26 @@ struct PointComputeGenerator : public ComputeGenerator
     {
         list.push_back(ComputePointFunction::Name);
         list.push_back(ComputePointRangeFunction::Name);
+        list.push_back(ComputePointGroupRangeFunction::Name);
     }
 
     ~PointComputeGenerator() override = default;
 
+    /// @brief Returns true if a syntax tree computes the same result for every point whose
+    ///        attributes hold the same values. Programs which access position or string
+    ///        attributes, or call any function which is not marked as pure (see
+    ///        FunctionBase::isPure) in the given registry, are not invariant.
+    static bool isPointInvariant(const ast::Tree& tree,
+                                 FunctionRegistry& functionRegistry,
+                                 const FunctionOptions& options);
+
+    /// @brief Returns true if the point loop of a syntax tree can be vectorised. This
+    ///        requires the tree to be point invariant and to not use strings. Other
+    ///        programs are always executed one point at a time.
+    static bool isVectorizable(const ast::Tree& tree,
+                               FunctionRegistry& functionRegistry,
+                               const FunctionOptions& options);
+
     /// @brief initializes visitor.  Automatically called when visiting the tree's root node.
     void init(const ast::Tree& node) override;
     void visit(const ast::AssignExpression& node) override;
@@ -287,15 +639,54 @@ struct PointComputeGenerator : public ComputeGenerator
     void visit(const ast::FunctionCall& node) override;
     void visit(const ast::Attribute& node) override;
     void visit(const ast::AttributeValue& node) override;
+    void visit(const ast::BinaryOperator& node) override;
+
+    /// @brief Returns true if a function call reads or edits a group. If the group is
+    ///        named by a string literal its name is set, otherwise the name is left
+    ///        empty and the group is found at runtime.
+    /// @param node   The function call
+    /// @param name   The name of the group if known
+    /// @param write  Set to whether the group is edited
+    static bool isGroupAccess(const ast::FunctionCall& node, std::string& name, bool& write);
 
 private:
 
+    /// @brief  Generates a group function for a group named by a literal. The group is
+    ///         bound to a slot in the registry, see isGroupAccess, and its bits are
+    ///         accessed directly where possible. Returns a pointer to the result of
+    ///         ingroup, otherwise a nullptr.
+    llvm::Value* groupAccess(const std::string& function, const std::string& group,
+        llvm::Value* name);
+
+    /// @brief  Returns the metadata index of a string literal compared against string
+    ///         attributes. The literal is bound to a slot in the registry and its index
+    ///         resolved when executed, see ComputePointFunction::Context
+    llvm::Value* stringLiteral(const std::string& string);
+
+    /// @brief  Returns the raw values of an attribute for the current leaf, or a nullptr
+    ///         if the attribute's type can never be accessed directly. The returned value
+    ///         is itself a null pointer at runtime if the attribute's array must be
+    ///         accessed through its handle.
+    llvm::Value* attributeArray(const std::string& name, const std::string& type);
+
+    /// @brief  Begins a branch on whether an attribute's values can be accessed directly.
+    ///         The builder is left in the direct access block and the returned pointer
+    ///         addresses the value of the current point.
+    llvm::Value* beginDirectAccess(llvm::Value* array, llvm::Type* type,
+        llvm::BasicBlock*& handleBlock, llvm::BasicBlock*& continueBlock);
+
     // The string mapped function variables, defined by the Function interface
     SymbolTable mLLVMArguments;
 
     // Track how many attributes have been visisted so we can choose the correct
     // code path
     size_t mAttributeVisitCount;
+
+    // The metadata index of each string read from a string attribute
+    std::map<llvm::Value*, llvm::Value*> mStringIndices;
+
+    // The requested width of the vectorised point loop
+    const size_t mVectorWidth;
 };
 
 }
@@ -41,57 +41,80 @@
 namespace point_functions_internal
 {
 
-    /// @brief  Retrieve a group handle from an expected vector of handles using the offset
-    ///         pointed to by the engine data. Note that HandleT should only ever be a GroupHandle
-    ///         or GroupWriteHandle object
-    template <typename HandleT>
-    inline HandleT*
-    groupHandle(const std::string& name, void** groupHandles, const void* const data)
+    /// @brief  Returns the index of a group within an attribute set, or an index
+    ///         whose array is INVALID_POS if the group does not exist
+    inline openvdb::points::AttributeSet::Descriptor::GroupIndex
+    groupIndex(const std::string& name, const void* const data)
     {
         const openvdb::points::AttributeSet* const attributeSet =
             static_cast<const openvdb::points::AttributeSet* const>(data);
 
-        const size_t groupIdx = attributeSet->groupOffset(name);
-        if (groupIdx == openvdb::points::AttributeSet::INVALID_POS) return nullptr;
-
-        return static_cast<HandleT*>(groupHandles[groupIdx]);
+        const size_t offset = attributeSet->groupOffset(name);
+        if (offset == openvdb::points::AttributeSet::INVALID_POS) {
+            return { openvdb::points::AttributeSet::INVALID_POS, 0 };
+        }
+        return attributeSet->groupIndex(offset);
     }
 
     void edit_group(const uint8_t* const name,
                    const uint64_t index,
-                   void** groupHandles,
+                   void* const groupHandle,
                    void* const leafDataPtr,
                    const void* const data,
                    const bool flag)
     {
+        // groups named by literals are bound before the leaf is executed
+
+        if (groupHandle) {
+            static_cast<openvdb::points::GroupWriteHandle*>(groupHandle)->set(index, flag);
+            return;
+        }
+
         const char * const sarray = reinterpret_cast<const char* const>(name);
         const std::string nameStr(sarray);
         if (nameStr.empty()) return;
 
-        openvdb::points::GroupWriteHandle* handle = nullptr;
-
-        // Get the group handle out of the pre-existing container of handles if they
-        // exist
-        if (groupHandles) {
-            handle = groupHandle<openvdb::points::GroupWriteHandle>(nameStr, groupHandles, data);
+        // otherwise find the group by name. The executable makes each group array
+        // unique to the leaf when groups are edited by name, see
+        // AttributeRegistry::dynamicGroupWrites
+
+        if (data) {
+            const openvdb::points::AttributeSet::Descriptor::GroupIndex group =
+                groupIndex(nameStr, data);
+            if (group.first != openvdb::points::AttributeSet::INVALID_POS) {
+                const openvdb::points::AttributeSet* const attributeSet =
+                    static_cast<const openvdb::points::AttributeSet* const>(data);
+                openvdb::points::GroupAttributeArray& array =
+                    openvdb::points::GroupAttributeArray::cast(
+                        const_cast<openvdb::points::AttributeArray&>(*attributeSet->getConst(group.first)));
+                openvdb::points::GroupWriteHandle handle(array, group.second);
+                handle.set(index, flag);
+                return;
+            }
         }
 
-        if (!handle) {
-            openvdb::ax::codegen::LeafLocalData* const leafData =
-                static_cast<openvdb::ax::codegen::LeafLocalData* const>(leafDataPtr);
+        openvdb::ax::codegen::LeafLocalData* const leafData =
+            static_cast<openvdb::ax::codegen::LeafLocalData* const>(leafDataPtr);
 
-            // If we are setting membership and the handle doesnt exist, create in in
-            // the set of new data thats being added
-            if (!flag && !leafData->hasGroup(nameStr)) return;
+        // If we are setting membership and the handle doesnt exist, create in in
+        // the set of new data thats being added
+        if (!flag && !leafData->hasGroup(nameStr)) return;
 
-            handle = leafData->getOrInsert(nameStr);
-            assert(handle);
-        }
+        openvdb::points::GroupWriteHandle* handle = leafData->getOrInsert(nameStr);
+        assert(handle);
 
         // set the group membership
         handle->set(index, flag);
     }
 
+    void delete_point(const uint64_t index,
+                      void* const leafDataPtr)
+    {
+        openvdb::ax::codegen::LeafLocalData* const leafData =
+            static_cast<openvdb::ax::codegen::LeafLocalData* const>(leafDataPtr);
+        leafData->deletePoint(index);
+    }
+
 }
 
 namespace openvdb {
@@ -104,19 +127,32 @@ namespace codegen {
 
 bool InGroup::Internal::in_group(const uint8_t* const name,
                                  const uint64_t index,
-                                 void** groupHandles,
+                                 const void* const groupHandle,
                                  const void* const leafDataPtr,
                                  const void* const data)
 {
-    if (!groupHandles) return false;
+    // groups named by literals are bound before the leaf is executed
+
+    if (groupHandle) {
+        return static_cast<const openvdb::points::GroupHandle*>(groupHandle)->get(index);
+    }
 
     const char * const sarray = reinterpret_cast<const char* const>(name);
     const std::string nameStr(sarray);
     if (nameStr.empty()) return false;
 
-    const openvdb::points::GroupHandle* handle =
-        point_functions_internal::groupHandle<openvdb::points::GroupHandle>(nameStr, groupHandles, data);
-    if (handle) return handle->get(index);
+    if (data) {
+        const openvdb::points::AttributeSet::Descriptor::GroupIndex group =
+            point_functions_internal::groupIndex(nameStr, data);
+        if (group.first != openvdb::points::AttributeSet::INVALID_POS) {
+            const openvdb::points::AttributeSet* const attributeSet =
+                static_cast<const openvdb::points::AttributeSet* const>(data);
+            const openvdb::points::GroupHandle handle(
+                openvdb::points::GroupAttributeArray::cast(*attributeSet->getConst(group.first)),
+                group.second);
+            return handle.get(index);
+        }
+    }
 
     // If the handle doesn't exist, check to see if any new groups have
     // been added
@@ -124,7 +160,7 @@ bool InGroup::Internal::in_group(const uint8_t* const name,
     const openvdb::ax::codegen::LeafLocalData* const leafData =
         static_cast<const openvdb::ax::codegen::LeafLocalData* const>(leafDataPtr);
 
-    handle = leafData->get(nameStr);
+    const openvdb::points::GroupHandle* handle = leafData->get(nameStr);
     return handle ? handle->get(index) : false;
 }
 
@@ -228,7 +264,7 @@ void GetPointPWS::get_point_pws(void* leafDataPtr,
     assert(index >= 0);
     openvdb::ax::codegen::LeafLocalData* leafData =
         static_cast<openvdb::ax::codegen::LeafLocalData*>(leafDataPtr);
-   (*value) = leafData->getPositions()[index];
+    (*value) = leafData->getPosition(index);
 }
 
 
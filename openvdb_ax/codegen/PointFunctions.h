@@ -64,10 +64,13 @@ namespace point_functions_internal
 {
     void edit_group(const uint8_t* const name,
                     const uint64_t index,
-                    void** groupHandles,
+                    void* const groupHandle,
                     void* const newDataPtr,
                     const void* const data,
                     const bool flag);
+
+    void delete_point(const uint64_t index,
+                      void* const leafDataPtr);
 }
 
 namespace openvdb {
@@ -91,7 +94,7 @@ struct InGroup : public FunctionBase
     private:
        static bool in_group(const uint8_t* const name,
                             const uint64_t index,
-                            void** groupHandles,
+                            const void* const groupHandle,
                             const void* const newDataPtr,
                             const void* const data);
     };
@@ -118,8 +121,11 @@ struct InGroup : public FunctionBase
 
         std::vector<llvm::Value*> internalArgs(args);
 
+        // groups named by string literals are bound by the PointComputeGenerator, see
+        // PointComputeGenerator::groupAccess. Here the group is found by name
+
         internalArgs.emplace_back(globals.at("point_index"));
-        internalArgs.emplace_back(globals.at("group_handles"));
+        internalArgs.emplace_back(llvm::ConstantPointerNull::get(LLVMType<void*>::get(builder.getContext())));
         internalArgs.emplace_back(globals.at("leaf_data"));
         internalArgs.emplace_back(globals.at("attribute_set"));
 
@@ -162,8 +168,11 @@ struct RemoveFromGroup : public FunctionBase
 
         std::vector<llvm::Value*> internalArgs(args);
 
+        // groups named by string literals are bound by the PointComputeGenerator, see
+        // PointComputeGenerator::groupAccess. Here the group is found by name
+
         internalArgs.emplace_back(globals.at("point_index"));
-        internalArgs.emplace_back(globals.at("group_handles"));
+        internalArgs.emplace_back(llvm::ConstantPointerNull::get(LLVMType<void*>::get(builder.getContext())));
         internalArgs.emplace_back(globals.at("leaf_data"));
         internalArgs.emplace_back(globals.at("attribute_set"));
 
@@ -209,8 +218,11 @@ struct AddToGroup : public FunctionBase
 
         std::vector<llvm::Value*> internalArgs(args);
 
+        // groups named by string literals are bound by the PointComputeGenerator, see
+        // PointComputeGenerator::groupAccess. Here the group is found by name
+
         internalArgs.emplace_back(globals.at("point_index"));
-        internalArgs.emplace_back(globals.at("group_handles"));
+        internalArgs.emplace_back(llvm::ConstantPointerNull::get(LLVMType<void*>::get(builder.getContext())));
         internalArgs.emplace_back(globals.at("leaf_data"));
         internalArgs.emplace_back(globals.at("attribute_set"));
 
@@ -223,6 +235,15 @@ struct AddToGroup : public FunctionBase
 
 struct DeletePoint : public FunctionBase
 {
+    struct Internal : public FunctionBase {
+        DEFINE_IDENTIFIER_CONTEXT_DOC("internal_deletepoint", FunctionBase::Point,
+            "Internal function for marking a point for deletion")
+        inline static Ptr create(const FunctionOptions&) { return Ptr(new Internal()); }
+        Internal() : FunctionBase({
+            DECLARE_FUNCTION_SIGNATURE(point_functions_internal::delete_point)
+        }) {}
+    };
+
     DEFINE_IDENTIFIER_CONTEXT_DOC("deletepoint", FunctionBase::Point,
         "Delete the current point from the point set. Note that this does not stop AX execution - "
         "any additional AX commands will be executed on the point and it will remain accessible "
@@ -236,7 +257,7 @@ struct DeletePoint : public FunctionBase
     }) {}
 
     inline void getDependencies(std::vector<std::string>& identifiers) const override {
-        identifiers.emplace_back("internal_addtogroup");
+        identifiers.emplace_back("internal_deletepoint");
     }
 
     llvm::Value*
@@ -245,12 +266,14 @@ struct DeletePoint : public FunctionBase
          llvm::IRBuilder<>& builder,
          llvm::Module& M) const override final {
 
-        llvm::Value* store = llvmStringToValue("dead", builder);
+        // the point is marked in the local data of the leaf, which removes it once
+        // the leaf has been executed
 
         std::vector<llvm::Value*> internalArgs(args);
-        internalArgs.emplace_back(store);
+        internalArgs.emplace_back(globals.at("point_index"));
+        internalArgs.emplace_back(globals.at("leaf_data"));
 
-        AddToGroup func;
+        Internal func;
         return func.execute(internalArgs, globals, builder, M);
     }
 };
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "StandardLibrary.h"
+
+#include <openvdb_ax/Exceptions.h>
+#include <openvdb_ax/ast/Hash.h>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <set>
+#include <vector>
+
+// generated at build time from codegen/bitcode/StandardLibrary.cc, or empty if
+// clang was not available
+extern "C" const unsigned char openvdb_ax_standard_library_bitcode[];
+extern "C" const size_t openvdb_ax_standard_library_bitcode_size;
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace codegen {
+
+namespace {
+
+inline llvm::StringRef bitcode()
+{
+    return llvm::StringRef(reinterpret_cast<const char*>(openvdb_ax_standard_library_bitcode),
+        openvdb_ax_standard_library_bitcode_size);
+}
+
+}
+
+bool hasStandardLibrary()
+{
+    return openvdb_ax_standard_library_bitcode_size != 0;
+}
+
+size_t linkStandardLibrary(llvm::Module& module)
+{
+    if (!hasStandardLibrary()) return 0;
+
+    std::set<std::string> declarations;
+    for (const llvm::Function& function : module) {
+        if (!function.isDeclaration() || function.isIntrinsic()) continue;
+        declarations.insert(function.getName().str());
+    }
+
+    if (declarations.empty()) return 0;
+
+    // function bodies are only materialized if they are linked
+
+    llvm::Expected<std::unique_ptr<llvm::Module>> loaded =
+        llvm::getLazyBitcodeModule(llvm::MemoryBufferRef(bitcode(), "openvdb_ax_standard_library"),
+            module.getContext());
+    if (!loaded) {
+        OPENVDB_THROW(LLVMModuleError, "Unable to load the standard function library: " +
+            llvm::toString(loaded.takeError()));
+    }
+
+    std::unique_ptr<llvm::Module> library = std::move(*loaded);
+    library->setTargetTriple(module.getTargetTriple());
+    library->setDataLayout(module.getDataLayout());
+
+    std::vector<std::string> linked;
+
+    for (llvm::Function& function : *library) {
+        // clang prefixes the names of functions given asm labels with \1
+        const std::string name = function.getName().str();
+        if (!name.empty() && name[0] == '\1') function.setName(name.substr(1));
+
+        // compile for the target of the module rather than that of the build
+        function.removeFnAttr("target-cpu");
+        function.removeFnAttr("target-features");
+
+        if (!function.isDeclaration() &&
+            declarations.count(function.getName().str())) {
+            linked.emplace_back(function.getName().str());
+        }
+    }
+
+    if (linked.empty()) return 0;
+
+    if (llvm::Linker::linkModules(module, std::move(library),
+            llvm::Linker::Flags::LinkOnlyNeeded)) {
+        OPENVDB_THROW(LLVMModuleError, "Failed to link the standard function library.");
+    }
+
+    size_t count = 0;
+    for (const std::string& name : linked) {
+        llvm::Function* function = module.getFunction(name);
+        if (!function || function->isDeclaration()) continue;
+        function->setLinkage(llvm::GlobalValue::InternalLinkage);
+        ++count;
+    }
+
+    return count;
+}
+
+const std::string& standardLibraryIdentifier()
+{
+    // std::hash is not guaranteed to be stable across processes, so the bitcode is
+    // hashed with the FNV-1a used for syntax trees, seeded with its offset basis
+    static const std::string identifier =
+        std::to_string(ast::hashCombine(14695981039346656037ULL, bitcode().str()));
+    return identifier;
+}
+
+}
+}
+}
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
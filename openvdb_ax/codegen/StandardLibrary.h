@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file codegen/StandardLibrary.h
+///
+/// @brief  Access to the standard function library, which is compiled to LLVM bitcode
+///         at build time from codegen/bitcode/StandardLibrary.cc and embedded into the
+///         library. Linking its definitions into generated modules allows the optimiser
+///         to inline and vectorise calls to the external functions it defines, rather
+///         than calling their host function pointers.
+///
+
+#ifndef OPENVDB_AX_CODEGEN_STANDARD_LIBRARY_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_CODEGEN_STANDARD_LIBRARY_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <string>
+
+// forward
+namespace llvm {
+class Module;
+}
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+namespace codegen {
+
+/// @brief  Returns true if the standard library was compiled to bitcode and embedded
+///         when openvdb_ax was built. Builds without a clang executable embed an empty
+///         library, in which case nothing is linked and external functions are always
+///         called through their function pointers.
+bool hasStandardLibrary();
+
+/// @brief  Links the definitions of all functions which are declared by a module and
+///         defined by the standard library into that module. Linked functions are given
+///         internal linkage. The module's target should be set before linking.
+/// @returns The number of functions linked. Always zero if no standard library is
+///          embedded (see hasStandardLibrary)
+size_t linkStandardLibrary(llvm::Module& module);
+
+/// @brief  Returns an identifier of the contents of the embedded standard library, for
+///         keying compiled code which may include its definitions
+const std::string& standardLibraryIdentifier();
+
+}
+}
+}
+}
+
+#endif // OPENVDB_AX_CODEGEN_STANDARD_LIBRARY_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -93,6 +93,57 @@ getGlobalAttributeAccess(const std::string& name, const std::string& type)
     return type + "@" + name;
 }
 
+/// @brief  Parse a global variable name to figure out if it is a group access index.
+///         Returns true if it is a valid access and sets name to the group name.
+///
+/// @param  global  The global token name
+/// @param  name    The name to set if the token is a valid group access
+///
+inline bool
+isGlobalGroupAccess(const std::string& global, std::string& name)
+{
+    if (global.compare(0, 6, "group:") != 0) return false;
+    name = global.substr(6);
+    return true;
+}
+
+/// @brief  Returns a global token name representing a valid access to the group of
+///         a given name.
+///
+/// @param  name    The group name
+///
+inline std::string
+getGlobalGroupAccess(const std::string& name)
+{
+    return "group:" + name;
+}
+
+/// @brief  Parse a global variable name to figure out if it is the metadata index of a
+///         string literal compared against string attributes. Returns true if it is a
+///         valid access and sets string to the literal.
+///
+/// @param  global  The global token name
+/// @param  string  The literal to set if the token is a valid string access
+///
+inline bool
+isGlobalStringAccess(const std::string& global, std::string& string)
+{
+    if (global.compare(0, 7, "string:") != 0) return false;
+    string = global.substr(7);
+    return true;
+}
+
+/// @brief  Returns a global token name representing the metadata index of a given
+///         string literal.
+///
+/// @param  string  The string literal
+///
+inline std::string
+getGlobalStringAccess(const std::string& string)
+{
+    return "string:" + string;
+}
+
 /// Recursive llvm type mapping from pod types
 /// @note  llvm::Types do not store information about the value sign, only meta
 ///        information about the primitive type (i.e. float, int, pointer) and
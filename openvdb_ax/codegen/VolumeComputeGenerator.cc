@@ -50,6 +50,12 @@ namespace codegen {
 const std::string ComputeVolumeFunction::DefaultName = "compute_volume";
 
 const std::array<std::string, ComputeVolumeFunction::N_ARGS> ComputeVolumeFunction::ArgumentKeys =
+{
+    "kernel_context"
+};
+
+const std::array<std::string, ComputeVolumeFunction::Context::N_MEMBERS>
+ComputeVolumeFunction::Context::Keys =
 {
     "custom_data",
     "coord_is",
@@ -58,16 +64,32 @@ const std::array<std::string, ComputeVolumeFunction::N_ARGS> ComputeVolumeFuncti
     "transforms"
 };
 
+llvm::StructType* ComputeVolumeFunction::Context::llvmType(llvm::LLVMContext& C)
+{
+    llvm::Type* members[] = {
+        LLVMType<const void*>::get(C),
+        LLVMType<int32_t[3]>::get(C),
+        LLVMType<float[3]>::get(C),
+        LLVMType<void**>::get(C),
+        LLVMType<void**>::get(C)
+    };
+    static_assert(sizeof(members) / sizeof(llvm::Type*) == N_MEMBERS,
+        "Mismatching volume kernel context members.");
+    return llvm::StructType::get(C, members);
+}
+
 VolumeComputeGenerator::VolumeComputeGenerator(llvm::Module& module,
                                                CustomData* const customData,
                                                const FunctionOptions& options,
                                                FunctionRegistry& functionRegistry,
                                                std::vector<std::string>* const warnings,
-                                               const std::string& functionName)
+                                               const std::string& functionName,
+                                               const bool activeWrites)
     : ComputeGenerator(module, customData, options, functionRegistry, warnings)
     , mLLVMArguments()
     , mVolumeVisitCount(0)
-    , mFunctionName(functionName) {}
+    , mFunctionName(functionName)
+    , mSetVoxelFunction(activeWrites ? "setactivevoxel" : "setvoxel") {}
 
 void VolumeComputeGenerator::init(const ast::Tree&)
 {
@@ -113,10 +135,36 @@ void VolumeComputeGenerator::init(const ast::Tree&)
         }
     }
 
+    // the context is only read by the generated function and is not accessible
+    // through any other argument
+
+    computeVolume->addParamAttr(0, llvm::Attribute::NoAlias);
+    computeVolume->addParamAttr(0, llvm::Attribute::NoCapture);
+    computeVolume->addParamAttr(0, llvm::Attribute::ReadOnly);
+
     mBlocks.push(llvm::BasicBlock::Create(mContext, "__entry_compute_volume", computeVolume));
     mBuilder.SetInsertPoint(mBlocks.top());
     mCurrentBlock = 1;
 
+    // Bind the members of the kernel context. The coordinates are arrays which are
+    // accessed through their address, the other members are loaded
+
+    llvm::StructType* contextType = ComputeVolumeFunction::Context::llvmType(mContext);
+    llvm::Value* context = mBuilder.CreateBitCast(mLLVMArguments.get("kernel_context"),
+        contextType->getPointerTo());
+
+    for (size_t i = 0; i < ComputeVolumeFunction::Context::N_MEMBERS; ++i) {
+        const std::string& key = ComputeVolumeFunction::Context::Keys[i];
+        llvm::Value* member = mBuilder.CreateStructGEP(contextType, context, i);
+        if (!contextType->getElementType(i)->isArrayTy()) {
+            member = mBuilder.CreateLoad(member, key);
+        }
+        if (!mLLVMArguments.insert(key, member)) {
+            OPENVDB_THROW(LLVMFunctionError, "Function \"" + mFunctionName
+                + "\" has been setup with non-unique argument keys.");
+        }
+    }
+
     // Set the base code generator function to the compute point function
 
     mFunction = computeVolume;
@@ -240,7 +288,7 @@ void VolumeComputeGenerator::visit(const ast::AssignExpression& node)
         accessorPtr, mLLVMArguments.get("coord_is"), rhs
     };
 
-    const FunctionBase::Ptr function = this->getFunction("setvoxel", mOptions, true);
+    const FunctionBase::Ptr function = this->getFunction(mSetVoxelFunction, mOptions, true);
     function->execute(argumentValues, mLLVMArguments.map(), mBuilder, mModule);
 }
 
@@ -293,7 +341,7 @@ void VolumeComputeGenerator::visit(const ast::Crement& node)
         lhs, mLLVMArguments.get("coord_is"), rhs
     };
 
-    const FunctionBase::Ptr function = this->getFunction("setvoxel", mOptions, true);
+    const FunctionBase::Ptr function = this->getFunction(mSetVoxelFunction, mOptions, true);
     function->execute(argumentValues, mLLVMArguments.map(), mBuilder, mModule);
 
     // decide what to put on the expression stack
@@ -319,12 +367,16 @@ void VolumeComputeGenerator::visit(const ast::FunctionCall& node)
     const FunctionBase::Ptr function = this->getFunction(node.mFunction, mOptions, /*no internal access*/false);
     assert(function);
 
-    if (function->context() & FunctionBase::Base) {
-        ComputeGenerator::visit(node);
-        return;
-    }
+    // prefer the volume context where available so that any custom data is accessed
+    // through the kernel arguments rather than a baked address, keeping the
+    // compiled object relocatable (required for object caching)
 
     if (!(function->context() & FunctionBase::Volume)) {
+        if (function->context() & FunctionBase::Base) {
+            ComputeGenerator::visit(node);
+            return;
+        }
+
         OPENVDB_THROW(LLVMContextError, "\"" + node.mFunction +
             "\" called within an invalid context");
     }
@@ -85,14 +85,19 @@ struct TypedAccessor : public Accessors
 ///
 ///         The argument structure is as follows:
 ///
+///             1) - A void pointer to the Context of the current voxel
+///
+///         The Context holds the bindings of a voxel, which are loaded by the
+///         generated function:
+///
 ///             1) - A void pointer to the CustomData
-///             2) - An pointer to an array of three ints representing the
-///                  current voxel coord being accessed
-///             3) - An pointer to an array of three floats representing the
-///                  current voxel world space coord being accessed
+///             2) - An array of three ints representing the current voxel coord
+///                  being accessed
+///             3) - An array of three floats representing the current voxel world
+///                  space coord being accessed
 ///             4) - A void pointer to a vector of void pointers, representing an array
 ///                  of grid accessors
-///             4) - A void pointer to a vector of void pointers, representing an array
+///             5) - A void pointer to a vector of void pointers, representing an array
 ///                  of grid transforms
 ///
 struct ComputeVolumeFunction
@@ -102,12 +107,7 @@ struct ComputeVolumeFunction
 
     /// The signature of the generated function
     using Signature =
-        void(const void* const,
-             const int32_t (*)[3],
-             const float (*)[3],
-             void**,
-             void**
-            );
+        void(const void* const);
 
     using SignaturePtr = std::add_pointer<Signature>::type;
     using FunctionT = std::function<Signature>;
@@ -119,33 +119,65 @@ struct ComputeVolumeFunction
     /// The argument key names available during code generation
     static const std::array<std::string, N_ARGS> ArgumentKeys;
 
+    /// @brief  The bindings of a voxel, passed to the generated function by pointer.
+    ///         The layout must match that of llvmType(). The coordinates are accessed
+    ///         in place, the other members are loaded.
+    ///
+    struct Context
+    {
+        const void* mCustomData;
+        int32_t mCoord[3];
+        float mCoordWS[3];
+        void** mAccessors;
+        void** mTransforms;
+
+        /// The number of members of the context
+        static const size_t N_MEMBERS = 5;
+
+        /// The key names of each member available during code generation
+        static const std::array<std::string, N_MEMBERS> Keys;
+
+        /// @brief  Returns the llvm type of the context
+        static llvm::StructType* llvmType(llvm::LLVMContext& C);
+    };
+
+    static_assert(std::is_standard_layout<Context>::value,
+        "The volume kernel context must be a standard layout type.");
+
     /// The arguments of the generated function
     struct Arguments
     {
         Arguments(const CustomData& customData)
-            : mCustomDataPtr(&customData)
-            , mCoord()
-            , mCoordWS()
+            : mContext()
             , mVoidAccessors()
             , mAccessors()
-            , mVoidTransforms() {}
+            , mVoidTransforms()
+        {
+            mContext.mCustomData = &customData;
+        }
 
-        /// @brief  Given a built version of the function signature, automatically
-        ///         bind the current arguments and return a callable function
-        ///         which takes no arguments
+        /// @brief  Sets the voxel to execute
+        inline void
+        setCoord(const openvdb::Coord& coord, const openvdb::Vec3d& coordWS)
+        {
+            for (int i = 0; i < 3; ++i) {
+                mContext.mCoord[i] = coord[i];
+                mContext.mCoordWS[i] = static_cast<float>(coordWS[i]);
+            }
+        }
+
+        /// @brief  Calls a built version of the function signature with the current
+        ///         arguments
         ///
         /// @param  function  The fully generated function built from the
         ///                   VolumeComputeGenerator
         ///
-        inline std::function<ReturnT()>
-        bind(Signature function)
+        inline void
+        call(SignaturePtr function)
         {
-            return std::bind(function,
-                static_cast<FunctionTraitsT::Arg<0>::Type>(mCustomDataPtr),
-                reinterpret_cast<FunctionTraitsT::Arg<1>::Type>(mCoord.data()),
-                reinterpret_cast<FunctionTraitsT::Arg<2>::Type>(mCoordWS.asV()),
-                static_cast<FunctionTraitsT::Arg<3>::Type>(mVoidAccessors.data()),
-                static_cast<FunctionTraitsT::Arg<4>::Type>(mVoidTransforms.data()));
+            mContext.mAccessors = mVoidAccessors.data();
+            mContext.mTransforms = mVoidTransforms.data();
+            function(&mContext);
         }
 
         template <typename TreeT>
@@ -172,11 +204,8 @@ struct ComputeVolumeFunction
             mVoidTransforms.emplace_back(static_cast<void*>(transform.get()));
         }
 
-        const CustomData* const mCustomDataPtr;
-        openvdb::Coord mCoord;
-        openvdb::math::Vec3<float> mCoordWS;
-
     private:
+        Context mContext;
         std::vector<void*> mVoidAccessors;
         std::vector<Accessors::Ptr> mAccessors;
         std::vector<void*> mVoidTransforms;
@@ -201,12 +230,16 @@ struct VolumeComputeGenerator : public ComputeGenerator
     /// @param warnings         Vector which will hold compiler warnings.  If null, no warnings will
     ///                         be stored.
     /// @param functionName     Name of the generated IR function
+    /// @param activeWrites     Whether to only write to voxels which are active in the written
+    ///                         volume. Required when the function is executed over voxels which
+    ///                         may not be active in every volume it writes to.
     VolumeComputeGenerator(llvm::Module& module,
                            CustomData* const customData,
                            const FunctionOptions& options,
                            FunctionRegistry& functionRegistry,
                            std::vector<std::string>* const warnings = nullptr,
-                           const std::string& functionName = ComputeVolumeFunction::DefaultName);
+                           const std::string& functionName = ComputeVolumeFunction::DefaultName,
+                           const bool activeWrites = false);
 
     ~VolumeComputeGenerator() override = default;
 
@@ -235,6 +268,8 @@ private:
     // code path
     size_t mVolumeVisitCount;
     std::string mFunctionName;
+    // The internal function used to write to volumes, see activeWrites
+    std::string mSetVoxelFunction;
 };
 
 }
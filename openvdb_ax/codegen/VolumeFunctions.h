@@ -188,6 +188,57 @@ private:
 
 };
 
+struct SetActiveVoxel : public FunctionBase
+{
+    DEFINE_IDENTIFIER_CONTEXT_DOC("setactivevoxel", FunctionBase::Volume,
+        "Internal function for setting the value of a voxel if it is active. Used by "
+        "single pass volume kernels, which visit the union of the active topology of "
+        "every written volume.")
+
+    inline static Ptr create(const FunctionOptions&) { return Ptr(new SetActiveVoxel()); }
+
+    SetActiveVoxel() : FunctionBase({
+        // pod types pass by value
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<double>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<float>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<int64_t>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<int32_t>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<int16_t>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel<bool>),
+        // non-pod types pass by ptr
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel_ptr<openvdb::Vec3d>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel_ptr<openvdb::Vec3f>),
+        DECLARE_FUNCTION_SIGNATURE(set_active_voxel_ptr<openvdb::Vec3i>)
+    }) {}
+
+private:
+    template <typename ValueT>
+    inline static void set_active_voxel_ptr(void* accessor, const int32_t (*coord)[3], const ValueT* value)
+    {
+        using GridType = typename openvdb::BoolGrid::ValueConverter<ValueT>::Type;
+        using AccessorType = typename GridType::Accessor;
+
+        assert(accessor);
+        assert(coord);
+
+        AccessorType* const accessorPtr = static_cast<AccessorType* const>(accessor);
+
+        // only the active voxels of existing leaf nodes are written, as they are by a
+        // kernel which visits the leaves of this volume. This never modifies topology, so
+        // is safe to run concurrently
+        const openvdb::Coord ijk(coord[0]);
+        auto* const leaf = accessorPtr->probeLeaf(ijk);
+        if (leaf && leaf->isValueOn(ijk)) leaf->setValueOnly(ijk, *value);
+    }
+
+    template <typename ValueT>
+    inline static void set_active_voxel(void* accessor, const int32_t (*coord)[3], const ValueT value)
+    {
+        set_active_voxel_ptr<ValueT>(accessor, coord, &value);
+    }
+
+};
+
 struct GetVoxel : public FunctionBase
 {
     DEFINE_IDENTIFIER_CONTEXT_DOC("getvoxel", FunctionBase::Volume,
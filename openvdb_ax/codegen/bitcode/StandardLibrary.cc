@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file codegen/bitcode/StandardLibrary.cc
+///
+/// @brief  Definitions of the external functions of the standard function registry
+///         (codegen/Functions.h) which are compiled to LLVM bitcode at build time and
+///         embedded into the library. See codegen/StandardLibrary.h.
+///
+/// @note   This file is not compiled into the library directly and must not depend on
+///         anything other than the C++ standard library. Each function is given the
+///         symbol of the registry function signature it implements with an asm label,
+///         and must match the behaviour of that function exactly.
+///
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#define AX_LIBRARY_FUNCTION(Return, Name, Symbol, ...) \
+    extern "C" Return Name(__VA_ARGS__) __asm__(Symbol); \
+    extern "C" Return Name(__VA_ARGS__)
+
+namespace {
+
+template <typename T>
+inline T lensq(const T (*in)[3])
+{
+    return (*in)[0] * (*in)[0] + (*in)[1] * (*in)[1] + (*in)[2] * (*in)[2];
+}
+
+// matches openvdb::math::Vec3<T>::length()
+
+template <typename T>
+inline T length(const T (*in)[3])
+{
+    return static_cast<T>(std::sqrt(double(lensq(in))));
+}
+
+// matches openvdb::math::Vec3<T>::normalize(), which leaves vectors with a length
+// approximately equal to zero unchanged
+
+template <typename T>
+inline void normalize(const T (*in)[3], T (*out)[3])
+{
+    const T (&v)[3] = *in;
+    const T d = length(in);
+    if (!(std::abs(d) > T(1.0e-7))) {
+        for (int i = 0; i < 3; ++i) (*out)[i] = v[i];
+        return;
+    }
+    const T inv = T(1) / d;
+    for (int i = 0; i < 3; ++i) (*out)[i] = v[i] * inv;
+}
+
+template <typename T>
+inline T dot(const T (*in1)[3], const T (*in2)[3])
+{
+    return (*in1)[0] * (*in2)[0] + (*in1)[1] * (*in2)[1] + (*in1)[2] * (*in2)[2];
+}
+
+template <typename T>
+inline void cross(const T (*in1)[3], const T (*in2)[3], T (*out)[3])
+{
+    const T (&a)[3] = *in1;
+    const T (&b)[3] = *in2;
+    const T x = a[1] * b[2] - a[2] * b[1];
+    const T y = a[2] * b[0] - a[0] * b[2];
+    const T z = a[0] * b[1] - a[1] * b[0];
+    (*out)[0] = x;
+    (*out)[1] = y;
+    (*out)[2] = z;
+}
+
+// matches openvdb::math::Clamp
+
+template <typename T>
+inline T clamp(T x, T min, T max)
+{
+    return x > min ? x < max ? x : max : min;
+}
+
+template <typename T>
+inline T min(T a, T b) { return (b < a) ? b : a; }
+
+template <typename T>
+inline T max(T a, T b) { return (a < b) ? b : a; }
+
+}
+
+AX_LIBRARY_FUNCTION(double, ax_lensqd, "LengthSq::lensq<double>", double (*in)[3]) { return lensq(in); }
+AX_LIBRARY_FUNCTION(float, ax_lensqf, "LengthSq::lensq<float>", float (*in)[3]) { return lensq(in); }
+AX_LIBRARY_FUNCTION(int32_t, ax_lensqi, "LengthSq::lensq<int32_t>", int32_t (*in)[3]) { return lensq(in); }
+
+AX_LIBRARY_FUNCTION(double, ax_lengthd, "Length::length<double>", double (*in)[3]) { return length(in); }
+AX_LIBRARY_FUNCTION(float, ax_lengthf, "Length::length<float>", float (*in)[3]) { return length(in); }
+
+AX_LIBRARY_FUNCTION(void, ax_normalized, "normalize<double>", double (*in)[3], double (*out)[3]) { normalize(in, out); }
+AX_LIBRARY_FUNCTION(void, ax_normalizef, "normalize<float>", float (*in)[3], float (*out)[3]) { normalize(in, out); }
+
+AX_LIBRARY_FUNCTION(double, ax_dotd, "dot<double>", double (*in1)[3], double (*in2)[3]) { return dot(in1, in2); }
+AX_LIBRARY_FUNCTION(float, ax_dotf, "dot<float>", float (*in1)[3], float (*in2)[3]) { return dot(in1, in2); }
+AX_LIBRARY_FUNCTION(int32_t, ax_doti, "dot<int32_t>", int32_t (*in1)[3], int32_t (*in2)[3]) { return dot(in1, in2); }
+
+AX_LIBRARY_FUNCTION(void, ax_crossd, "cross<double>", double (*in1)[3], double (*in2)[3], double (*out)[3]) { cross(in1, in2, out); }
+AX_LIBRARY_FUNCTION(void, ax_crossf, "cross<float>", float (*in1)[3], float (*in2)[3], float (*out)[3]) { cross(in1, in2, out); }
+AX_LIBRARY_FUNCTION(void, ax_crossi, "cross<int32_t>", int32_t (*in1)[3], int32_t (*in2)[3], int32_t (*out)[3]) { cross(in1, in2, out); }
+
+AX_LIBRARY_FUNCTION(double, ax_clampd, "openvdb::math::Clamp<double>", double x, double a, double b) { return clamp(x, a, b); }
+AX_LIBRARY_FUNCTION(float, ax_clampf, "openvdb::math::Clamp<float>", float x, float a, float b) { return clamp(x, a, b); }
+AX_LIBRARY_FUNCTION(int32_t, ax_clampi, "openvdb::math::Clamp<int32_t>", int32_t x, int32_t a, int32_t b) { return clamp(x, a, b); }
+
+AX_LIBRARY_FUNCTION(double, ax_mind, "Min::min<double>", double a, double b) { return min(a, b); }
+AX_LIBRARY_FUNCTION(float, ax_minf, "Min::min<float>", float a, float b) { return min(a, b); }
+AX_LIBRARY_FUNCTION(int32_t, ax_mini, "Min::min<int32_t>", int32_t a, int32_t b) { return min(a, b); }
+
+AX_LIBRARY_FUNCTION(double, ax_maxd, "Max::max<double>", double a, double b) { return max(a, b); }
+AX_LIBRARY_FUNCTION(float, ax_maxf, "Max::max<float>", float a, float b) { return max(a, b); }
+AX_LIBRARY_FUNCTION(int32_t, ax_maxi, "Max::max<int32_t>", int32_t a, int32_t b) { return max(a, b); }
+
+AX_LIBRARY_FUNCTION(int32_t, ax_absi, "absi", int32_t x) { return std::abs(x); }
+AX_LIBRARY_FUNCTION(long, ax_absl, "absl", long x) { return std::abs(x); }
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file compiler/CompileReport.h
+///
+/// @brief  Timings and statistics of a single compilation, optionally populated by
+///         Compiler::compile
+///
+
+#ifndef OPENVDB_AX_COMPILER_COMPILE_REPORT_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_COMPILER_COMPILE_REPORT_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <cstddef>
+#include <ostream>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+/// @brief  A breakdown of where time was spent compiling a program and what was produced.
+///         All times are wall times in seconds.
+/// @note   Volume programs usually compile their blocks on first execution. When a report
+///         is requested, all blocks are compiled by Compiler::compile so that the report
+///         is complete.
+struct CompileReport
+{
+    /// @brief  Time spent parsing the code. Only populated when compiling from a string
+    double mParseTime = 0.0;
+    /// @brief  Time spent generating IR from the syntax tree
+    double mCodeGenerationTime = 0.0;
+    /// @brief  Time spent verifying and optimising the IR
+    double mOptimisationTime = 0.0;
+    /// @brief  Time spent generating, loading and finalizing machine code
+    double mMachineCodeTime = 0.0;
+
+    /// @brief  The number of IR instructions generated
+    size_t mInstructionsBeforeOptimisation = 0;
+    /// @brief  The number of IR instructions remaining after optimisation. Zero if all
+    ///         objects were loaded from an object cache
+    size_t mInstructionsAfterOptimisation = 0;
+    /// @brief  The number of bytes of code and data allocated by the JIT
+    size_t mMachineCodeBytes = 0;
+    /// @brief  The number of registry functions declared or defined in the generated IR
+    size_t mFunctionsInstantiated = 0;
+
+    /// @brief  True if an existing executable was returned from an executable cache, in
+    ///         which case no other statistics are populated
+    bool mExecutableCacheHit = false;
+    /// @brief  True if all compiled objects were loaded from an object cache
+    bool mObjectCacheHit = false;
+
+    /// @brief  Returns the total time spent compiling
+    inline double totalTime() const
+    {
+        return mParseTime + mCodeGenerationTime + mOptimisationTime + mMachineCodeTime;
+    }
+
+    /// @brief  Prints the report in a human readable form
+    inline void print(std::ostream& os) const
+    {
+        const double ms = 1000.0;
+        os << "Compile report:\n";
+        if (mExecutableCacheHit) {
+            os << "  executable cache hit\n";
+        }
+        os << "  parse            : " << mParseTime * ms << " ms\n"
+           << "  code generation  : " << mCodeGenerationTime * ms << " ms\n"
+           << "  optimisation     : " << mOptimisationTime * ms << " ms\n"
+           << "  machine code     : " << mMachineCodeTime * ms << " ms"
+           << (mObjectCacheHit ? " (object cache hit)" : "") << "\n"
+           << "  total            : " << totalTime() * ms << " ms\n"
+           << "  IR instructions  : " << mInstructionsBeforeOptimisation << " -> "
+           << mInstructionsAfterOptimisation << "\n"
+           << "  functions        : " << mFunctionsInstantiated << "\n"
+           << "  machine code     : " << mMachineCodeBytes << " bytes" << std::endl;
+    }
+};
+
+}
+}
+}
+
+#endif // OPENVDB_AX_COMPILER_COMPILE_REPORT_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
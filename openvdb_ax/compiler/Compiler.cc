@@ -30,12 +30,16 @@
 
 #include "Compiler.h"
 
+#include "ExecutableCache.h"
+#include "ObjectCache.h"
 #include "PointExecutable.h"
 #include "VolumeExecutable.h"
 
+#include <openvdb_ax/ast/Hash.h>
 #include <openvdb_ax/ast/Scanners.h>
 #include <openvdb_ax/codegen/FunctionRegistry.h>
 #include <openvdb_ax/codegen/PointComputeGenerator.h>
+#include <openvdb_ax/codegen/StandardLibrary.h>
 #include <openvdb_ax/codegen/VolumeComputeGenerator.h>
 #include <openvdb_ax/Exceptions.h>
 
@@ -44,11 +48,14 @@
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h> // LLVM_VERSION_STRING
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/InitializePasses.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/ManagedStatic.h> // llvm_shutdown
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/raw_os_ostream.h>
@@ -73,6 +80,12 @@
 #include <llvm/IR/Module.h>
 
 #include <tbb/mutex.h>
+#include <tbb/task_group.h>
+
+#include <algorithm> // std::find, std::sort
+#include <atomic>
+#include <chrono>
+#include <sstream>
 
 
 namespace openvdb {
@@ -224,10 +237,12 @@ void addOptimizationPasses(llvm::legacy::PassManagerBase& passes,
 void LLVMoptimise(llvm::Module* module,
                   const unsigned optLevel,
                   const unsigned sizeLevel,
-                  const bool verify = false)
+                  const bool verify = false,
+                  llvm::TargetMachine* targetMachine = nullptr)
 {
-    // Pass manager setup and IR optimisations - Do target independent optimisations
-    // only - i.e. the following do not require an llvm TargetMachine analysis pass
+    // Pass manager setup and IR optimisations. If a target machine is provided, its
+    // cost model is made available to the vectorizers and other target aware passes,
+    // otherwise only target independent optimisations are performed
 
     llvm::legacy::PassManager passes;
     const llvm::Triple moduleTriple(module->getTargetTriple());
@@ -235,15 +250,17 @@ void LLVMoptimise(llvm::Module* module,
     passes.add(new llvm::TargetLibraryInfoWrapperPass(tlii));
 
     // Add internal analysis passes from the target machine.
-    passes.add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
+    const llvm::TargetIRAnalysis analysis = targetMachine ?
+        targetMachine->getTargetIRAnalysis() : llvm::TargetIRAnalysis();
+    passes.add(llvm::createTargetTransformInfoWrapperPass(analysis));
 
     llvm::legacy::FunctionPassManager functionPasses(module);
-    functionPasses.add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
+    functionPasses.add(llvm::createTargetTransformInfoWrapperPass(analysis));
 
     if (verify) functionPasses.add(llvm::createVerifierPass());
 
     addStandardLinkPasses(passes);
-    addOptimizationPasses(passes, functionPasses, nullptr, optLevel, sizeLevel);
+    addOptimizationPasses(passes, functionPasses, targetMachine, optLevel, sizeLevel);
 
     functionPasses.doInitialization();
     for (llvm::Function& function : *module) {
@@ -283,9 +300,10 @@ void initializeGlobalFunctions(const codegen::FunctionRegistry& registry,
             void* functionPtr = signature->functionPointer();
             if (!functionPtr) continue;
 
-            // llvmFunction may not exists if compiled without mLazyFunctions
+            // llvmFunction may not exists if compiled without mLazyFunctions, and does not
+            // need mapping if its definition was linked from the standard library
             const llvm::Function* llvmFunction = module.getFunction(signature->symbolName());
-            if (!llvmFunction) continue;
+            if (!llvmFunction || !llvmFunction->isDeclaration()) continue;
 
             // error if updateGlobalMapping returned a previously mapped address, as we've
             // overwritten something
@@ -299,7 +317,10 @@ void initializeGlobalFunctions(const codegen::FunctionRegistry& registry,
     }
 }
 
-void optimiseAndVerify(llvm::Module* module, const bool verify, const CompilerOptions::OptLevel optLevel)
+void optimiseAndVerify(llvm::Module* module,
+                       const bool verify,
+                       const CompilerOptions::OptLevel optLevel,
+                       llvm::TargetMachine* targetMachine = nullptr)
 {
     if (verify) {
         llvm::raw_os_ostream out(std::cout);
@@ -310,27 +331,27 @@ void optimiseAndVerify(llvm::Module* module, const bool verify, const CompilerOp
 
     switch (optLevel) {
         case CompilerOptions::OptLevel::O0 : {
-            LLVMoptimise(module, 0, 0, verify);
+            LLVMoptimise(module, 0, 0, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::O1 : {
-            LLVMoptimise(module, 1, 0, verify);
+            LLVMoptimise(module, 1, 0, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::O2 : {
-            LLVMoptimise(module, 2, 0, verify);
+            LLVMoptimise(module, 2, 0, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::Os : {
-            LLVMoptimise(module, 2, 1, verify);
+            LLVMoptimise(module, 2, 1, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::Oz : {
-            LLVMoptimise(module, 2, 2, verify);
+            LLVMoptimise(module, 2, 2, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::O3 : {
-            LLVMoptimise(module, 3, 0, verify);
+            LLVMoptimise(module, 3, 0, verify, targetMachine);
             break;
         }
         case CompilerOptions::OptLevel::NONE :
@@ -338,9 +359,316 @@ void optimiseAndVerify(llvm::Module* module, const bool verify, const CompilerOp
     }
 }
 
+/// @brief  Returns the wall time in seconds elapsed since a given time point
+inline double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/// @brief  Returns the number of IR instructions in a module
+size_t instructionCount(const llvm::Module& module)
+{
+    size_t count = 0;
+    for (const llvm::Function& function : module) {
+        for (const llvm::BasicBlock& block : function) {
+            count += block.size();
+        }
+    }
+    return count;
+}
+
+/// @brief  Returns the number of functions other than intrinsics and the given compute
+///         functions which are declared or defined in a module
+size_t instantiatedFunctionCount(const llvm::Module& module,
+                                 const std::vector<std::string>& computeFunctions)
+{
+    const std::set<std::string> exclude(computeFunctions.begin(), computeFunctions.end());
+
+    size_t count = 0;
+    for (const llvm::Function& function : module) {
+        if (function.isIntrinsic()) continue;
+        if (exclude.count(function.getName().str())) continue;
+        ++count;
+    }
+    return count;
+}
+
+/// @brief  Returns the machine code optimization level for a given compiler
+///         optimization level
+llvm::CodeGenOpt::Level codeGenOptLevel(const CompilerOptions::OptLevel optLevel)
+{
+    switch (optLevel) {
+        case CompilerOptions::OptLevel::NONE :
+        case CompilerOptions::OptLevel::O0 : return llvm::CodeGenOpt::None;
+        case CompilerOptions::OptLevel::O1 : return llvm::CodeGenOpt::Less;
+        case CompilerOptions::OptLevel::O3 : return llvm::CodeGenOpt::Aggressive;
+        case CompilerOptions::OptLevel::O2 :
+        case CompilerOptions::OptLevel::Os :
+        case CompilerOptions::OptLevel::Oz :
+        default : return llvm::CodeGenOpt::Default;
+    }
+}
+
+/// @brief  Returns the target features to use for the given compiler options. If no CPU
+///         is specified, the features of the host CPU are used. Any explicit features
+///         are appended, taking precedence.
+std::vector<std::string> targetFeatures(const CompilerOptions& options)
+{
+    std::vector<std::string> features;
+
+    if (options.cpu.empty()) {
+        llvm::StringMap<bool> hostFeatures;
+        if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            for (const auto& feature : hostFeatures) {
+                features.emplace_back((feature.second ? "+" : "-") + feature.first().str());
+            }
+            // sorted so the resolved features are stable for use in object cache keys
+            std::sort(features.begin(), features.end());
+        }
+    }
+
+    llvm::SmallVector<llvm::StringRef, 8> explicitFeatures;
+    llvm::StringRef(options.features).split(explicitFeatures, ',', -1, /*KeepEmpty*/false);
+    for (const llvm::StringRef& feature : explicitFeatures) {
+        features.emplace_back(feature.trim().str());
+    }
+
+    return features;
+}
+
+/// @brief  Returns the CPU to target for the given compiler options, defaulting to the
+///         host CPU
+std::string targetCPU(const CompilerOptions& options)
+{
+    return options.cpu.empty() ? llvm::sys::getHostCPUName().str() : options.cpu;
+}
+
+/// @brief  Creates a JIT target machine for the CPU and features of the compiler options,
+///         defaulting to the host CPU. The same target machine is used to optimise a
+///         module and to generate its machine code.
+std::unique_ptr<llvm::TargetMachine> createTargetMachine(const CompilerOptions& options)
+{
+    const std::string cpu = targetCPU(options);
+
+    llvm::SmallVector<std::string, 64> features;
+    for (const std::string& feature : targetFeatures(options)) features.push_back(feature);
+
+    std::string error;
+    llvm::EngineBuilder builder;
+    builder.setEngineKind(llvm::EngineKind::JIT)
+        .setErrorStr(&error)
+        .setOptLevel(codeGenOptLevel(options.optLevel));
+
+    std::unique_ptr<llvm::TargetMachine>
+        machine(builder.selectTarget(llvm::Triple(llvm::sys::getProcessTriple()),
+            "", cpu, features));
+
+    if (!machine) {
+        OPENVDB_THROW(LLVMTargetError, "Unable to create target machine for CPU \"" +
+            cpu + "\": " + error);
+    }
+
+    return machine;
+}
+
+/// @brief  Sets the target triple and data layout of a module from a target machine
+void setModuleTarget(llvm::Module& module, const llvm::TargetMachine& machine)
+{
+    module.setTargetTriple(machine.getTargetTriple().str());
+    module.setDataLayout(machine.createDataLayout());
+}
+
+/// @brief  Hashes all state which can change the code generated for a given syntax tree
+///         and executable type, independent of the host
+uint64_t compilationHash(const ast::Tree& tree,
+                         const std::string& executable,
+                         const CompilerOptions& options,
+                         const codegen::FunctionRegistry& registry)
+{
+    uint64_t hash = ast::hash(tree);
+    hash = ast::hashCombine(hash, executable);
+
+    // the kernel arguments and entry points, so that objects built for a different
+    // kernel signature are never loaded
+
+    if (executable == "point") {
+        for (const std::string& key : codegen::ComputePointFunction::ArgumentKeys) {
+            hash = ast::hashCombine(hash, key);
+        }
+        for (const std::string& key : codegen::ComputePointFunction::Context::Keys) {
+            hash = ast::hashCombine(hash, key);
+        }
+        std::vector<std::string> functions;
+        codegen::PointComputeGenerator::getFunctionList(functions);
+        for (const std::string& name : functions) {
+            hash = ast::hashCombine(hash, name);
+        }
+    }
+    else {
+        for (const std::string& key : codegen::ComputeVolumeFunction::ArgumentKeys) {
+            hash = ast::hashCombine(hash, key);
+        }
+        for (const std::string& key : codegen::ComputeVolumeFunction::Context::Keys) {
+            hash = ast::hashCombine(hash, key);
+        }
+    }
+
+    // compiler options
+
+    hash = ast::hashCombine(hash, std::to_string(static_cast<int>(options.optLevel)));
+    hash = ast::hashCombine(hash, std::to_string(options.verify));
+    hash = ast::hashCombine(hash, std::to_string(options.functionOptions.mPrioritiseFunctionIR));
+    hash = ast::hashCombine(hash, std::to_string(options.functionOptions.mLazyFunctions));
+    if (options.functionOptions.mStandardLibraryBitcode && codegen::hasStandardLibrary()) {
+        hash = ast::hashCombine(hash, codegen::standardLibraryIdentifier());
+    }
+    hash = ast::hashCombine(hash, options.cpu);
+    hash = ast::hashCombine(hash, options.features);
+    hash = ast::hashCombine(hash, std::to_string(options.singlePassVolumes));
+    hash = ast::hashCombine(hash, std::to_string(options.pointVectorWidth));
+
+    // registered functions. Note that with lazy functions the instantiated state of
+    // the registry changes during code generation so only the identifiers are used
+
+    for (const auto& iter : registry.map()) {
+        hash = ast::hashCombine(hash, iter.first);
+        hash = ast::hashCombine(hash, iter.second.isInternal() ? "1" : "0");
+    }
+
+    return hash;
+}
+
+/// @brief  The version of the code generated by openvdb_ax, mixed into every object
+///         cache key.
+/// @note   Bump this whenever a change alters generated code or the kernel ABI without
+///         changing the syntax tree, options or registry identifiers hashed by
+///         compilationHash (for example, a change to a code generator, a function
+///         implementation or the layout of a kernel argument). Objects written to an
+///         on-disk ObjectCache by an older build are otherwise loaded as-is.
+const int sCodeGenVersion = 1;
+
+/// @brief  Builds the key used to identify a compiled object in an ObjectCache from a
+///         compilation hash. The code generation version, host and llvm version are
+///         mixed into the key as objects may be shared between processes and builds.
+///         The CPU and feature set are those resolved by createTargetMachine, so hosts
+///         sharing a CPU name but differing in enabled features never share objects.
+/// @note   The key is used as the llvm module identifier and the cache file name
+std::string objectCacheKey(uint64_t hash,
+                           const std::string& executable,
+                           const CompilerOptions& options)
+{
+    hash = ast::hashCombine(hash, std::to_string(sCodeGenVersion));
+    hash = ast::hashCombine(hash, LLVM_VERSION_STRING);
+    hash = ast::hashCombine(hash, llvm::sys::getProcessTriple());
+    hash = ast::hashCombine(hash, targetCPU(options));
+    for (const std::string& feature : targetFeatures(options)) {
+        hash = ast::hashCombine(hash, feature);
+    }
+
+    std::stringstream ss;
+    ss << "ax_" << executable << "_" << std::hex << hash;
+    return ss.str();
+}
+
+/// @brief  Builds the key used to identify an executable in an ExecutableCache from a
+///         compilation hash. Executables reference the custom data they were compiled
+///         with, so its address is mixed into the key.
+/// @note   Function registries are identified by their function identifiers only.
+///         Compilers using different implementations of the same identifiers should
+///         not share an ExecutableCache.
+uint64_t executableCacheKey(const uint64_t hash, const CustomData* const data)
+{
+    std::stringstream ss;
+    ss << static_cast<const void*>(data);
+    return ast::hashCombine(hash, ss.str());
+}
+
+/// @brief  A section memory manager which records the number of bytes allocated by
+///         the JIT for code and data sections
+class CountingMemoryManager : public llvm::SectionMemoryManager
+{
+public:
+    CountingMemoryManager() : mBytes(0) {}
+    ~CountingMemoryManager() override = default;
+
+    uint8_t* allocateCodeSection(uintptr_t size, unsigned alignment,
+        unsigned sectionID, llvm::StringRef sectionName) override
+    {
+        mBytes += size;
+        return llvm::SectionMemoryManager::allocateCodeSection(size,
+            alignment, sectionID, sectionName);
+    }
+
+    uint8_t* allocateDataSection(uintptr_t size, unsigned alignment,
+        unsigned sectionID, llvm::StringRef sectionName, bool isReadOnly) override
+    {
+        mBytes += size;
+        return llvm::SectionMemoryManager::allocateDataSection(size,
+            alignment, sectionID, sectionName, isReadOnly);
+    }
+
+    inline size_t bytes() const { return mBytes; }
+
+private:
+    // atomic as code may be queried while another thread lazily compiles
+    std::atomic<size_t> mBytes;
+};
+
+/// @brief  The llvm::ObjectCache of a single execution engine. Objects are loaded from
+///         an ObjectCache into this cache before a module is compiled, which decides
+///         whether the module is optimised, and are then provided to the engine when it
+///         generates code for the module. As each compilation owns the objects it loads,
+///         they are released with the compilation, even if it throws, and never taken by
+///         concurrent compilations of the same program. Newly compiled objects are written
+///         into the ObjectCache.
+/// @note   Not thread safe. Modules of an engine are compiled one at a time.
+class EngineObjectCache : public llvm::ObjectCache
+{
+public:
+    EngineObjectCache(const std::shared_ptr<ObjectCache>& cache)
+        : mCache(cache), mObjects() {}
+    ~EngineObjectCache() override = default;
+
+    /// @brief  Loads the object for a module, returning true if it exists. If so, the
+    ///         module does not need to be optimised
+    bool load(const llvm::Module& module)
+    {
+        const std::string& key = module.getModuleIdentifier();
+        std::unique_ptr<llvm::MemoryBuffer> object = mCache->load(key);
+        if (!object) return false;
+        mObjects[key] = std::move(object);
+        return true;
+    }
+
+    void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override
+    {
+        mCache->notifyObjectCompiled(module, object);
+    }
+
+    /// @note  Only objects loaded by this compilation are returned. Modules which were
+    ///        not loaded have been optimised, so are compiled by the engine
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override
+    {
+        auto iter = mObjects.find(module->getModuleIdentifier());
+        if (iter == mObjects.end()) return nullptr;
+        std::unique_ptr<llvm::MemoryBuffer> object = std::move(iter->second);
+        mObjects.erase(iter);
+        return object;
+    }
+
+private:
+    const std::shared_ptr<ObjectCache> mCache;
+    std::map<std::string, std::unique_ptr<llvm::MemoryBuffer>> mObjects;
+};
+
+/// @brief  Registers the attribute accesses of one or more symbol tables of globals,
+///         assigning each global its index in the registry. Globals with the same
+///         token in different tables (i.e. different modules) are assigned the same index.
 template <typename RegistryT>
 inline typename RegistryT::Ptr
-registerAccesses(const codegen::SymbolTable& globals, const ast::Tree& tree)
+registerAccesses(const std::vector<const codegen::SymbolTable*>& globalTables,
+                 const ast::Tree& tree)
 {
     // get the attributes targets
 
@@ -357,41 +685,119 @@ registerAccesses(const codegen::SymbolTable& globals, const ast::Tree& tree)
     ast::visitNodeType<ast::AssignExpression>(tree, op);
 
     typename RegistryT::Ptr registry(new RegistryT);
+    std::map<std::string, size_t> indices;
 
     std::string name, type;
 
-    for (const auto& global : globals.map()) {
+    for (const codegen::SymbolTable* globals : globalTables) {
+        for (const auto& global : globals->map()) {
 
-        // detect if this global variable is an attribute access
+            // detect if this global variable is an attribute access
 
-        const std::string& token = global.first;
-        if (!codegen::isGlobalAttributeAccess(token, name, type)) continue;
+            const std::string& token = global.first;
+            if (codegen::isGlobalGroupAccess(token, name)) continue;
+            if (codegen::isGlobalStringAccess(token, name)) continue;
+            if (!codegen::isGlobalAttributeAccess(token, name, type)) continue;
 
-        // select whether we are writing to this attribute.
+            auto iter = indices.find(token);
+            if (iter == indices.end()) {
 
-        bool write = targets.count(name);
+                // select whether we are writing to this attribute.
 
-        // add the access to the registry - this will force the executables
-        // to always request or create the data type
+                bool write = targets.count(name);
 
-        const size_t index = registry->addData(name, type, write);
+                // add the access to the registry - this will force the executables
+                // to always request or create the data type
 
-        // should always be a GlobalVariable.
-        assert(llvm::isa<llvm::GlobalVariable>(global.second));
+                iter = indices.emplace(token, registry->addData(name, type, write)).first;
+            }
+
+            const size_t index = iter->second;
+
+            // should always be a GlobalVariable.
+            assert(llvm::isa<llvm::GlobalVariable>(global.second));
+
+            // Assign the attribute index global a valid index.
+            // @note executionEngine->addGlobalMapping() can also be used if the indices
+            // every need to vary positions without having to force a recompile (previously
+            // was used unnecessarily)
+
+            llvm::GlobalVariable* variable = llvm::cast<llvm::GlobalVariable>(global.second);
+            assert(variable->getValueType()->isIntegerTy(64));
+
+            variable->setInitializer(llvm::ConstantInt::get(variable->getValueType(), index));
+            variable->setConstant(true); // is not writen to at runtime
+        }
+    }
+
+    return registry;
+}
+
+template <typename RegistryT>
+inline typename RegistryT::Ptr
+registerAccesses(const codegen::SymbolTable& globals, const ast::Tree& tree)
+{
+    return registerAccesses<RegistryT>(std::vector<const codegen::SymbolTable*>{&globals}, tree);
+}
+
+/// @brief  Registers the groups which are named by string literals in a point program,
+///         assigning each the index of its bindings in the same way as attributes.
+///         Groups named by other strings are found at runtime, see
+///         AttributeRegistry::dynamicGroupWrites
+inline void
+registerGroupAccesses(AttributeRegistry& registry,
+                      const codegen::SymbolTable& globals,
+                      const ast::Tree& tree)
+{
+    std::set<std::string> targets;
+    bool dynamic = false;
+
+    ast::visitNodeType<ast::FunctionCall>(tree,
+        [&](const ast::FunctionCall& node) {
+            std::string name;
+            bool write;
+            if (!codegen::PointComputeGenerator::isGroupAccess(node, name, write)) return;
+            if (!write) return;
+            if (name.empty()) dynamic = true;
+            else              targets.insert(name);
+        });
+
+    registry.setDynamicGroupWrites(dynamic);
+
+    std::string name;
+    for (const auto& global : globals.map()) {
+        if (!codegen::isGlobalGroupAccess(global.first, name)) continue;
 
-        // Assign the attribute index global a valid index.
-        // @note executionEngine->addGlobalMapping() can also be used if the indices
-        // every need to vary positions without having to force a recompile (previously
-        // was used unnecessarily)
+        const int64_t index = registry.addGroup(name, targets.count(name));
 
+        assert(llvm::isa<llvm::GlobalVariable>(global.second));
         llvm::GlobalVariable* variable = llvm::cast<llvm::GlobalVariable>(global.second);
         assert(variable->getValueType()->isIntegerTy(64));
 
         variable->setInitializer(llvm::ConstantInt::get(variable->getValueType(), index));
         variable->setConstant(true); // is not writen to at runtime
     }
+}
 
-    return registry;
+/// @brief  Registers the string literals which a point program compares against string
+///         attributes. Each is resolved to a string attribute index on execution
+inline void
+registerStringAccesses(AttributeRegistry& registry,
+                       const codegen::SymbolTable& globals)
+{
+    std::string string;
+    for (const auto& global : globals.map()) {
+        if (!codegen::isGlobalStringAccess(global.first, string)) continue;
+
+        const int64_t index = registry.addString(string);
+
+        assert(llvm::isa<llvm::GlobalVariable>(global.second));
+        llvm::GlobalVariable* variable = llvm::cast<llvm::GlobalVariable>(global.second);
+        assert(variable->getValueType()->isIntegerTy(64));
+
+        variable->setInitializer(llvm::ConstantInt::get(variable->getValueType(), index));
+        variable->setConstant(true); // is not writen to at runtime
+    }
 }
 
 /// @brief Modifier class that "disables" attribute assignment statements inside of an AST.
@@ -475,21 +881,23 @@ private:
     bool mVolumeAssignmentFound;
 };
 
-/// @brief class that encapsulates blocks of code generated for volume code.
+/// @brief class that encapsulates blocks of code generated for volume code. Each block
+///        is generated into its own module so that blocks can be compiled independently.
 class VolumeCodeBlocks
 {
 public:
 
     VolumeCodeBlocks()
-        : mBlockFunctionNames()
-        , mBlockFunctionAddresses()
+        : mModules()
+        , mGlobals()
+        , mBlockFunctionNames()
         , mVolumesAssigned() {}
 
     ~VolumeCodeBlocks() = default;
 
     int numBlocks() const
     {
-        return mBlockFunctionNames.size();
+        return mVolumesAssigned.size();
     }
 
     void getVolumesAssigned(std::vector<std::string>& volumeNames) const
@@ -502,12 +910,19 @@ public:
     void
     compileBlocks(const ast::Tree& syntaxTree,
                   CustomData& customData,
-                  llvm::Module& module,
+                  llvm::LLVMContext& context,
+                  const std::string& moduleName,
                   const FunctionOptions& options,
-                  codegen::SymbolTable& globals,
                   codegen::FunctionRegistry& functionRegistry,
-                  std::vector<std::string>* warnings)
+                  std::vector<std::string>* warnings,
+                  const bool singlePass = false)
     {
+        if (singlePass) {
+            this->compileSinglePass(syntaxTree, customData, context, moduleName,
+                options, functionRegistry, warnings);
+            return;
+        }
+
         ModifyVolumeAssignments modifier;
         int volumeCount = 0;
 
@@ -518,17 +933,18 @@ public:
 
             tree->accept(modifier);
 
+            mModules.emplace_back(new llvm::Module(moduleName + "_" +
+                std::to_string(volumeCount), context));
+
             const std::string funcName("compute_volume_" + std::to_string(volumeCount));
             codegen::VolumeComputeGenerator
-                codeGenerator(module, &customData, options, functionRegistry, warnings, funcName);
+                codeGenerator(*mModules.back(), &customData, options, functionRegistry,
+                    warnings, funcName);
             tree->accept(codeGenerator);
 
             mBlockFunctionNames.push_back(std::vector<std::string>());
             codeGenerator.getFunctionList(mBlockFunctionNames.back());
-
-            if (globals.map().empty() && !codeGenerator.globals().map().empty()) {
-                globals = codeGenerator.globals();
-            }
+            mGlobals.push_back(codeGenerator.globals());
 
             // increment "initial"/"base" volume assignment if we found another assignment
             if (modifier.volumeAssignmentFound()) {
@@ -539,51 +955,182 @@ public:
         }
         while (volumeCount < 1000 && modifier.volumeAssignmentFound());
 
-        // mNumBlocks = volumeCount - 1;
-
         // copy names of volumes which were assigned to
         modifier.appendVolumesAssigned(mVolumesAssigned);
     }
 
-    const std::map<std::string, uint64_t>& functionsForBlock(const int i) const
+    /// @brief  Generates a single block which writes to every assigned volume. The
+    ///         assigned volumes are listed in order of their first assignment.
+    void
+    compileSinglePass(const ast::Tree& syntaxTree,
+                      CustomData& customData,
+                      llvm::LLVMContext& context,
+                      const std::string& moduleName,
+                      const FunctionOptions& options,
+                      codegen::FunctionRegistry& functionRegistry,
+                      std::vector<std::string>* warnings)
     {
-        assert(mBlockFunctionAddresses.size() > size_t(i));
-        return mBlockFunctionAddresses.at(i);
+        mModules.emplace_back(new llvm::Module(moduleName + "_0", context));
+
+        // the block is executed over the union of the topology of the assigned volumes,
+        // so writes are restricted to the voxels active in the volume written to
+
+        codegen::VolumeComputeGenerator
+            codeGenerator(*mModules.back(), &customData, options, functionRegistry,
+                warnings, "compute_volume_0", /*active writes*/true);
+        syntaxTree.accept(codeGenerator);
+
+        mBlockFunctionNames.push_back(std::vector<std::string>());
+        codeGenerator.getFunctionList(mBlockFunctionNames.back());
+        mGlobals.push_back(codeGenerator.globals());
+
+        auto op =
+            [this](const ast::AssignExpression& node) {
+                const auto attribute =
+                    std::dynamic_pointer_cast<ast::Attribute>(node.mVariable);
+                if (!attribute) return;
+                if (std::find(mVolumesAssigned.begin(), mVolumesAssigned.end(),
+                        attribute->mName) != mVolumesAssigned.end()) return;
+                mVolumesAssigned.push_back(attribute->mName);
+            };
+
+        ast::visitNodeType<ast::AssignExpression>(syntaxTree, op);
     }
 
-    const std::vector<std::string>&  functionNamesForBlock(const int i) const
+    /// @brief  The globals of every generated module
+    std::vector<const codegen::SymbolTable*> globals() const
     {
-        assert(mBlockFunctionAddresses.size() > size_t(i));
-        return mBlockFunctionNames.at(i);
+        std::vector<const codegen::SymbolTable*> tables;
+        for (const codegen::SymbolTable& table : mGlobals) tables.push_back(&table);
+        return tables;
     }
 
-    void generateLLVMFunctions(llvm::ExecutionEngine& executionEngine)
+    /// @brief  Releases ownership of the generated modules. The final module holds
+    ///         the trailing block with no assignment, which is never compiled.
+    std::vector<std::unique_ptr<llvm::Module>> takeModules()
     {
-        mBlockFunctionAddresses.resize(mVolumesAssigned.size());
-        const int numBlocks = mVolumesAssigned.size();
-
-        for (int i = 0; i < numBlocks; i++) {
-            for (const std::string& name : mBlockFunctionNames[i]) {
-                const uint64_t address = executionEngine.getFunctionAddress(name);
-                if (!address) {
-                    OPENVDB_THROW(AXCompilerError, "Failed to compile compute function \"" + name + "\"");
-                }
-                mBlockFunctionAddresses[i][name] = address;
-            }
-        }
+        return std::move(mModules);
     }
 
-    std::vector<std::map<std::string, uint64_t> > functionsForAllBlocks() const
+    const std::vector<std::vector<std::string>>& functionNames() const
     {
-        return mBlockFunctionAddresses;
+        return mBlockFunctionNames;
     }
 
 private:
+    std::vector<std::unique_ptr<llvm::Module>> mModules;
+    std::vector<codegen::SymbolTable> mGlobals;
     std::vector<std::vector<std::string> > mBlockFunctionNames;
-    std::vector<std::map<std::string, uint64_t> > mBlockFunctionAddresses;
     std::vector<std::string> mVolumesAssigned;
 };
 
+/// @brief  Generates any code of an executable which would otherwise be generated on
+///         first execution
+inline void compileAll(PointExecutable&) {}
+inline void compileAll(VolumeExecutable& executable) { executable.compileBlocks(); }
+
+/// @brief  Optimises and generates machine code for the module of a volume block on its
+///         first execution. Holds the execution engine, its llvm context and the object
+///         cache, which must outlive the compiled code.
+class LazyVolumeBlockCompiler : public VolumeExecutable::BlockCompiler
+{
+public:
+    LazyVolumeBlockCompiler(const std::shared_ptr<llvm::LLVMContext>& context,
+                            const std::shared_ptr<llvm::ExecutionEngine>& engine,
+                            const CountingMemoryManager& memoryManager,
+                            const std::vector<llvm::Module*>& modules,
+                            const std::vector<std::vector<std::string>>& functionNames,
+                            const std::shared_ptr<EngineObjectCache>& objectCache,
+                            const CompilerOptions& options)
+        : mContext(context)
+        , mExecutionEngine(engine)
+        , mMemoryManager(memoryManager)
+        , mModules(modules)
+        , mFunctionNames(functionNames)
+        , mObjectCache(objectCache)
+        , mOptions(options) {}
+
+    ~LazyVolumeBlockCompiler() override = default;
+
+    std::map<std::string, uint64_t> compile(const size_t block) override
+    {
+        assert(block < mModules.size());
+        llvm::Module* module = mModules[block];
+
+        // if an object cache exists, the engine loads the optimised object directly
+
+        const bool cacheHit = mObjectCache && mObjectCache->load(*module);
+
+        mStatistics.mInstructionsBeforeOptimisation += instructionCount(*module);
+        mStatistics.mFunctionsInstantiated +=
+            instantiatedFunctionCount(*module, mFunctionNames[block]);
+
+        if (cacheHit) {
+            ++mObjectCacheHits;
+        }
+        else {
+            const auto start = std::chrono::steady_clock::now();
+            if (mOptions.functionOptions.mStandardLibraryBitcode) {
+                codegen::linkStandardLibrary(*module);
+            }
+            optimiseAndVerify(module, mOptions.verify, mOptions.optLevel,
+                mExecutionEngine->getTargetMachine());
+            mStatistics.mOptimisationTime += secondsSince(start);
+            mStatistics.mInstructionsAfterOptimisation += instructionCount(*module);
+        }
+
+        // generates code for this block's module only
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::map<std::string, uint64_t> functions;
+        for (const std::string& name : mFunctionNames[block]) {
+            const uint64_t address = mExecutionEngine->getFunctionAddress(name);
+            if (!address) {
+                OPENVDB_THROW(AXCompilerError, "Failed to compile compute function \"" + name + "\"");
+            }
+            functions[name] = address;
+        }
+
+        mStatistics.mMachineCodeTime += secondsSince(start);
+        ++mBlocksCompiled;
+
+        return functions;
+    }
+
+    size_t codeSize() const override { return mMemoryManager.bytes(); }
+
+    /// @brief  Adds the optimisation and machine code statistics of all blocks compiled
+    ///         so far to a report
+    void addStatistics(CompileReport& report) const
+    {
+        report.mOptimisationTime += mStatistics.mOptimisationTime;
+        report.mMachineCodeTime += mStatistics.mMachineCodeTime;
+        report.mInstructionsBeforeOptimisation += mStatistics.mInstructionsBeforeOptimisation;
+        report.mInstructionsAfterOptimisation += mStatistics.mInstructionsAfterOptimisation;
+        report.mFunctionsInstantiated += mStatistics.mFunctionsInstantiated;
+        report.mMachineCodeBytes = this->codeSize();
+        report.mObjectCacheHit = mBlocksCompiled > 0 && mObjectCacheHits == mBlocksCompiled;
+    }
+
+private:
+    // the engine must be destroyed before its context
+    const std::shared_ptr<llvm::LLVMContext> mContext;
+    const std::shared_ptr<llvm::ExecutionEngine> mExecutionEngine;
+    // owned by the execution engine
+    const CountingMemoryManager& mMemoryManager;
+    // owned by the execution engine
+    const std::vector<llvm::Module*> mModules;
+    const std::vector<std::vector<std::string>> mFunctionNames;
+    // set on the execution engine, so must outlive any block compilation
+    const std::shared_ptr<EngineObjectCache> mObjectCache;
+    const CompilerOptions mOptions;
+    // blocks are compiled under the lock of the executable
+    CompileReport mStatistics;
+    size_t mBlocksCompiled = 0;
+    size_t mObjectCacheHits = 0;
+};
+
 
 struct PointDefaultModifier : public openvdb::ax::ast::Modifier
 {
@@ -609,21 +1156,229 @@ struct PointDefaultModifier : public openvdb::ax::ast::Modifier
     }
 };
 
+/// @brief  Returns a copy of a syntax tree with the point defaults applied, verifying
+///         that each attribute is only accessed with a single type
+openvdb::SharedPtr<ast::Tree> preparePointTree(const ast::Tree& syntaxTree)
+{
+    openvdb::SharedPtr<ast::Tree> tree(syntaxTree.copy());
+    PointDefaultModifier modifier;
+    tree->accept(modifier);
+
+    // verify the attributes requested in the syntax tree only have a single type
+    // note that the executer
+    // will also throw a runtime error if the same attribute is accessed with different
+    // types, but as that's currently not a valid state on a PointDataGrid, error in
+    // compilation as well
+    // @todo - introduce a framework for supporting custom preprocessors
+    {
+        std::map<std::string, std::string> nameType;
+        auto op =
+            [&nameType](const ast::Attribute& node) {
+                auto iter = nameType.find(node.mName);
+                if (iter == nameType.end()) {
+                    nameType[node.mName] = node.mType;
+                }
+                else if (iter->second != node.mType) {
+                    OPENVDB_THROW(TypeError, "Ambiguous value type for attribute \"" +
+                        node.mName + "\"");
+                }
+            };
+
+        ast::visitNodeType<ast::Attribute>(*tree, op);
+    }
+
+    return tree;
+}
+
+/// @brief  Creates the target machine used for ahead of time compilation. Unless a CPU
+///         is set in the compiler options, a generic CPU of the host architecture is
+///         targeted so that libraries may be deployed to other machines.
+std::unique_ptr<llvm::TargetMachine> createSharedLibraryTarget(const CompilerOptions& options)
+{
+    const std::string triple = llvm::sys::getProcessTriple();
+
+    std::string error;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (!target) {
+        OPENVDB_THROW(LLVMTargetError, "Unable to find target \"" + triple + "\": " + error);
+    }
+
+    const std::string cpu = options.cpu.empty() ? "generic" : options.cpu;
+
+    std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(triple,
+        cpu, options.features, llvm::TargetOptions(), llvm::Reloc::PIC_,
+        llvm::CodeModel::Default, codeGenOptLevel(options.optLevel)));
+    if (!machine) {
+        OPENVDB_THROW(LLVMTargetError, "Unable to create target machine for \"" + triple + "\"");
+    }
+
+    return machine;
+}
+
+/// @brief  Gives all definitions other than the given entry points internal linkage, so
+///         that they are not exported and do not collide when linking modules
+void internalizeDefinitions(llvm::Module& module, const std::set<std::string>& entryPoints)
+{
+    for (llvm::GlobalVariable& variable : module.globals()) {
+        if (variable.isDeclaration()) continue;
+        variable.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+
+    for (llvm::Function& function : module) {
+        if (function.isDeclaration()) continue;
+        if (entryPoints.count(function.getName().str())) continue;
+        function.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+}
+
+/// @brief  The JIT maps calls to externally defined functions directly to their host
+///         addresses. A shared library can not, so each call is instead made through a
+///         function pointer which is exported by the library and bound when it is
+///         loaded. The symbols of the imported functions are added to the manifest.
+void importExternalFunctions(llvm::Module& module,
+                             const codegen::FunctionRegistry& registry,
+                             SharedLibraryManifest& manifest)
+{
+    std::set<std::string> external;
+
+    for (const auto& iter : registry.map()) {
+        const codegen::FunctionBase::Ptr function = iter.second.function();
+        if (!function) continue;
+        for (const codegen::FunctionSignatureBase::Ptr& signature : function->list()) {
+            if (signature->functionPointer()) external.insert(signature->symbolName());
+        }
+    }
+
+    std::vector<llvm::Function*> imports;
+    for (llvm::Function& function : module) {
+        if (!function.isDeclaration() || function.use_empty()) continue;
+        if (!external.count(function.getName().str())) continue;
+        imports.push_back(&function);
+    }
+
+    for (llvm::Function* function : imports) {
+
+        const std::string name = function->getName().str();
+        llvm::PointerType* type = function->getType();
+
+        llvm::GlobalVariable* pointer =
+            new llvm::GlobalVariable(module, type, /*isConstant*/false,
+                llvm::GlobalValue::ExternalLinkage, llvm::ConstantPointerNull::get(type),
+                SharedLibraryManifest::importSymbol(name));
+
+        const std::vector<llvm::User*> users(function->user_begin(), function->user_end());
+        for (llvm::User* user : users) {
+            llvm::CallInst* call = llvm::dyn_cast<llvm::CallInst>(user);
+            if (!call || call->getCalledValue() != function) {
+                OPENVDB_THROW(LLVMModuleError, "Unable to import function \"" + name +
+                    "\" as it is used other than by a direct call.");
+            }
+            llvm::Value* callee = new llvm::LoadInst(pointer, name, call);
+            call->setCalledFunction(callee);
+        }
+
+        function->eraseFromParent();
+        manifest.mImports.push_back(name);
+    }
+}
+
+/// @brief  Embeds the manifest into a module, emits an object file and links it into a
+///         shared library with the system C compiler driver
+void emitSharedLibrary(llvm::Module& module,
+                       llvm::TargetMachine& machine,
+                       const SharedLibraryManifest& manifest,
+                       const std::string& path)
+{
+    llvm::Constant* data =
+        llvm::ConstantDataArray::getString(module.getContext(), manifest.serialize());
+    new llvm::GlobalVariable(module, data->getType(), /*isConstant*/true,
+        llvm::GlobalValue::ExternalLinkage, data, SharedLibraryManifest::Symbol);
+
+    int fd;
+    llvm::SmallString<256> object;
+    if (llvm::sys::fs::createTemporaryFile("ax", "o", fd, object)) {
+        OPENVDB_THROW(AXCompilerError, "Unable to create a temporary object file.");
+    }
+
+    {
+        llvm::raw_fd_ostream out(fd, /*shouldClose*/true);
+        llvm::legacy::PassManager passes;
+        if (machine.addPassesToEmitFile(passes, out, llvm::TargetMachine::CGFT_ObjectFile)) {
+            llvm::sys::fs::remove(object);
+            OPENVDB_THROW(LLVMTargetError, "Target does not support object file emission.");
+        }
+        passes.run(module);
+    }
+
+    const char* cc = std::getenv("CC");
+    const llvm::ErrorOr<std::string> driver =
+        llvm::sys::findProgramByName((cc && *cc) ? cc : "cc");
+    if (!driver) {
+        llvm::sys::fs::remove(object);
+        OPENVDB_THROW(AXCompilerError, "Unable to find a C compiler driver to link \"" +
+            path + "\".");
+    }
+
+    const std::string objectPath = object.str().str();
+    const char* args[] = { driver->c_str(), "-shared", "-o", path.c_str(),
+        objectPath.c_str(), "-lm", nullptr };
+
+    std::string message;
+    const int result = llvm::sys::ExecuteAndWait(*driver, args, nullptr, nullptr,
+        0, 0, &message);
+    llvm::sys::fs::remove(object);
+
+    if (result != 0) {
+        OPENVDB_THROW(AXCompilerError, "Failed to link shared library \"" + path + "\"" +
+            (message.empty() ? std::string() : ": " + message));
+    }
+}
+
 } // anonymous namespace
 
+void optimiseAndVerify(llvm::Module& module, const CompilerOptions& options)
+{
+    std::unique_ptr<llvm::TargetMachine> targetMachine = createTargetMachine(options);
+    setModuleTarget(module, *targetMachine);
+
+    if (options.functionOptions.mStandardLibraryBitcode) {
+        codegen::linkStandardLibrary(module);
+    }
+    optimiseAndVerify(&module, options.verify, options.optLevel, targetMachine.get());
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
+/// @brief  State used for asynchronous compilation. Every compilation generates code into
+///         its own llvm context, allowing independent programs to be compiled in parallel.
+struct Compiler::CompilePool
+{
+    /// @brief  Guards the compiler's function registry
+    tbb::mutex mMutex;
+    tbb::task_group mTasks;
+};
+
 Compiler::Compiler(const CompilerOptions& options,
                    const std::function<ast::Tree::Ptr(const char*)>& parser)
-    : mContext()
-    , mCompilerOptions(options)
+    : mCompilerOptions(options)
     , mParser(parser)
     , mFunctionRegistry()
+    , mCompilePool(new CompilePool)
 {
-    mContext.reset(new llvm::LLVMContext);
     mFunctionRegistry = codegen::createStandardRegistry(options.functionOptions);
 }
 
+Compiler::~Compiler()
+{
+    // outstanding tasks reference this compiler
+    mCompilePool->mTasks.wait();
+}
+
+void Compiler::wait()
+{
+    mCompilePool->mTasks.wait();
+}
+
 Compiler::UniquePtr Compiler::create(const CompilerOptions &options,
                                      const std::function<ast::Tree::Ptr (const char *)> &parser)
 {
@@ -633,56 +1388,114 @@ Compiler::UniquePtr Compiler::create(const CompilerOptions &options,
 
 void Compiler::setFunctionRegistry(std::unique_ptr<codegen::FunctionRegistry>&& functionRegistry)
 {
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
     mFunctionRegistry = std::move(functionRegistry);
 }
 
+void Compiler::setObjectCache(const std::shared_ptr<ObjectCache>& cache)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    mObjectCache = cache;
+}
+
+std::shared_ptr<ObjectCache> Compiler::objectCache() const
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    return mObjectCache;
+}
+
+void Compiler::setExecutableCache(const std::shared_ptr<ExecutableCache>& cache)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    mExecutableCache = cache;
+}
+
+std::shared_ptr<ExecutableCache> Compiler::executableCache() const
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    return mExecutableCache;
+}
+
 
 template<>
 PointExecutable::Ptr
-Compiler::compile<PointExecutable>(const ast::Tree& syntaxTree,
-                                   const CustomData::Ptr& data,
-                                   std::vector<std::string>* warnings)
+Compiler::compileWithRegistry<PointExecutable>(const ast::Tree& syntaxTree,
+                                               const CustomData::Ptr& data,
+                                               std::vector<std::string>* warnings,
+                                               codegen::FunctionRegistry& functionRegistry,
+                                               const CompilerOptions& options,
+                                               const std::shared_ptr<ObjectCache>& objectCache,
+                                               const std::shared_ptr<ExecutableCache>& executableCache,
+                                               CompileReport* report)
 {
-    openvdb::SharedPtr<ast::Tree> tree(syntaxTree.copy());
-    PointDefaultModifier modifier;
-    tree->accept(modifier);
+    if (report) *report = CompileReport();
 
-    // verify the attributes requested in the syntax tree only have a single type
-    // note that the executer
-    // will also throw a runtime error if the same attribute is accessed with different
-    // types, but as that's currently not a valid state on a PointDataGrid, error in
-    // compilation as well
-    // @todo - introduce a framework for supporting custom preprocessors
-    {
-        std::map<std::string, std::string> nameType;
-        auto op =
-            [&nameType](const ast::Attribute& node) {
-                auto iter = nameType.find(node.mName);
-                if (iter == nameType.end()) {
-                    nameType[node.mName] = node.mType;
-                }
-                else if (iter->second != node.mType) {
-                    OPENVDB_THROW(TypeError, "Ambiguous value type for attribute \"" +
-                        node.mName + "\"");
-                }
-            };
+    const auto codeGenerationStart = std::chrono::steady_clock::now();
 
-        ast::visitNodeType<ast::Attribute>(*tree, op);
+    const openvdb::SharedPtr<ast::Tree> tree = preparePointTree(syntaxTree);
+
+    uint64_t hash = 0;
+    if (executableCache || objectCache) {
+        hash = compilationHash(*tree, "point", options, functionRegistry);
+    }
+
+    // return an existing executable if this program has already been compiled
+
+    uint64_t executableKey = 0;
+    if (executableCache) {
+        executableKey = executableCacheKey(hash, data.get());
+        PointExecutable::Ptr executable =
+            executableCache->get<PointExecutable>(executableKey, warnings);
+        if (executable) {
+            if (report) report->mExecutableCacheHit = true;
+            return executable;
+        }
     }
 
+    // if an object cache exists, key the module on the modified tree. Code generation
+    // is still required on a cache hit to populate the attribute registry
+
+    std::string moduleName("module");
+    if (objectCache) moduleName = objectCacheKey(hash, "point", options);
+
+    // track the warnings generated by this compilation for the executable cache
+
+    std::vector<std::string> compileWarnings;
+    if (executableCache && !warnings) warnings = &compileWarnings;
+    const size_t warningsStart = warnings ? warnings->size() : 0;
+
+    // the executable may be destroyed on any thread, such as on eviction from the
+    // executable cache, while this compiler generates other programs. It therefore owns
+    // its own llvm context along with the execution engine
+
+    const std::shared_ptr<llvm::LLVMContext> context(new llvm::LLVMContext);
+
     // initialize the module and generate LLVM IR
 
-    std::unique_ptr<llvm::Module> module(new llvm::Module("module", *mContext));
+    std::unique_ptr<llvm::Module> module(new llvm::Module(moduleName, *context));
+
+    // load any cached object for the module. It is owned by this compilation until it is
+    // passed to the execution engine
+
+    std::unique_ptr<EngineObjectCache> engineObjectCache;
+    bool cacheHit = false;
+
+    if (objectCache) {
+        engineObjectCache.reset(new EngineObjectCache(objectCache));
+        cacheHit = engineObjectCache->load(*module);
+    }
 
     codegen::PointComputeGenerator
-        codeGenerator(*module, data.get(), mCompilerOptions.functionOptions,
-            *mFunctionRegistry, warnings);
+        codeGenerator(*module, data.get(), options.functionOptions,
+            functionRegistry, warnings, options.pointVectorWidth);
     tree->accept(codeGenerator);
 
     // map accesses (always do this prior to optimising as globals may be removed)
 
     AttributeRegistry::Ptr registry =
         registerAccesses<AttributeRegistry>(codeGenerator.globals(), *tree);
+    registerGroupAccesses(*registry, codeGenerator.globals(), *tree);
+    registerStringAccesses(*registry, codeGenerator.globals());
 
     // as P is accessed specially and not accessed via a global, need to add it to the registry
 
@@ -690,36 +1503,70 @@ Compiler::compile<PointExecutable>(const ast::Tree& syntaxTree,
         registry->addData("P", "vec3s", ast::writesToAttribute(syntaxTree, "P"));
     }
 
-    // optimise
+    std::vector<std::string> functionNames;
+    codeGenerator.getFunctionList(functionNames);
+
+    if (report) {
+        report->mCodeGenerationTime = secondsSince(codeGenerationStart);
+        report->mInstructionsBeforeOptimisation = instructionCount(*module);
+        report->mFunctionsInstantiated = instantiatedFunctionCount(*module, functionNames);
+        report->mObjectCacheHit = cacheHit;
+    }
+
+    // optimise for the target. If the object is cached, the engine loads the optimised
+    // object directly
+
+    std::unique_ptr<llvm::TargetMachine> targetMachine = createTargetMachine(options);
+    setModuleTarget(*module, *targetMachine);
 
     // get module, verify and create execution engine
     llvm::Module* modulePtr = module.get();
-    optimiseAndVerify(modulePtr, mCompilerOptions.verify, mCompilerOptions.optLevel);
+    if (!cacheHit) {
+        const auto start = std::chrono::steady_clock::now();
+        if (options.functionOptions.mStandardLibraryBitcode) {
+            codegen::linkStandardLibrary(*modulePtr);
+        }
+        optimiseAndVerify(modulePtr, options.verify, options.optLevel,
+            targetMachine.get());
+        if (report) {
+            report->mOptimisationTime = secondsSince(start);
+            report->mInstructionsAfterOptimisation = instructionCount(*modulePtr);
+        }
+    }
+
+    const auto machineCodeStart = std::chrono::steady_clock::now();
 
     // create the llvm execution engine which will build our function pointers
 
+    // the memory manager is owned by the execution engine
+
+    CountingMemoryManager* memoryManager = new CountingMemoryManager;
+
     std::string error;
     std::shared_ptr<llvm::ExecutionEngine>
         executionEngine(llvm::EngineBuilder(std::move(module))
+            .setEngineKind(llvm::EngineKind::JIT)
             .setErrorStr(&error)
-            .create());
+            .setMCJITMemoryManager(std::unique_ptr<llvm::RTDyldMemoryManager>(memoryManager))
+            .create(targetMachine.release()));
 
     if (!executionEngine) {
         OPENVDB_THROW(AXExecutionError, "Failed to create ExecutionEngine: " + error);
     }
 
+    if (engineObjectCache) executionEngine->setObjectCache(engineObjectCache.get());
+
     // map functions
 
-    initializeGlobalFunctions(*mFunctionRegistry, *executionEngine, *modulePtr);
+    initializeGlobalFunctions(functionRegistry, *executionEngine, *modulePtr);
 
     // finalize mapping
 
     executionEngine->finalizeObject();
 
-    // get the built function pointers
+    if (engineObjectCache) executionEngine->setObjectCache(nullptr);
 
-    std::vector<std::string> functionNames;
-    codeGenerator.getFunctionList(functionNames);
+    // get the built function pointers
 
     std::map<std::string, uint64_t> functionMap;
 
@@ -731,67 +1578,449 @@ Compiler::compile<PointExecutable>(const ast::Tree& syntaxTree,
         functionMap[name] = address;
     }
 
+    if (report) {
+        report->mMachineCodeTime = secondsSince(machineCodeStart);
+        report->mMachineCodeBytes = memoryManager->bytes();
+    }
+
     // create final executable object
-    PointExecutable::Ptr executable(new PointExecutable(executionEngine, mContext, registry, data,
-        functionMap));
+    const bool pointInvariant = codegen::PointComputeGenerator::isPointInvariant(*tree,
+        functionRegistry, options.functionOptions);
+    PointExecutable::Ptr executable(new PointExecutable(executionEngine, context, registry, data,
+        functionMap, memoryManager->bytes(), pointInvariant));
+
+    if (executableCache) {
+        const std::vector<std::string> generated(warnings->begin() + warningsStart, warnings->end());
+        executableCache->insert(executableKey, executable, executable->codeSize(), &generated);
+    }
+
     return executable;
 }
 
 template<>
 VolumeExecutable::Ptr
-Compiler::compile<VolumeExecutable>(const ast::Tree& syntaxTree,
-                                    const CustomData::Ptr& customData,
-                                    std::vector<std::string>* warnings)
+Compiler::compileWithRegistry<VolumeExecutable>(const ast::Tree& syntaxTree,
+                                                const CustomData::Ptr& customData,
+                                                std::vector<std::string>* warnings,
+                                                codegen::FunctionRegistry& functionRegistry,
+                                                const CompilerOptions& options,
+                                                const std::shared_ptr<ObjectCache>& objectCache,
+                                                const std::shared_ptr<ExecutableCache>& executableCache,
+                                                CompileReport* report)
 {
-    // initialize the module and generate LLVM IR
+    if (report) *report = CompileReport();
 
-    std::unique_ptr<llvm::Module> module(new llvm::Module("module", *mContext));
+    const auto codeGenerationStart = std::chrono::steady_clock::now();
 
-    VolumeCodeBlocks volumeCodeBlocks;
-    codegen::SymbolTable globals;
+    uint64_t hash = 0;
+    if (executableCache || objectCache) {
+        hash = compilationHash(syntaxTree, "volume", options, functionRegistry);
+    }
+
+    // return an existing executable if this program has already been compiled
+
+    uint64_t executableKey = 0;
+    if (executableCache) {
+        executableKey = executableCacheKey(hash, customData.get());
+        VolumeExecutable::Ptr executable =
+            executableCache->get<VolumeExecutable>(executableKey, warnings);
+        if (executable) {
+            if (report) report->mExecutableCacheHit = true;
+            return executable;
+        }
+    }
+
+    // each block module is named from the object cache key so that blocks are cached
+    // individually as they are compiled
+
+    std::string moduleName("module");
+    if (objectCache) moduleName = objectCacheKey(hash, "volume", options);
+
+    // track the warnings generated by this compilation for the executable cache
+
+    std::vector<std::string> compileWarnings;
+    if (executableCache && !warnings) warnings = &compileWarnings;
+    const size_t warningsStart = warnings ? warnings->size() : 0;
 
-    volumeCodeBlocks.compileBlocks(syntaxTree, *customData, *module,
-        mCompilerOptions.functionOptions, globals, *mFunctionRegistry, warnings);
+    // blocks are compiled on first execution, which may happen on any thread and after
+    // this compiler has moved on to other programs. Each executable therefore generates
+    // into its own llvm context, which it owns along with the execution engine
+
+    const std::shared_ptr<llvm::LLVMContext> blockContext(new llvm::LLVMContext);
+
+    // initialize a module per block and generate LLVM IR
+
+    VolumeCodeBlocks volumeCodeBlocks;
+    volumeCodeBlocks.compileBlocks(syntaxTree, *customData, *blockContext, moduleName,
+        options.functionOptions, functionRegistry, warnings, options.singlePassVolumes);
 
     // map accesses (always do this prior to optimising as globals may be removed)
 
     const VolumeRegistry::Ptr registry =
-        registerAccesses<VolumeRegistry>(globals, syntaxTree);
+        registerAccesses<VolumeRegistry>(volumeCodeBlocks.globals(), syntaxTree);
 
+    std::vector<std::unique_ptr<llvm::Module>> modules = volumeCodeBlocks.takeModules();
+    assert(!modules.empty());
 
-    llvm::Module* modulePtr = module.get();
-    optimiseAndVerify(modulePtr, mCompilerOptions.verify, mCompilerOptions.optLevel);
+    if (report) report->mCodeGenerationTime = secondsSince(codeGenerationStart);
+
+    const auto engineStart = std::chrono::steady_clock::now();
+
+    // blocks are optimised on first execution with the engine's target machine
+
+    std::unique_ptr<llvm::TargetMachine> targetMachine = createTargetMachine(options);
+
+    std::vector<llvm::Module*> modulePtrs;
+    for (const auto& module : modules) {
+        setModuleTarget(*module, *targetMachine);
+        modulePtrs.push_back(module.get());
+    }
+
+    // create an engine from the first module and add the remaining blocks. The MCJIT
+    // only generates code for a module when one of its functions is first requested
+
+    // the memory manager is owned by the execution engine
+
+    CountingMemoryManager* memoryManager = new CountingMemoryManager;
 
     std::string error;
     std::shared_ptr<llvm::ExecutionEngine>
-        executionEngine(llvm::EngineBuilder(std::move(module))
+        executionEngine(llvm::EngineBuilder(std::move(modules.front()))
+            .setEngineKind(llvm::EngineKind::JIT)
             .setErrorStr(&error)
-            .create());
+            .setMCJITMemoryManager(std::unique_ptr<llvm::RTDyldMemoryManager>(memoryManager))
+            .create(targetMachine.release()));
 
     if (!executionEngine) {
         OPENVDB_THROW(AXExecutionError, "Failed to create ExecutionEngine: " + error);
     }
 
-    // map functions
+    for (size_t i = 1; i < modules.size(); ++i) {
+        executionEngine->addModule(std::move(modules[i]));
+    }
 
-    initializeGlobalFunctions(*mFunctionRegistry, *executionEngine,
-        *modulePtr);
+    std::shared_ptr<EngineObjectCache> engineObjectCache;
+    if (objectCache) {
+        engineObjectCache.reset(new EngineObjectCache(objectCache));
+        executionEngine->setObjectCache(engineObjectCache.get());
+    }
 
-    // finalize mapping
+    // map functions
 
-    executionEngine->finalizeObject();
+    for (llvm::Module* module : modulePtrs) {
+        initializeGlobalFunctions(functionRegistry, *executionEngine, *module);
+    }
 
-    volumeCodeBlocks.generateLLVMFunctions(*executionEngine);
     std::vector<std::string> volumesAssigned;
     volumeCodeBlocks.getVolumesAssigned(volumesAssigned);
 
+    const std::shared_ptr<LazyVolumeBlockCompiler>
+        blockCompiler(new LazyVolumeBlockCompiler(blockContext, executionEngine,
+            *memoryManager, modulePtrs, volumeCodeBlocks.functionNames(),
+            engineObjectCache, options));
+
     // create final executable object
     VolumeExecutable::Ptr
-        executable(new VolumeExecutable(executionEngine, mContext, registry, customData,
-            volumeCodeBlocks.functionsForAllBlocks(), volumesAssigned));
+        executable(new VolumeExecutable(blockCompiler, registry, customData, volumesAssigned,
+            options.singlePassVolumes));
+
+    // a complete report requires every block to be compiled now rather than on execution.
+    // Setting up the engine is counted as machine code generation
+
+    if (report) {
+        const double engineTime = secondsSince(engineStart);
+        executable->compileBlocks();
+        blockCompiler->addStatistics(*report);
+        report->mMachineCodeTime += engineTime;
+    }
+
+    if (executableCache) {
+        const std::vector<std::string> generated(warnings->begin() + warningsStart, warnings->end());
+        const VolumeExecutable* const volumeExecutable = executable.get();
+        executableCache->insert(executableKey, executable,
+            [volumeExecutable]() { return volumeExecutable->codeSize(); }, &generated);
+    }
+
+    return executable;
+}
+
+
+template<>
+void
+Compiler::compileToSharedLibrary<PointExecutable>(const ast::Tree& syntaxTree,
+                                                  const std::string& path,
+                                                  std::vector<std::string>* warnings)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+
+    const openvdb::SharedPtr<ast::Tree> tree = preparePointTree(syntaxTree);
+
+    // the module is discarded once emitted, so is generated into its own context
+
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> module(new llvm::Module("module", context));
+
+    const std::unique_ptr<llvm::TargetMachine> machine = createSharedLibraryTarget(mCompilerOptions);
+    setModuleTarget(*module, *machine);
+
+    // custom data is read from the kernel arguments at runtime
+    const CustomData::Ptr data = CustomData::create();
+
+    codegen::PointComputeGenerator
+        codeGenerator(*module, data.get(), mCompilerOptions.functionOptions,
+            *mFunctionRegistry, warnings, mCompilerOptions.pointVectorWidth);
+    tree->accept(codeGenerator);
+
+    AttributeRegistry::Ptr registry =
+        registerAccesses<AttributeRegistry>(codeGenerator.globals(), *tree);
+    registerGroupAccesses(*registry, codeGenerator.globals(), *tree);
+    registerStringAccesses(*registry, codeGenerator.globals());
+
+    if (ast::usesAttribute(syntaxTree, "P")) {
+        registry->addData("P", "vec3s", ast::writesToAttribute(syntaxTree, "P"));
+    }
+
+    SharedLibraryManifest manifest;
+    manifest.mExecutable = "point";
+    manifest.mFunctions.emplace_back();
+    codeGenerator.getFunctionList(manifest.mFunctions.back());
+    manifest.mPointInvariant = codegen::PointComputeGenerator::isPointInvariant(*tree,
+        *mFunctionRegistry, mCompilerOptions.functionOptions);
+
+    for (const AttributeRegistry::AttributeData& attribute : registry->attributeData()) {
+        manifest.mData.push_back({attribute.mName, attribute.mType, attribute.mWriteable});
+    }
+    for (const AttributeRegistry::GroupData& group : registry->groupData()) {
+        manifest.mGroups.push_back({group.mName, group.mWriteable});
+    }
+    manifest.mDynamicGroupWrites = registry->dynamicGroupWrites();
+    manifest.mStrings = registry->stringData();
+
+    const std::set<std::string> entryPoints(manifest.mFunctions.back().begin(),
+        manifest.mFunctions.back().end());
+
+    internalizeDefinitions(*module, entryPoints);
+    if (mCompilerOptions.functionOptions.mStandardLibraryBitcode) {
+        codegen::linkStandardLibrary(*module);
+    }
+    importExternalFunctions(*module, *mFunctionRegistry, manifest);
+
+    optimiseAndVerify(module.get(), mCompilerOptions.verify, mCompilerOptions.optLevel,
+        machine.get());
+
+    emitSharedLibrary(*module, *machine, manifest, path);
+}
+
+template<>
+void
+Compiler::compileToSharedLibrary<VolumeExecutable>(const ast::Tree& syntaxTree,
+                                                   const std::string& path,
+                                                   std::vector<std::string>* warnings)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+
+    // the module is discarded once emitted, so is generated into its own context
+
+    llvm::LLVMContext context;
+
+    // custom data is read from the kernel arguments at runtime
+    const CustomData::Ptr data = CustomData::create();
+
+    VolumeCodeBlocks volumeCodeBlocks;
+    volumeCodeBlocks.compileBlocks(syntaxTree, *data, context, "module",
+        mCompilerOptions.functionOptions, *mFunctionRegistry, warnings,
+        mCompilerOptions.singlePassVolumes);
+
+    const VolumeRegistry::Ptr registry =
+        registerAccesses<VolumeRegistry>(volumeCodeBlocks.globals(), syntaxTree);
+
+    SharedLibraryManifest manifest;
+    manifest.mExecutable = "volume";
+    manifest.mFunctions = volumeCodeBlocks.functionNames();
+    volumeCodeBlocks.getVolumesAssigned(manifest.mAssignedVolumes);
+    manifest.mSinglePass = mCompilerOptions.singlePassVolumes;
+
+    for (const VolumeRegistry::VolumeData& volume : registry->volumeData()) {
+        manifest.mData.push_back({volume.mName, volume.mType, volume.mWriteable});
+    }
+
+    std::set<std::string> entryPoints;
+    for (const std::vector<std::string>& block : manifest.mFunctions) {
+        entryPoints.insert(block.begin(), block.end());
+    }
+
+    // link the blocks into a single module. Each block holds its own definitions of
+    // the functions it uses, which are internalized so that they do not collide
+
+    const std::unique_ptr<llvm::TargetMachine> machine = createSharedLibraryTarget(mCompilerOptions);
+
+    std::vector<std::unique_ptr<llvm::Module>> modules = volumeCodeBlocks.takeModules();
+    for (const std::unique_ptr<llvm::Module>& module : modules) {
+        setModuleTarget(*module, *machine);
+        internalizeDefinitions(*module, entryPoints);
+    }
+
+    std::unique_ptr<llvm::Module> module = std::move(modules.front());
+    for (size_t i = 1; i < modules.size(); ++i) {
+        if (llvm::Linker::linkModules(*module, std::move(modules[i]))) {
+            OPENVDB_THROW(LLVMModuleError, "Failed to link volume code blocks.");
+        }
+    }
+
+    if (mCompilerOptions.functionOptions.mStandardLibraryBitcode) {
+        codegen::linkStandardLibrary(*module);
+    }
+    importExternalFunctions(*module, *mFunctionRegistry, manifest);
+
+    optimiseAndVerify(module.get(), mCompilerOptions.verify, mCompilerOptions.optLevel,
+        machine.get());
+
+    emitSharedLibrary(*module, *machine, manifest, path);
+}
+
+template<>
+PointExecutable::Ptr
+Compiler::compile<PointExecutable>(const ast::Tree& syntaxTree,
+                                   const CustomData::Ptr& data,
+                                   std::vector<std::string>* warnings,
+                                   CompileReport* report)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    return this->compileWithRegistry<PointExecutable>(syntaxTree, data, warnings,
+        *mFunctionRegistry, mCompilerOptions, mObjectCache, mExecutableCache, report);
+}
+
+template<>
+VolumeExecutable::Ptr
+Compiler::compile<VolumeExecutable>(const ast::Tree& syntaxTree,
+                                    const CustomData::Ptr& customData,
+                                    std::vector<std::string>* warnings,
+                                    CompileReport* report)
+{
+    tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+    return this->compileWithRegistry<VolumeExecutable>(syntaxTree, customData, warnings,
+        *mFunctionRegistry, mCompilerOptions, mObjectCache, mExecutableCache, report);
+}
+
+template <typename ExecutableT>
+std::future<typename ExecutableT::Ptr>
+Compiler::compileAsync(const ast::Tree& syntaxTree,
+                       const CustomData::Ptr& data,
+                       std::vector<std::string>* warnings)
+{
+    // copy the tree and function registry so that the caller is free to modify or
+    // destroy them, and so that lazy function creation does not race with other
+    // compilations. The caches are captured at submission, as they may be replaced
+    // while the task runs
+
+    const std::shared_ptr<const ast::Tree> tree(syntaxTree.copy());
+    std::shared_ptr<codegen::FunctionRegistry> functionRegistry;
+    std::shared_ptr<ObjectCache> objectCache;
+    std::shared_ptr<ExecutableCache> executableCache;
+    {
+        tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+        functionRegistry.reset(new codegen::FunctionRegistry(*mFunctionRegistry));
+        objectCache = mObjectCache;
+        executableCache = mExecutableCache;
+    }
+
+    std::shared_ptr<std::promise<typename ExecutableT::Ptr>>
+        promise(new std::promise<typename ExecutableT::Ptr>);
+    std::future<typename ExecutableT::Ptr> future = promise->get_future();
+
+    CompilePool& pool = *mCompilePool;
+    pool.mTasks.run([this, tree, data, warnings, functionRegistry,
+            objectCache, executableCache, promise]() {
+        try {
+            promise->set_value(this->compileWithRegistry<ExecutableT>
+                (*tree, data, warnings, *functionRegistry, mCompilerOptions,
+                 objectCache, executableCache, nullptr));
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+
+    return future;
+}
+
+template std::future<PointExecutable::Ptr>
+Compiler::compileAsync<PointExecutable>(const ast::Tree&, const CustomData::Ptr&,
+    std::vector<std::string>*);
+template std::future<VolumeExecutable::Ptr>
+Compiler::compileAsync<VolumeExecutable>(const ast::Tree&, const CustomData::Ptr&,
+    std::vector<std::string>*);
+
+template <typename ExecutableT>
+typename ExecutableT::Ptr
+Compiler::compileTiered(const ast::Tree& syntaxTree,
+                        const CustomData::Ptr& data,
+                        std::vector<std::string>* warnings)
+{
+    const CompilerOptions::OptLevel optLevel = mCompilerOptions.optLevel;
+    if (optLevel == CompilerOptions::OptLevel::O0 ||
+        optLevel == CompilerOptions::OptLevel::NONE) {
+        return this->compile<ExecutableT>(syntaxTree, data, warnings);
+    }
+
+    CompilerOptions unoptimised = mCompilerOptions;
+    unoptimised.optLevel = CompilerOptions::OptLevel::O0;
+
+    // build the unoptimised executable, copying the tree, function registry and caches
+    // for the background build as with compileAsync
+
+    const std::shared_ptr<const ast::Tree> tree(syntaxTree.copy());
+    std::shared_ptr<codegen::FunctionRegistry> functionRegistry;
+    std::shared_ptr<ObjectCache> objectCache;
+    std::shared_ptr<ExecutableCache> executableCache;
+    typename ExecutableT::Ptr executable;
+    {
+        tbb::mutex::scoped_lock lock(mCompilePool->mMutex);
+        executable = this->compileWithRegistry<ExecutableT>(syntaxTree, data, warnings,
+            *mFunctionRegistry, unoptimised, mObjectCache, mExecutableCache, nullptr);
+        functionRegistry.reset(new codegen::FunctionRegistry(*mFunctionRegistry));
+        objectCache = mObjectCache;
+        executableCache = mExecutableCache;
+    }
+
+    // an executable returned from the executable cache may already be upgraded
+
+    if (executable->isUpgraded()) return executable;
+
+    const std::weak_ptr<ExecutableT> target(executable);
+
+    CompilePool& pool = *mCompilePool;
+    pool.mTasks.run([this, tree, data, functionRegistry,
+            objectCache, executableCache, target]() {
+        // nothing to do if the executable has since been released
+        if (target.expired()) return;
+        try {
+            // the optimised executable owns its context, as it is released by whichever
+            // thread drops the last reference to the unoptimised executable, which may
+            // be this worker
+            const typename ExecutableT::Ptr optimised =
+                this->compileWithRegistry<ExecutableT>(*tree, data, nullptr,
+                    *functionRegistry, mCompilerOptions, objectCache, executableCache,
+                    nullptr);
+            compileAll(*optimised);
+
+            const typename ExecutableT::Ptr executable = target.lock();
+            if (executable) executable->upgrade(optimised);
+        }
+        catch (...) {
+            // the unoptimised code remains in use
+        }
+    });
+
     return executable;
 }
 
+template PointExecutable::Ptr
+Compiler::compileTiered<PointExecutable>(const ast::Tree&, const CustomData::Ptr&,
+    std::vector<std::string>*);
+template VolumeExecutable::Ptr
+Compiler::compileTiered<VolumeExecutable>(const ast::Tree&, const CustomData::Ptr&,
+    std::vector<std::string>*);
 
 }
 }
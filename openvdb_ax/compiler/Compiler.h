@@ -39,11 +39,16 @@
 #define OPENVDB_AX_COMPILER_HAS_BEEN_INCLUDED
 
 #include <openvdb_ax/ast/AST.h>
+#include <openvdb_ax/compiler/CompileReport.h>
 #include <openvdb_ax/compiler/CompilerOptions.h>
 #include <openvdb_ax/compiler/CustomData.h>
 
+#include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 // forward
 namespace llvm {
@@ -69,6 +74,8 @@ class FunctionRegistry;
 
 // forward
 class VolumeRegistry;
+class ObjectCache;
+class ExecutableCache;
 
 /// @brief  Initializes llvm. Must be called before any AX compilation or execution is performed.
 void initialize();
@@ -79,6 +86,13 @@ bool isInitialized();
 /// @brief  Shuts down llvm. Must be called on application termination
 void uninitialize();
 
+/// @brief  Verifies and optimises a module as the compiler would before generating its
+///         machine code, for the target CPU of the given options. The standard library
+///         is linked first if enabled by the options.
+/// @param  module   The module to optimise
+/// @param  options  The compiler options providing the optimisation level and target
+void optimiseAndVerify(llvm::Module& module, const CompilerOptions& options);
+
 /// @brief  The compiler class.  This holds an llvm context and set of compiler options, and constructs
 ///         executable objects (e.g. PointExecutable or VolumeExecutable) from a syntax tree or
 ///         snippet of code.
@@ -97,7 +111,8 @@ public:
     Compiler(const CompilerOptions& options = CompilerOptions(),
              const std::function<ast::Tree::Ptr(const char*)>& parser = ast::parse);
 
-    ~Compiler() = default;
+    /// @brief Destructor. Blocks until all asynchronous compilations have completed.
+    ~Compiler();
 
     /// @brief Static method for creating Compiler objects
     static UniquePtr create(const CompilerOptions& options = CompilerOptions(),
@@ -108,27 +123,133 @@ public:
     /// @param data External/custom data which is to be referenced by the executable object. It
     ///        allows one to reference data held elsewhere, such as inside of a DCC, inside of the
     ///        executable
+    /// @param compilerErrors Optional vector of warnings
+    /// @param report Optional report to populate with the timings and statistics of this
+    ///        compilation
     template <typename ExecutableT>
     typename ExecutableT::Ptr
     compile(const ast::Tree& syntaxTree,
             const CustomData::Ptr& data,
-            std::vector<std::string>* compilerErrors = nullptr);
+            std::vector<std::string>* compilerErrors = nullptr,
+            CompileReport* report = nullptr);
 
     /// @brief Compile/build a given snippet of AX code into an executable object of the given type.
     /// @param code A string of AX code
     /// @param data External/custom data which is to be referenced by the executable object. It
     ///        allows one to reference data held elsewhere, such as inside of a DCC, from inside
     ///        the AX code
+    /// @param compilerErrors Optional vector of warnings
+    /// @param report Optional report to populate with the timings and statistics of this
+    ///        compilation, including the parse
     /// @details The parser provided at the compiler's construction is used to convert the string
     ///          into an AST.
     template <typename ExecutableT>
     typename ExecutableT::Ptr
     compile(const std::string& code,
             const CustomData::Ptr& data,
-            std::vector<std::string>* compilerErrors = nullptr)
+            std::vector<std::string>* compilerErrors = nullptr,
+            CompileReport* report = nullptr)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        ast::Tree::Ptr syntaxTree = mParser(code.c_str());
+        const std::chrono::duration<double> parseTime = std::chrono::steady_clock::now() - start;
+
+        typename ExecutableT::Ptr executable =
+            compile<ExecutableT>(*syntaxTree, data, compilerErrors, report);
+        if (report) report->mParseTime = parseTime.count();
+        return executable;
+    }
+
+    /// @brief Asynchronously compile/build a given AST into an executable object of the given
+    ///        type. Compilation is performed on a pool of threads, and each program is
+    ///        generated into its own llvm context, allowing multiple programs to be
+    ///        compiled in parallel.
+    /// @param syntaxTree An abstract syntax tree to compile. The tree is copied and may be
+    ///        modified or destroyed after this call returns
+    /// @param data External/custom data which is to be referenced by the executable object
+    /// @param compilerErrors Optional vector of warnings. This must remain valid until the
+    ///        returned future is ready, and must not be shared with other compilations
+    /// @returns A future holding the executable. Any compilation errors are rethrown from
+    ///          std::future::get()
+    template <typename ExecutableT>
+    std::future<typename ExecutableT::Ptr>
+    compileAsync(const ast::Tree& syntaxTree,
+                 const CustomData::Ptr& data,
+                 std::vector<std::string>* compilerErrors = nullptr);
+
+    /// @brief Asynchronously compile/build a given snippet of AX code into an executable object
+    ///        of the given type.
+    /// @details The code is parsed synchronously using the parser provided at the compiler's
+    ///          construction. Any syntax errors are thrown from this call.
+    template <typename ExecutableT>
+    std::future<typename ExecutableT::Ptr>
+    compileAsync(const std::string& code,
+                 const CustomData::Ptr& data,
+                 std::vector<std::string>* compilerErrors = nullptr)
+    {
+        ast::Tree::Ptr syntaxTree = mParser(code.c_str());
+        return compileAsync<ExecutableT>(*syntaxTree, data, compilerErrors);
+    }
+
+    /// @brief Compile/build a given AST into an unoptimised executable object of the given
+    ///        type which is returned immediately, and schedule a build at the compiler's
+    ///        optimisation level in the background. Once ready, the executable upgrades to
+    ///        the optimised code. This is intended for interactive use, where the first
+    ///        result matters more than its execution speed.
+    /// @param syntaxTree An abstract syntax tree to compile. The tree is copied for the
+    ///        background build and may be modified or destroyed after this call returns
+    /// @param data External/custom data which is to be referenced by the executable object
+    /// @param compilerErrors Optional vector of warnings, populated by the unoptimised build
+    /// @note  If the compiler's optimisation level is O0 or NONE, no background build is
+    ///        scheduled. Errors in the background build are ignored and the unoptimised
+    ///        code continues to be used. Both tiers own their llvm contexts, so the
+    ///        executable may be released on any thread.
+    template <typename ExecutableT>
+    typename ExecutableT::Ptr
+    compileTiered(const ast::Tree& syntaxTree,
+                  const CustomData::Ptr& data,
+                  std::vector<std::string>* compilerErrors = nullptr);
+
+    /// @brief Compile/build a given snippet of AX code into an unoptimised executable object
+    ///        with a background build at the compiler's optimisation level.
+    template <typename ExecutableT>
+    typename ExecutableT::Ptr
+    compileTiered(const std::string& code,
+                  const CustomData::Ptr& data,
+                  std::vector<std::string>* compilerErrors = nullptr)
     {
         ast::Tree::Ptr syntaxTree = mParser(code.c_str());
-        return compile<ExecutableT>(*syntaxTree, data, compilerErrors);
+        return compileTiered<ExecutableT>(*syntaxTree, data, compilerErrors);
+    }
+
+    /// @brief Blocks until all asynchronous and background compilations have completed
+    void wait();
+
+    /// @brief Compile a given AST ahead of time into a shared library, which can be loaded
+    ///        into an executable of the given type with loadExecutable (SharedLibrary.h)
+    ///        without any llvm state. The attribute or volume registry and the function
+    ///        names are embedded into the library.
+    /// @param syntaxTree An abstract syntax tree to compile
+    /// @param path The path of the shared library to write
+    /// @param compilerErrors Optional vector of warnings
+    /// @note  Code is generated for a generic CPU of the host architecture so that libraries
+    ///        can be deployed to other machines. The library is linked with the system C
+    ///        compiler driver, which can be set with the CC environment variable.
+    template <typename ExecutableT>
+    void
+    compileToSharedLibrary(const ast::Tree& syntaxTree,
+                           const std::string& path,
+                           std::vector<std::string>* compilerErrors = nullptr);
+
+    /// @brief Compile a given snippet of AX code ahead of time into a shared library.
+    template <typename ExecutableT>
+    void
+    compileToSharedLibrary(const std::string& code,
+                           const std::string& path,
+                           std::vector<std::string>* compilerErrors = nullptr)
+    {
+        ast::Tree::Ptr syntaxTree = mParser(code.c_str());
+        compileToSharedLibrary<ExecutableT>(*syntaxTree, path, compilerErrors);
     }
 
     /// @brief Sets the compiler's function registry object.
@@ -139,12 +260,52 @@ public:
     ///        manually.
     void setFunctionRegistry(std::unique_ptr<codegen::FunctionRegistry>&& functionRegistry);
 
+    /// @brief Sets a persistent object cache to use for all subsequent compilations. If a
+    ///        compiled object exists for a given program, IR optimisation and machine code
+    ///        generation are skipped and the cached object is linked instead. Newly compiled
+    ///        objects are written into the cache.
+    /// @param cache The object cache. Passing a nullptr disables object caching.
+    void setObjectCache(const std::shared_ptr<ObjectCache>& cache);
+
+    /// @brief Returns the current object cache, or a nullptr if none has been set.
+    std::shared_ptr<ObjectCache> objectCache() const;
+
+    /// @brief Sets an in-process executable cache to use for all subsequent compilations. If
+    ///        the same syntax tree has previously been compiled with the same options, function
+    ///        registry and custom data, the existing executable is returned.
+    /// @param cache The executable cache. Passing a nullptr disables executable caching.
+    void setExecutableCache(const std::shared_ptr<ExecutableCache>& cache);
+
+    /// @brief Returns the current executable cache, or a nullptr if none has been set.
+    std::shared_ptr<ExecutableCache> executableCache() const;
+
 private:
 
-    std::shared_ptr<llvm::LLVMContext> mContext;
+    struct CompilePool;
+
+    /// @brief Compile a given AST using the provided function registry, options and caches
+    /// @note  The caches are passed explicitly rather than read from the compiler, as
+    ///        asynchronous compilations use those set when they were submitted
+    /// @note  Each executable generates code into a new llvm context which it owns, as
+    ///        executables may be destroyed on any thread while this compiler is compiling
+    ///        other programs
+    template <typename ExecutableT>
+    typename ExecutableT::Ptr
+    compileWithRegistry(const ast::Tree& syntaxTree,
+                        const CustomData::Ptr& data,
+                        std::vector<std::string>* compilerErrors,
+                        codegen::FunctionRegistry& functionRegistry,
+                        const CompilerOptions& options,
+                        const std::shared_ptr<ObjectCache>& objectCache,
+                        const std::shared_ptr<ExecutableCache>& executableCache,
+                        CompileReport* report);
+
     const CompilerOptions mCompilerOptions;
     const std::function<ast::Tree::Ptr(const char*)> mParser;
     std::shared_ptr<codegen::FunctionRegistry> mFunctionRegistry;
+    std::shared_ptr<ObjectCache> mObjectCache;
+    std::shared_ptr<ExecutableCache> mExecutableCache;
+    std::unique_ptr<CompilePool> mCompilePool;
 };
 
 
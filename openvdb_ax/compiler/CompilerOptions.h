@@ -33,6 +33,8 @@
 
 #include <openvdb/openvdb.h>
 
+#include <string>
+
 namespace openvdb {
 OPENVDB_USE_VERSION_NAMESPACE
 namespace OPENVDB_VERSION_NAME {
@@ -51,6 +53,12 @@ struct FunctionOptions
     ///         At the end of code generation, only functions which have been instantiated
     ///         will exist in the function map.
     bool mLazyFunctions = true;
+    /// @brief  When enabled, external functions which are defined by the embedded standard
+    ///         library bitcode are linked into generated code, allowing them to be inlined
+    ///         and vectorised. Otherwise they are called through their function pointers.
+    /// @note   Has no effect if openvdb_ax was built without clang, as no bitcode is
+    ///         embedded. See codegen::hasStandardLibrary
+    bool mStandardLibraryBitcode = true;
 };
 
 /// @brief Settings which control how a Compiler class object behaves
@@ -75,6 +83,28 @@ struct CompilerOptions
     bool verify = true;
     /// @brief Options for the function registry
     FunctionOptions functionOptions = FunctionOptions();
+    /// @brief The CPU to optimise and generate code for, e.g. "skylake-avx512". If empty,
+    ///        the host CPU and its features are used.
+    std::string cpu = "";
+    /// @brief A comma separated list of target features to enable or disable on top of
+    ///        those of the CPU, e.g. "+avx2,-avx512f".
+    std::string features = "";
+    /// @brief When enabled, volume programs are compiled into a single kernel which writes
+    ///        every assigned volume in one traversal of their topology, rather than one
+    ///        kernel and traversal per assigned volume. All assigned volumes must share a
+    ///        transform. Voxels are visited over the union of their active topology, and
+    ///        each volume is only written to at its own active voxels, as it would be by
+    ///        its own kernel. Programs which read other voxels than the one being
+    ///        executed, e.g. with getvoxelpws, may see values which the kernel of each
+    ///        volume would only write in a later pass.
+    bool singlePassVolumes = false;
+    /// @brief The number of points evaluated per iteration of the point kernel, one of
+    ///        4, 8 or 16. The kernel is inlined into the point loop, which is vectorised
+    ///        to this width with conditionals evaluated on masked lanes and the leaf tail
+    ///        by a scalar remainder loop. Programs using features which can not be
+    ///        vectorised, such as strings, group edits and position access, use the scalar
+    ///        kernel, as do all programs if this is 0.
+    size_t pointVectorWidth = 0;
 };
 
 }
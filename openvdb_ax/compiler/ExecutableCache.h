@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file compiler/ExecutableCache.h
+///
+/// @brief  An in-process cache of compiled executables, used by the Compiler to
+///         return existing executables for repeated compilations of the same
+///         program.
+///
+
+#ifndef OPENVDB_AX_COMPILER_EXECUTABLE_CACHE_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_COMPILER_EXECUTABLE_CACHE_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <tbb/mutex.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+/// @brief  A thread safe, least recently used cache of executables keyed on a hash of
+///         the compiled syntax tree, compiler options and custom data. Entries are
+///         evicted when the total JIT code size of all cached executables exceeds
+///         the cache's capacity. As executables may compile code lazily, the code size
+///         of each entry is queried whenever the cache is modified.
+/// @note   Evicting an entry only releases the cache's reference to the executable.
+///         Executables which are still held elsewhere remain valid.
+class ExecutableCache
+{
+public:
+
+    using Ptr = std::shared_ptr<ExecutableCache>;
+
+    /// @brief  Counters of cache events since construction or the last reset
+    struct Statistics
+    {
+        size_t mHits = 0;
+        size_t mMisses = 0;
+        size_t mEvictions = 0;
+        /// @brief  The number of currently cached executables
+        size_t mEntries = 0;
+        /// @brief  The total JIT code size in bytes of all cached executables
+        size_t mBytes = 0;
+    };
+
+    /// @brief  Construct a cache with a given capacity
+    /// @param capacity  The maximum total JIT code size in bytes of all cached executables
+    ExecutableCache(const size_t capacity = 64 * 1024 * 1024)
+        : mCapacity(capacity), mEntries(), mLRU(), mStatistics(), mMutex() {}
+    ~ExecutableCache() = default;
+
+    /// @brief  Static method for creating ExecutableCache objects
+    static Ptr create(const size_t capacity = 64 * 1024 * 1024)
+    {
+        Ptr cache(new ExecutableCache(capacity));
+        return cache;
+    }
+
+    /// @brief  Returns the executable for a given key, or a nullptr if it does not exist or
+    ///         was inserted as a different executable type. Any warnings generated by the
+    ///         original compilation are appended to warnings.
+    /// @param key       The compilation key
+    /// @param warnings  Optional vector of warnings to populate
+    template <typename ExecutableT>
+    typename ExecutableT::Ptr
+    get(const uint64_t key, std::vector<std::string>* warnings = nullptr)
+    {
+        tbb::mutex::scoped_lock lock(mMutex);
+
+        auto iter = mEntries.find(key);
+        if (iter == mEntries.end() || *iter->second.mType != typeid(ExecutableT)) {
+            ++mStatistics.mMisses;
+            return nullptr;
+        }
+
+        ++mStatistics.mHits;
+        Entry& entry = iter->second;
+
+        // move to the front of the lru list
+
+        mLRU.splice(mLRU.begin(), mLRU, entry.mPosition);
+
+        if (warnings) {
+            warnings->insert(warnings->end(), entry.mWarnings.begin(), entry.mWarnings.end());
+        }
+
+        return std::static_pointer_cast<ExecutableT>(entry.mExecutable);
+    }
+
+    /// @brief  Inserts an executable into the cache. If the key already exists, the
+    ///         existing entry is replaced. Entries are evicted until the cache is
+    ///         within its capacity.
+    /// @param key         The compilation key
+    /// @param executable  The executable to insert
+    /// @param bytes       The JIT code size in bytes of the executable
+    /// @param warnings    Optional warnings generated by the compilation
+    template <typename ExecutableT>
+    void insert(const uint64_t key,
+                const std::shared_ptr<ExecutableT>& executable,
+                const size_t bytes,
+                const std::vector<std::string>* warnings = nullptr)
+    {
+        this->insert(key, executable, [bytes]() { return bytes; }, warnings);
+    }
+
+    /// @brief  Inserts an executable whose JIT code size may change after insertion,
+    ///         for example an executable which compiles its functions on first use.
+    /// @param key         The compilation key
+    /// @param executable  The executable to insert
+    /// @param bytes       Returns the current JIT code size in bytes of the executable
+    /// @param warnings    Optional warnings generated by the compilation
+    template <typename ExecutableT>
+    void insert(const uint64_t key,
+                const std::shared_ptr<ExecutableT>& executable,
+                const std::function<size_t()>& bytes,
+                const std::vector<std::string>* warnings = nullptr)
+    {
+        tbb::mutex::scoped_lock lock(mMutex);
+
+        this->erase(key);
+
+        mLRU.push_front(key);
+
+        Entry& entry = mEntries[key];
+        entry.mExecutable = executable;
+        entry.mType = &typeid(ExecutableT);
+        entry.mBytes = bytes;
+        entry.mPosition = mLRU.begin();
+        if (warnings) entry.mWarnings = *warnings;
+
+        // always keep the most recent entry, even if it exceeds the capacity
+
+        while (mLRU.size() > 1 && this->bytes() > mCapacity) {
+            this->erase(mLRU.back());
+            ++mStatistics.mEvictions;
+        }
+    }
+
+    /// @brief  Removes all cached executables
+    void clear()
+    {
+        tbb::mutex::scoped_lock lock(mMutex);
+        mEntries.clear();
+        mLRU.clear();
+    }
+
+    /// @brief  Returns the maximum total JIT code size in bytes of all cached executables
+    inline size_t capacity() const { return mCapacity; }
+
+    /// @brief  Returns the current cache statistics
+    Statistics statistics() const
+    {
+        tbb::mutex::scoped_lock lock(mMutex);
+        Statistics stats = mStatistics;
+        stats.mEntries = mEntries.size();
+        stats.mBytes = this->bytes();
+        return stats;
+    }
+
+    /// @brief  Resets the hit, miss and eviction counters
+    void resetStatistics()
+    {
+        tbb::mutex::scoped_lock lock(mMutex);
+        mStatistics = Statistics();
+    }
+
+private:
+
+    struct Entry
+    {
+        std::shared_ptr<void> mExecutable;
+        // the type of the executable, checked before it is cast back from void
+        const std::type_info* mType = nullptr;
+        std::function<size_t()> mBytes;
+        std::vector<std::string> mWarnings;
+        std::list<uint64_t>::iterator mPosition;
+    };
+
+    // not thread safe, requires the lock to be held
+    inline void erase(const uint64_t key)
+    {
+        auto iter = mEntries.find(key);
+        if (iter == mEntries.end()) return;
+        mLRU.erase(iter->second.mPosition);
+        mEntries.erase(iter);
+    }
+
+    // not thread safe, requires the lock to be held
+    inline size_t bytes() const
+    {
+        size_t total = 0;
+        for (const auto& entry : mEntries) total += entry.second.mBytes();
+        return total;
+    }
+
+    const size_t mCapacity;
+    std::unordered_map<uint64_t, Entry> mEntries;
+    std::list<uint64_t> mLRU;
+    Statistics mStatistics;
+    mutable tbb::mutex mMutex;
+};
+
+}
+}
+}
+
+#endif // OPENVDB_AX_COMPILER_EXECUTABLE_CACHE_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "ObjectCache.h"
+
+#include <openvdb_ax/Exceptions.h>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+ObjectCache::ObjectCache(const std::string& directory)
+    : mDirectory(directory)
+    , mHits(0)
+    , mMisses(0)
+    , mStores(0)
+{
+    if (mDirectory.empty()) {
+        OPENVDB_THROW(AXCompilerError, "Object cache requires a valid directory.");
+    }
+
+    const std::error_code error = llvm::sys::fs::create_directories(mDirectory);
+    if (error) {
+        OPENVDB_THROW(AXCompilerError, "Unable to create object cache directory \"" +
+            mDirectory + "\": " + error.message());
+    }
+}
+
+ObjectCache::Ptr ObjectCache::create(const std::string& directory)
+{
+    Ptr cache(new ObjectCache(directory));
+    return cache;
+}
+
+std::string ObjectCache::filePath(const std::string& key) const
+{
+    llvm::SmallString<256> path(mDirectory);
+    llvm::sys::path::append(path, key + ".o");
+    return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> ObjectCache::load(const std::string& key)
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+        llvm::MemoryBuffer::getFile(this->filePath(key), /*FileSize*/-1,
+            /*RequiresNullTerminator*/false);
+
+    if (!buffer) {
+        ++mMisses;
+        return nullptr;
+    }
+
+    ++mHits;
+    return std::move(buffer.get());
+}
+
+ObjectCache::Statistics ObjectCache::statistics() const
+{
+    Statistics stats;
+    stats.mHits = mHits;
+    stats.mMisses = mMisses;
+    stats.mStores = mStores;
+    return stats;
+}
+
+void ObjectCache::resetStatistics()
+{
+    mHits = 0;
+    mMisses = 0;
+    mStores = 0;
+}
+
+void ObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object)
+{
+    const std::string& key = module->getModuleIdentifier();
+    const std::string path = this->filePath(key);
+
+    // write to a unique temporary file and rename into place so that concurrent
+    // readers never see a partially written object
+
+    int fd;
+    llvm::SmallString<256> tmpPath;
+    if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%.tmp", fd, tmpPath)) return;
+
+    {
+        llvm::raw_fd_ostream os(fd, /*shouldClose*/true);
+        os.write(object.getBufferStart(), object.getBufferSize());
+        os.close();
+        if (os.has_error()) {
+            os.clear_error();
+            llvm::sys::fs::remove(tmpPath);
+            return;
+        }
+    }
+
+    if (llvm::sys::fs::rename(tmpPath, path)) {
+        llvm::sys::fs::remove(tmpPath);
+        return;
+    }
+
+    ++mStores;
+}
+
+std::unique_ptr<llvm::MemoryBuffer> ObjectCache::getObject(const llvm::Module* module)
+{
+    return this->load(module->getModuleIdentifier());
+}
+
+}
+}
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
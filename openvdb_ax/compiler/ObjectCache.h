@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file compiler/ObjectCache.h
+///
+/// @brief  A persistent, on disk cache of compiled machine code objects which
+///         can be provided to the Compiler to avoid optimisation and code
+///         generation of previously compiled programs.
+///
+
+#ifndef OPENVDB_AX_COMPILER_OBJECT_CACHE_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_COMPILER_OBJECT_CACHE_HAS_BEEN_INCLUDED
+
+#include <openvdb/version.h>
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+/// @brief  An implementation of an llvm::ObjectCache which stores compiled objects
+///         as files inside of a given directory. Objects are keyed on the identifier
+///         of the llvm module they were compiled from, which the Compiler sets to a
+///         hash of the syntax tree, compiler options, function registry, host and
+///         code generation version of the AX library.
+/// @note   All methods are thread safe and the cache may be shared between
+///         multiple Compiler instances and processes.
+class ObjectCache : public llvm::ObjectCache
+{
+public:
+
+    using Ptr = std::shared_ptr<ObjectCache>;
+
+    /// @brief  Counters of cache events since construction or the last reset
+    struct Statistics
+    {
+        /// @brief  Number of objects successfully loaded from the cache
+        size_t mHits = 0;
+        /// @brief  Number of object requests which were not found in the cache
+        size_t mMisses = 0;
+        /// @brief  Number of newly compiled objects written into the cache
+        size_t mStores = 0;
+    };
+
+    /// @brief  Construct a cache in the given directory. The directory is created
+    ///         if it does not exist
+    /// @param directory  The directory to store and load objects from
+    ObjectCache(const std::string& directory);
+    ~ObjectCache() override = default;
+
+    /// @brief  Static method for creating ObjectCache objects
+    static Ptr create(const std::string& directory);
+
+    /// @brief  Returns the directory this cache reads and writes
+    inline const std::string& directory() const { return mDirectory; }
+
+    /// @brief  Loads the object for a given key into memory, returning a nullptr if it
+    ///         does not exist. Ownership of the object passes to the caller, so that a
+    ///         compilation can decide whether to optimise a module and later provide the
+    ///         same object to the execution engine, regardless of any concurrent changes
+    ///         to the cache directory.
+    /// @param key  The module identifier of the object
+    std::unique_ptr<llvm::MemoryBuffer> load(const std::string& key);
+
+    /// @brief  Returns the current hit/miss/store counts
+    Statistics statistics() const;
+
+    /// @brief  Resets all counters to zero
+    void resetStatistics();
+
+    /// @brief  llvm::ObjectCache interface, called by the execution engine after an
+    ///         object has been compiled from a module which was not in the cache
+    void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+    /// @brief  llvm::ObjectCache interface, called by the execution engine prior to
+    ///         compiling a module. Returns nullptr if no object exists. Equivalent to
+    ///         load() with the module identifier.
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+private:
+
+    std::string filePath(const std::string& key) const;
+
+    const std::string mDirectory;
+    std::atomic<size_t> mHits;
+    std::atomic<size_t> mMisses;
+    std::atomic<size_t> mStores;
+};
+
+}
+}
+}
+
+#endif // OPENVDB_AX_COMPILER_OBJECT_CACHE_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -44,9 +44,20 @@
 #include <openvdb/points/PointGroup.h>
 #include <openvdb/points/PointMask.h>
 #include <openvdb/points/PointMove.h>
+#include <openvdb/tools/Prune.h>
 #include <openvdb/Types.h>
 
-#include <type_traits> // std::enable_if
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <functional> // std::plus
+#include <limits>
+#include <map>
+#include <memory> // std::atomic_load
+#include <set>
+#include <string>
 
 namespace openvdb {
 OPENVDB_USE_VERSION_NAMESPACE
@@ -56,36 +67,92 @@ namespace ax {
 
 namespace {
 
-template<typename FilterT = openvdb::points::NullFilter>
+/// @brief  Moves the points whose positions were written by the executed code
 struct PointExecuterDeformer
 {
     using LeafNodeT = openvdb::points::PointDataTree::LeafNodeType;
 
-    PointExecuterDeformer(std::vector<codegen::LeafLocalData::UniquePtr>& data,
-        const FilterT& filter)
+    PointExecuterDeformer(const std::vector<codegen::LeafLocalData>& data)
         : mData(data)
-        , mFilter(filter)
-        , mPositions(nullptr) {}
+        , mLeafData(nullptr) {}
 
     template <typename LeafT>
-    void reset(const LeafT& leaf, const size_t idx)
+    void reset(const LeafT&, const size_t idx)
     {
-        mFilter.reset(leaf);
-        mPositions = &mData[idx]->getPositions();
+        mLeafData = &mData[idx];
     }
 
     template <typename IterT>
     void apply(Vec3d& position, const IterT& iter) const
     {
-        if (mFilter.valid(iter)) {
-            assert(mPositions);
-            position = (*mPositions)[*iter];
+        assert(mLeafData);
+        codegen::LeafLocalData::PositionT written;
+        if (mLeafData->getWrittenPosition(*iter, written)) position = written;
+    }
+
+    const std::vector<codegen::LeafLocalData>&  mData;
+    const codegen::LeafLocalData*               mLeafData;
+};
+
+/// @brief  A group named by the program, resolved against the descriptor shared by the
+///         leaves of a grid
+struct GroupBinding
+{
+    /// The index of the array holding the group, INVALID_POS if it does not exist
+    size_t mArray;
+    openvdb::points::GroupType mOffset;
+    bool mWriteable;
+};
+
+/// @brief  Provides the arena of the calling thread for the duration of a scope. The
+///         arena is kept once the scope ends so that its memory is reused by the next
+///         execution on the thread. A temporary arena is used if the arena of the
+///         thread is already in use
+class ThreadLeafArena
+{
+public:
+    ThreadLeafArena()
+        : mArena(nullptr)
+        , mTemporary()
+    {
+        Storage& storage = threadStorage();
+        if (storage.mInUse) {
+            mTemporary.reset(new codegen::LeafArena);
+            mArena = mTemporary.get();
+        }
+        else {
+            storage.mInUse = true;
+            mArena = &storage.mArena;
         }
     }
 
-    std::vector<codegen::LeafLocalData::UniquePtr>& mData;
-    FilterT                                         mFilter;
-    const codegen::LeafLocalData::PositionVector*   mPositions;
+    ~ThreadLeafArena()
+    {
+        // the objects of the last leaf are destroyed before the arena is released
+        mArena->reset();
+        if (!mTemporary) threadStorage().mInUse = false;
+    }
+
+    ThreadLeafArena(const ThreadLeafArena&) = delete;
+    ThreadLeafArena& operator=(const ThreadLeafArena&) = delete;
+
+    inline codegen::LeafArena& get() { return *mArena; }
+
+private:
+    struct Storage
+    {
+        codegen::LeafArena mArena;
+        bool mInUse = false;
+    };
+
+    static Storage& threadStorage()
+    {
+        static thread_local Storage storage;
+        return storage;
+    }
+
+    codegen::LeafArena* mArena;
+    std::unique_ptr<codegen::LeafArena> mTemporary;
 };
 
 
@@ -94,39 +161,128 @@ inline void
 addAttributeHandleTyped(codegen::ComputePointFunction::Arguments& args,
                         openvdb::points::PointDataTree::LeafNodeType& leaf,
                         const std::string& name,
-                        const bool write)
+                        const bool write,
+                        const bool expand)
 {
     const openvdb::points::AttributeSet& attributeSet = leaf.attributeSet();
     const size_t pos = attributeSet.find(name);
     assert(pos != openvdb::points::AttributeSet::INVALID_POS);
 
-    if (write) args.addWriteHandle<ValueType>(leaf, pos);
+    if (write) args.addWriteHandle<ValueType>(leaf, pos, expand);
     else       args.addHandle<ValueType>(leaf, pos);
 }
 
+template <>
+inline void
+addAttributeHandleTyped<Name>(codegen::ComputePointFunction::Arguments& args,
+                              openvdb::points::PointDataTree::LeafNodeType& leaf,
+                              const std::string& name,
+                              const bool write,
+                              const bool expand)
+{
+    const openvdb::points::AttributeSet& attributeSet = leaf.attributeSet();
+    const size_t pos = attributeSet.find(name);
+    assert(pos != openvdb::points::AttributeSet::INVALID_POS);
+
+    if (write) args.addWriteHandle<Name>(leaf, pos, expand);
+    else       args.addStringHandle(leaf, pos);
+}
+
 inline void
 addAttributeHandle(codegen::ComputePointFunction::Arguments& args,
                    openvdb::points::PointDataTree::LeafNodeType& leaf,
                    const std::string& name,
                    const std::string& valueType,
-                   const bool write)
+                   const bool write,
+                   const bool expand = true)
 {
-    if (valueType == openvdb::typeNameAsString<bool>())                     addAttributeHandleTyped<bool>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<int16_t>())             addAttributeHandleTyped<int16_t>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<int32_t>())             addAttributeHandleTyped<int32_t>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<int64_t>())             addAttributeHandleTyped<int64_t>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<float>())               addAttributeHandleTyped<float>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<double>())              addAttributeHandleTyped<double>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<math::Vec3<int32_t>>()) addAttributeHandleTyped<math::Vec3<int32_t>>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<math::Vec3<float>>())   addAttributeHandleTyped<math::Vec3<float>>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<math::Vec3<double>>())  addAttributeHandleTyped<math::Vec3<double>>(args, leaf, name, write);
-    else if (valueType == openvdb::typeNameAsString<Name>())                addAttributeHandleTyped<Name>(args, leaf, name, write);
+    if (valueType == openvdb::typeNameAsString<bool>())                     addAttributeHandleTyped<bool>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<int16_t>())             addAttributeHandleTyped<int16_t>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<int32_t>())             addAttributeHandleTyped<int32_t>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<int64_t>())             addAttributeHandleTyped<int64_t>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<float>())               addAttributeHandleTyped<float>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<double>())              addAttributeHandleTyped<double>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<math::Vec3<int32_t>>()) addAttributeHandleTyped<math::Vec3<int32_t>>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<math::Vec3<float>>())   addAttributeHandleTyped<math::Vec3<float>>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<math::Vec3<double>>())  addAttributeHandleTyped<math::Vec3<double>>(args, leaf, name, write, expand);
+    else if (valueType == openvdb::typeNameAsString<Name>())                addAttributeHandleTyped<Name>(args, leaf, name, write, expand);
     else {
         OPENVDB_THROW(TypeError, "Could not retrieve attribute '" + name + "' as it has an unknown value type '" + valueType + "'");
     }
 }
 
-/// @brief  VDB Points executer for a compiled function pointer
+/// @brief  The strings read by a program through the indices held by string attributes,
+///         resolved once per execution from the metadata of the descriptor shared by
+///         every leaf. mStrings[i] is the null terminated string of index i, where
+///         index 0 is the empty string. mLiterals holds the index of each string
+///         literal of the registry, or the maximum index if no point can hold it
+struct StringTable
+{
+    StringTable(const openvdb::MetaMap& metadata, const AttributeRegistry::StringVec& literals)
+        : mStrings(1, "")
+        , mLiterals()
+    {
+        // string attributes hold one plus the index of the metadata entry
+        // "string:<index>"
+
+        std::map<std::string, Index> indices;
+        for (auto iter = metadata.beginMeta(); iter != metadata.endMeta(); ++iter) {
+            if (iter->first.compare(0, 7, "string:") != 0) continue;
+            const StringMetadata* const meta = dynamic_cast<StringMetadata*>(iter->second.get());
+            if (!meta) continue;
+
+            const Index index = 1 + Index(std::stoi(iter->first.substr(7)));
+            if (index >= mStrings.size()) mStrings.resize(index + 1, "");
+            mStrings[index] = meta->value().c_str();
+            indices[meta->value()] = index;
+        }
+
+        mLiterals.reserve(literals.size());
+        for (const std::string& literal : literals) {
+            if (literal.empty()) {
+                mLiterals.emplace_back(0);
+                continue;
+            }
+            const auto iter = indices.find(literal);
+            mLiterals.emplace_back(iter == indices.end() ?
+                std::numeric_limits<Index>::max() : iter->second);
+        }
+    }
+
+    std::vector<const char*> mStrings;
+    std::vector<Index> mLiterals;
+};
+
+/// @brief  The compiled functions of a point program. The group range function is
+///         optional, as libraries built before it existed do not provide it
+struct PointKernels
+{
+    codegen::ComputePointFunction::SignaturePtr mCompute;
+    codegen::ComputePointRangeFunction::SignaturePtr mRange;
+    codegen::ComputePointGroupRangeFunction::SignaturePtr mGroupRange;
+};
+
+/// @brief  Returns the compiled functions of a point program from their addresses
+PointKernels pointKernels(const uint64_t computeAddress,
+                          const uint64_t rangeAddress,
+                          const uint64_t groupRangeAddress)
+{
+    // the point and range functions are all used as the kernel is selected per leaf
+
+    if (computeAddress == 0 || rangeAddress == 0) {
+        OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
+    }
+
+    return PointKernels{
+        reinterpret_cast<codegen::ComputePointFunction::SignaturePtr>(computeAddress),
+        reinterpret_cast<codegen::ComputePointRangeFunction::SignaturePtr>(rangeAddress),
+        reinterpret_cast<codegen::ComputePointGroupRangeFunction::SignaturePtr>
+            (groupRangeAddress)
+    };
+}
+
+/// @brief  VDB Points executer for a compiled function pointer. The kernel run on each
+///         leaf is selected from the state of the leaf's filter group and attributes
 template<bool UseTransform, bool UseGroup>
 struct PointExecuterOp
 {
@@ -138,130 +294,187 @@ struct PointExecuterOp
     using GroupIndex = Descriptor::GroupIndex;
 
     using FunctionT = codegen::ComputePointFunction::SignaturePtr;
+    using RangeFunctionT = codegen::ComputePointRangeFunction::SignaturePtr;
+    using GroupRangeFunctionT = codegen::ComputePointGroupRangeFunction::SignaturePtr;
 
     PointExecuterOp(const AttributeRegistry& attributeRegistry,
                const CustomData& customData,
                FunctionT computeFunction,
+               RangeFunctionT rangeFunction,
+               GroupRangeFunctionT groupRangeFunction,
+               const bool pointInvariant,
                const math::Transform& transform,
                const GroupIndex* const groupIndex,
-               std::vector<codegen::LeafLocalData::UniquePtr>& leafLocalData)
+               const std::vector<GroupBinding>& groups,
+               const std::vector<size_t>& groupArrays,
+               const StringTable& strings,
+               std::vector<codegen::LeafLocalData>& leafLocalData)
         : mComputeFunction(computeFunction)
+        , mRangeFunction(rangeFunction)
+        , mGroupRangeFunction(groupRangeFunction)
+        , mPointInvariant(pointInvariant)
         , mCustomData(customData)
         , mTransform(transform)
         , mGroupIndex(groupIndex)
         , mAttributeRegistry(attributeRegistry)
-        , mLeafLocalData(leafLocalData) {}
-
-    // UseGroup = true
-    template<bool UseG>
-    typename std::enable_if<UseG, void>::type
-    execute(LeafNode& leaf, codegen::ComputePointFunction::Arguments& args) const
+        , mAttributeCount(0)
+        , mGroups(groups)
+        , mGroupArrays(groupArrays)
+        , mStrings(strings)
+        , mLeafLocalData(leafLocalData)
     {
-        using IndexIterT = openvdb::points::IndexIter<LeafNode::ValueAllCIter, GroupFilter>;
-
-        assert(mGroupIndex);
-        GroupFilter filter(*mGroupIndex);
-        IndexIterT iter = leaf.beginIndex<LeafNode::ValueAllCIter, GroupFilter>(filter);
-
-        for (; iter; ++iter) {
-            args.mIndex = *iter;
-            args.bind(mComputeFunction)();
+        for (const auto& iter : mAttributeRegistry.attributeData()) {
+            if (iter.mName != "P") ++mAttributeCount;
         }
     }
 
-    // UseGroup = false
-    template<bool UseG>
-    typename std::enable_if<!UseG, void>::type
-    execute(LeafNode& leaf, codegen::ComputePointFunction::Arguments& args) const
+    /// @brief  Returns true if every attribute accessed by the program, other than
+    ///         position, is stored as a uniform array in the leaf
+    bool isUniform(const LeafNode& leaf) const
     {
-        // the Compute function performs unsigned integer arithmetic and will wrap
-        // if count <= 0 inside ComputeGenerator::genComputeFunction()
+        for (const auto& iter : mAttributeRegistry.attributeData()) {
+            if (iter.mName == "P") continue;
+            if (!leaf.constAttributeArray(iter.mName).isUniform()) return false;
+        }
+        return true;
+    }
 
+    void operator()(codegen::ComputePointFunction::Arguments& args,
+                    LeafNode& leaf,
+                    size_t idx) const
+    {
         const Index count = leaf.getLastValue();
-        if (count <= 0) return;
 
-        args.mIndex = count;
-        args.bind(mComputeFunction)();
-    }
+        // leaves in which the group is uniform are either skipped or processed as if
+        // no group was provided
 
+        bool filtered = UseGroup;
 
-    void operator()(LeafNode& leaf, size_t idx) const
-    {
-        codegen::ComputePointFunction::Arguments
-            args(mCustomData, leaf.attributeSet(), leaf.getLastValue());
+        if (UseGroup) {
+            assert(mGroupIndex);
+            const openvdb::points::GroupHandle handle = leaf.groupHandle(*mGroupIndex);
+            if (handle.isUniform()) {
+                if (!handle.get(0)) return;
+                filtered = false;
+            }
+        }
+
+        // if every point would compute the same result, the program is run for the first
+        // point only and its results written to the uniform arrays
+
+        const bool uniform = !filtered && mPointInvariant && count > 0 && this->isUniform(leaf);
+
+        args.reset(leaf.attributeSet(), mLeafLocalData[idx], mAttributeCount, mGroups.size());
 
         // add attributes based on the order and existence in the attribute registry
         // except for position, P, which is handled specially
 
         for (const auto& iter : mAttributeRegistry.attributeData()) {
-            if(iter.mName != "P") addAttributeHandle(args, leaf, iter.mName, iter.mType, iter.mWriteable);
+            if(iter.mName != "P") {
+                addAttributeHandle(args, leaf, iter.mName, iter.mType, iter.mWriteable,
+                    /*expand*/!uniform);
+            }
         }
 
-        const auto& map = leaf.attributeSet().descriptor().groupMap();
+        // add the groups named by the program in the order of the registry. Arrays
+        // holding groups which are edited are expanded so that their bits can be set
+        // directly, and are compacted once the leaf has been executed
 
-        if (!map.empty()) {
+        for (const size_t pos : mGroupArrays) leaf.attributeArray(pos).expand();
 
-            // add all groups based on their offset within the attribute set - the offset can
-            // then be used as a key when retrieving groups from the linearized array, which
-            // is provided by the attribute set argument
-
-            std::map<size_t, std::string> orderedGroups;
-            for (const auto& iter : map) {
-                orderedGroups[iter.second] = iter.first;
+        for (const GroupBinding& group : mGroups) {
+            if (group.mArray == openvdb::points::AttributeSet::INVALID_POS) {
+                args.addNullGroupHandle();
+            }
+            else if (group.mWriteable) {
+                args.addGroupWriteHandle(leaf.attributeArray(group.mArray), group.mOffset);
             }
+            else {
+                args.addGroupHandle(leaf.constAttributeArray(group.mArray), group.mOffset);
+            }
+        }
 
-            // add a handle at every offset up to and including the max offset. If the
-            // offset is not in use, we just use a null pointer as this will never be
-            // accessed
+        // if we are using position we need to initialise the local storage
 
-            const size_t maxOffset = orderedGroups.crbegin()->first;
-            auto iter = orderedGroups.begin();
+        if (UseTransform) args.mLeafLocalData->initPositions(leaf, mTransform, args.arena());
 
-            for (size_t i = 0; i <= maxOffset; ++i) {
-                if (iter->first == i) {
-                    args.addGroupWriteHandle(leaf, iter->second);
-                    ++iter;
-                }
-                else {
-                    args.addNullGroupHandle(); // empty handle at this index
-                }
-            }
+        const uint8_t* groupData = nullptr;
+        if (filtered && mGroupRangeFunction) {
+            groupData = codegen::ComputePointGroupRangeFunction::groupData
+                (leaf.constAttributeArray(mGroupIndex->first));
         }
 
-        // if we are using position we need to initialise the local storage
+        if (groupData) {
+            // scan the group bits in the compiled kernel
+            args.mIndex = count;
+            args.call(mGroupRangeFunction, groupData, uint8_t(1 << mGroupIndex->second));
+        }
+        else if (filtered) {
+            using IndexIterT = openvdb::points::IndexIter<LeafNode::ValueAllCIter, GroupFilter>;
 
-        if (UseTransform && UseGroup) {
             GroupFilter filter(*mGroupIndex);
-            args.mLeafLocalData->initPositions<GroupFilter>(leaf, mTransform, filter);
+            IndexIterT iter = leaf.beginIndex<LeafNode::ValueAllCIter, GroupFilter>(filter);
+
+            for (; iter; ++iter) {
+                args.mIndex = *iter;
+                args.call(mComputeFunction);
+            }
+        }
+        else if (count > 0) {
+            // the Compute function performs unsigned integer arithmetic and will wrap
+            // if count <= 0 inside ComputeGenerator::genComputeFunction()
+
+            args.mIndex = uniform ? 1 : count;
+            args.call(mRangeFunction);
         }
-        else if (UseTransform) args.mLeafLocalData->initPositions(leaf, mTransform);
 
-        execute<UseGroup>(leaf, args);
+        args.flush();
+        if (UseTransform) args.mLeafLocalData->releasePositions();
 
         // as multiple groups can be stored in a single array, attempt to compact the
         // arrays directly so that we're not trying to call compact multiple times
         // unsuccessfully
 
+        for (const size_t pos : mGroupArrays) leaf.attributeArray(pos).compact();
         args.mLeafLocalData->compact();
 
-        mLeafLocalData[idx] = std::move(args.mLeafLocalData);
+        // deleted points are removed while the leaf is still hot, rather than in a
+        // separate pass over the grid. The handles of the leaf are released first as
+        // its arrays are replaced
+
+        if (args.mLeafLocalData->hasDeletedPoints()) {
+            args.release();
+            args.mLeafLocalData->removeDeletedPoints(leaf);
+        }
     }
 
+    /// @brief  Executes each leaf of a range with the arena of the executing thread,
+    ///         so that the per leaf state is not allocated once the arena has grown
     void operator()(const LeafManagerT::LeafRange& range) const
     {
+        ThreadLeafArena arena;
+        codegen::ComputePointFunction::Arguments args(mCustomData, arena.get());
+        args.setStrings(mStrings.mStrings.data(), mStrings.mLiterals.data());
         for (auto leaf = range.begin(); leaf; ++leaf) {
-            (*this)(*leaf, leaf.pos());
+            (*this)(args, *leaf, leaf.pos());
         }
     }
 
 private:
 
     FunctionT                       mComputeFunction;
+    RangeFunctionT                  mRangeFunction;
+    GroupRangeFunctionT             mGroupRangeFunction;
+    const bool                      mPointInvariant;
     const CustomData&               mCustomData;
     const math::Transform&          mTransform;
     const GroupIndex* const         mGroupIndex;
     const AttributeRegistry&        mAttributeRegistry;
-    std::vector<codegen::LeafLocalData::UniquePtr>& mLeafLocalData;
+    size_t                          mAttributeCount;
+    const std::vector<GroupBinding>& mGroups;
+    const std::vector<size_t>&      mGroupArrays;
+    const StringTable&              mStrings;
+    std::vector<codegen::LeafLocalData>& mLeafLocalData;
 };
 
 void appendMissingAttributes(openvdb::points::PointDataGrid& grid,
@@ -297,168 +510,609 @@ void appendMissingAttributes(openvdb::points::PointDataGrid& grid,
     }
 }
 
-} // anonymous namespace
-
-uint64_t PointExecutable::functionAddress(const std::string &name) const
+/// @brief  Copies the membership of the new groups held by an array of a leaf from
+///         the groups created by the executed code in the leaf's local data
+/// @param  array     The leaf's array which holds the new groups
+/// @param  groups    The names of the new groups held by the array, and their offsets
+/// @param  data      The local data of the leaf
+/// @param  appended  Whether the array was appended for the new groups, in which case
+///                   none of its points are in a group
+void copyNewGroups(openvdb::points::GroupAttributeArray& array,
+                   const std::vector<std::pair<std::string, openvdb::points::GroupType>>& groups,
+                   const codegen::LeafLocalData& data,
+                   const bool appended)
 {
-    auto iter = mFunctionAddresses.find(name);
-    if (iter == mFunctionAddresses.end())   return 0;
-    return iter->second;
+    using GroupArrayT = openvdb::points::GroupAttributeArray;
+    using GroupType = openvdb::points::GroupType;
+
+    // the bits of each new group are moved from the array the leaf created them in.
+    // Every leaf generally creates its groups in the same order, so most are held at
+    // the same offset in both arrays and are copied together with a mask
+
+    struct Source
+    {
+        const GroupArrayT* mArray;
+        GroupType mMask;
+        std::vector<std::pair<GroupType, GroupType>> mShifted;
+    };
+
+    std::vector<Source> sources;
+    GroupType clear = 0;
+
+    for (const auto& group : groups) {
+        clear = GroupType(clear | (1 << group.second));
+
+        GroupType offset;
+        const GroupArrayT* source = data.getArray(group.first, offset);
+        if (!source) continue;
+
+        auto iter = std::find_if(sources.begin(), sources.end(),
+            [&](const Source& s) { return s.mArray == source; });
+        if (iter == sources.end()) {
+            sources.push_back({ source, 0, {} });
+            iter = sources.end() - 1;
+        }
+
+        if (offset == group.second) iter->mMask = GroupType(iter->mMask | (1 << offset));
+        else iter->mShifted.emplace_back(offset, group.second);
+    }
+
+    // appended arrays are uniformly zero, so only need to be touched if the leaf has
+    // created one of their groups
+
+    if (appended && sources.empty()) return;
+
+    // uniform sources are folded into a single value set for every point
+
+    GroupType uniform = 0;
+    bool isUniform = array.isUniform();
+
+    for (const Source& source : sources) {
+        if (!source.mArray->isUniform()) {
+            isUniform = false;
+            continue;
+        }
+        const GroupType value = source.mArray->get(0);
+        uniform = GroupType(uniform | (value & source.mMask));
+        for (const auto& shifted : source.mShifted) {
+            uniform = GroupType(uniform | (((value >> shifted.first) & 1) << shifted.second));
+        }
+    }
+
+    if (isUniform) {
+        array.collapse(GroupType((array.get(0) & ~clear) | uniform));
+        return;
+    }
+
+    array.expand();
+    GroupType* values = const_cast<GroupType*>(codegen::groupArrayData(array));
+
+    if (!values) {
+        // fall back to setting each point through handles if the array's values can
+        // not be accessed directly
+        for (const auto& group : groups) {
+            openvdb::points::GroupWriteHandle handle(array, group.second);
+            GroupType offset;
+            const GroupArrayT* source = data.getArray(group.first, offset);
+            if (!source) {
+                handle.collapse(false);
+                continue;
+            }
+            const openvdb::points::GroupHandle sourceHandle(*source, offset);
+            if (sourceHandle.isUniform()) {
+                handle.collapse(sourceHandle.get(0));
+                continue;
+            }
+            for (Index i = 0; i < array.size(); ++i) handle.set(i, sourceHandle.get(i));
+        }
+        array.compact();
+        return;
+    }
+
+    const Index size = array.size();
+    const GroupType keep = GroupType(~clear);
+
+    for (Index i = 0; i < size; ++i) values[i] = GroupType((values[i] & keep) | uniform);
+
+    for (const Source& source : sources) {
+        const GroupType* const sourceValues = codegen::groupArrayData(*source.mArray);
+        if (!sourceValues) continue;
+        if (source.mMask) {
+            const GroupType mask = source.mMask;
+            for (Index i = 0; i < size; ++i) {
+                values[i] = GroupType(values[i] | (sourceValues[i] & mask));
+            }
+        }
+        for (const auto& shifted : source.mShifted) {
+            for (Index i = 0; i < size; ++i) {
+                values[i] = GroupType(values[i] |
+                    (((sourceValues[i] >> shifted.first) & 1) << shifted.second));
+            }
+        }
+    }
+
+    array.compact();
 }
 
-void PointExecutable::execute(openvdb::points::PointDataGrid& grid,
-                              const std::string* const group) const
+/// @brief  Appends the groups created by the executed code to a tree and copies their
+///         membership from the local data of each leaf. The groups take the unused
+///         offsets of the existing group arrays before any new arrays are appended. All
+///         groups are added with a single change of the descriptor and the leaves are
+///         traversed once
+/// @param  leafManager    The leaf manager of the tree to append the groups to
+/// @param  groups         The names of the new groups
+/// @param  leafLocalData  The local data of each leaf in the order of the leaf manager
+void appendNewGroups(openvdb::tree::LeafManager<openvdb::points::PointDataTree>& leafManager,
+                     const std::vector<std::string>& groups,
+                     const std::vector<codegen::LeafLocalData>& leafLocalData)
 {
+    using Descriptor = openvdb::points::AttributeSet::Descriptor;
+    using GroupArrayT = openvdb::points::GroupAttributeArray;
+    using GroupType = openvdb::points::GroupType;
     using LeafManagerT = openvdb::tree::LeafManager<openvdb::points::PointDataTree>;
 
-    const auto leafIter = grid.tree().cbeginLeaf();
-    if (!leafIter) return;
+    const auto leafIter = leafManager.tree().cbeginLeaf();
+    if (!leafIter || groups.empty()) return;
 
-    // create any missing attributes
+    static const size_t bits = openvdb::points::point_group_internal::GroupInfo::groupBits();
 
-    appendMissingAttributes(grid, mAttributeRegistry->attributeData());
+    // group offsets index into the group arrays in the order of their positions
 
-    const bool usingPosition = mAttributeRegistry->isAttributeRegistered("P");
-    const bool usingGroup(static_cast<bool>(group) ? !group->empty() : false);
-    const math::Transform& transform = grid.transform();
+    const Descriptor::Ptr descriptor = leafIter->attributeSet().descriptorPtr();
 
-    openvdb::points::AttributeSet::Descriptor::GroupIndex groupIndex;
-    if (usingGroup) {
-        groupIndex = leafIter->attributeSet().groupIndex(*group);
+    std::vector<size_t> positions;
+    for (size_t pos = 0; pos < descriptor->size(); ++pos) {
+        if (descriptor->type(pos) == GroupArrayT::attributeType()) positions.push_back(pos);
     }
 
-    LeafManagerT leafManager(grid.tree());
+    const size_t existing = positions.size();
 
-    std::vector<codegen::LeafLocalData::UniquePtr> leafLocalData(leafManager.leafCount());
-    if (!usingGroup) {
+    std::vector<bool> used(existing * bits, false);
+    for (const auto& iter : descriptor->groupMap()) used[iter.second] = true;
 
-        using FunctionType = codegen::ComputePointRangeFunction;
+    std::vector<size_t> offsets;
+    for (size_t offset = 0; offset < used.size() && offsets.size() < groups.size(); ++offset) {
+        if (!used[offset]) offsets.push_back(offset);
+    }
 
-        uint64_t function = functionAddress(FunctionType::Name);
-        if (function == 0) OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
+    // append as many arrays as are required by the remaining groups. Each array is
+    // appended to a descriptor of its own, which the leaves move through in order
 
-        FunctionType::SignaturePtr compute = reinterpret_cast<FunctionType::SignaturePtr>(function);
-        if (!compute) {
-            OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
-        }
+    std::vector<Descriptor::Ptr> descriptors { descriptor };
 
-        if(!usingPosition) {
-            PointExecuterOp</*UseTransform*/false, /*UseGroup*/false>
-                executerOp(*mAttributeRegistry, *mCustomData, compute, transform, &groupIndex,
-                    leafLocalData);
-            leafManager.foreach(executerOp);
-        }
-        else {
-            PointExecuterOp</*UseTransform*/true, /*UseGroup*/false>
-                executerOp(*mAttributeRegistry, *mCustomData, compute, transform, &groupIndex,
-                    leafLocalData);
-            leafManager.foreach(executerOp);
+    for (size_t offset = used.size(); offsets.size() < groups.size(); ++offset) {
+        if (offset % bits == 0) {
+            const Descriptor::Ptr& previous = descriptors.back();
+            const Name name = previous->uniqueName("__group");
+            descriptors.emplace_back(previous->duplicateAppend(name, GroupArrayT::attributeType()));
+            positions.push_back(descriptors.back()->find(name));
         }
+        offsets.push_back(offset);
     }
-    else {
 
-        using FunctionType = codegen::ComputePointFunction;
+    // a new descriptor is always created, as the descriptor may be shared
+
+    if (descriptors.size() == 1) {
+        descriptors.emplace_back(std::make_shared<Descriptor>(*descriptor));
+    }
+
+    Descriptor::Ptr replacement = descriptors.back();
+
+    // the new groups held by each array
+
+    std::map<size_t, std::vector<std::pair<std::string, GroupType>>> arrays;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        replacement->setGroup(groups[i], offsets[i]);
+        arrays[positions[offsets[i] / bits]].emplace_back(groups[i], GroupType(offsets[i] % bits));
+    }
+
+    leafManager.foreach(
+        [&](LeafManagerT::LeafNodeType& leaf, size_t idx) {
+            if (positions.size() == existing) {
+                leaf.resetDescriptor(replacement);
+            }
+            else {
+                for (size_t i = existing; i < positions.size(); ++i) {
+                    const size_t n = i - existing;
+                    leaf.appendAttribute(*descriptors[n], descriptors[n + 1], positions[i]);
+                }
+            }
+
+            const codegen::LeafLocalData& data = leafLocalData[idx];
+            for (const auto& iter : arrays) {
+                copyNewGroups(GroupArrayT::cast(leaf.attributeArray(iter.first)),
+                    iter.second, data, /*appended*/iter.first >= descriptor->size());
+            }
+        });
+}
+
+/// @brief  Sets the strings written by the executed code. The unique strings of every
+///         leaf are merged in parallel and added to the metadata once, after which the
+///         metadata index of each written string is set in parallel
+/// @param  leafManager    The leaf manager of the tree the strings were written to
+/// @param  metadata       The metadata of the descriptor shared by the leaves
+/// @param  leafLocalData  The local data of each leaf in the order of the leaf manager
+void setNewStrings(openvdb::tree::LeafManager<openvdb::points::PointDataTree>& leafManager,
+                   MetaMap& metadata,
+                   const std::vector<codegen::LeafLocalData>& leafLocalData)
+{
+    using LeafManagerT = openvdb::tree::LeafManager<openvdb::points::PointDataTree>;
+    using StringSet = std::set<std::string>;
+
+    const bool newStrings = std::any_of(leafLocalData.begin(), leafLocalData.end(),
+        [](const codegen::LeafLocalData& data) { return data.hasNewStrings(); });
+    if (!newStrings) return;
+
+    const StringSet strings = tbb::parallel_reduce(leafManager.leafRange(), StringSet(),
+        [&leafLocalData](const LeafManagerT::LeafRange& range, StringSet local) -> StringSet {
+            for (auto leaf = range.begin(); leaf; ++leaf) {
+                leafLocalData[leaf.pos()].getNewStrings(local);
+            }
+            return local;
+        },
+        [](StringSet lhs, const StringSet& rhs) -> StringSet {
+            lhs.insert(rhs.begin(), rhs.end());
+            return lhs;
+        });
+
+    {
+        points::StringMetaInserter inserter(metadata);
+        for (const std::string& string : strings) inserter.insert(string);
+    }
+
+    // string attributes hold one plus the index of the metadata entry "string:<index>"
+
+    codegen::LeafLocalData::StringIndexMap indices;
+    indices.reserve(strings.size());
+    for (auto iter = metadata.beginMeta(); iter != metadata.endMeta(); ++iter) {
+        if (iter->first.compare(0, 7, "string:") != 0) continue;
+        const StringMetadata* const meta = dynamic_cast<StringMetadata*>(iter->second.get());
+        if (!meta || strings.find(meta->value()) == strings.end()) continue;
+        indices[meta->value()] = 1 + Index(std::stoi(iter->first.substr(7)));
+    }
+
+    leafManager.foreach(
+        [&leafLocalData, &indices] (LeafManagerT::LeafNodeType&, size_t idx) {
+            leafLocalData[idx].writeNewStrings(indices);
+        });
+}
+
+/// @brief  The state of a grid being executed. Everything which is resolved from the
+///         descriptor shared by the leaves of the grid is created before any leaf is
+///         executed, and the data created by the executed code is applied by finish
+struct PointGridState
+{
+    using LeafManagerT = openvdb::tree::LeafManager<openvdb::points::PointDataTree>;
+    using GroupIndex = openvdb::points::AttributeSet::Descriptor::GroupIndex;
+
+    /// @param  grid      The grid to execute, which must contain a leaf
+    /// @param  registry  The registry of the executable
+    /// @param  group     The name of the filter group, or a nullptr if not filtered
+    PointGridState(openvdb::points::PointDataGrid& grid,
+                   const AttributeRegistry& registry,
+                   const std::string* const group)
+        : mGrid(grid)
+        , mLeafManager()
+        , mLeafLocalData()
+        , mGroupIndex()
+        , mGroupBindings()
+        , mGroupArrays()
+        , mStrings()
+    {
+        const auto leafIter = grid.tree().cbeginLeaf();
+        assert(leafIter);
 
-        uint64_t function = functionAddress(FunctionType::Name);
-        if (function == 0) OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
+        // create any missing attributes
 
-        FunctionType::SignaturePtr compute = reinterpret_cast<FunctionType::SignaturePtr>(function);
-        if (!compute) {
-            OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
+        appendMissingAttributes(grid, registry.attributeData());
+
+        if (group && !group->empty()) {
+            mGroupIndex = leafIter->attributeSet().groupIndex(*group);
         }
 
-        if (!usingPosition && usingGroup) {
-            PointExecuterOp</*UseTransform*/false, /*UseGroup*/true>
-                executerOp(*mAttributeRegistry, *mCustomData, compute, transform, &groupIndex,
-                    leafLocalData);
-            leafManager.foreach(executerOp);
+        mLeafManager.reset(new LeafManagerT(grid.tree()));
+
+        // the local data of every leaf is created up front, rather than by each leaf
+
+        mLeafLocalData.reserve(mLeafManager->leafCount());
+        for (size_t i = 0; i < mLeafManager->leafCount(); ++i) {
+            mLeafLocalData.emplace_back(mLeafManager->leaf(i).getLastValue());
         }
-        else {
-            // usingGroup && usingPosition
-            PointExecuterOp</*UseTransform*/true, /*UseGroup*/true>
-                executerOp(*mAttributeRegistry, *mCustomData, compute, transform, &groupIndex,
-                    leafLocalData);
-            leafManager.foreach(executerOp);
+
+        // resolve the groups named by the program against the descriptor shared by the
+        // leaves. Every group array is edited if groups are edited through names which
+        // are only known at runtime
+
+        const openvdb::points::AttributeSet& attributeSet = leafIter->attributeSet();
+
+        std::set<size_t> writeArrays;
+
+        for (const auto& iter : registry.groupData()) {
+            const size_t offset = attributeSet.groupOffset(iter.mName);
+            if (offset == openvdb::points::AttributeSet::INVALID_POS) {
+                mGroupBindings.push_back({ offset, 0, iter.mWriteable });
+                continue;
+            }
+            const GroupIndex index = attributeSet.groupIndex(offset);
+            mGroupBindings.push_back({ index.first, index.second, iter.mWriteable });
+            if (iter.mWriteable) writeArrays.insert(index.first);
+        }
+
+        if (registry.dynamicGroupWrites()) {
+            for (const auto& iter : attributeSet.descriptor().groupMap()) {
+                writeArrays.insert(attributeSet.groupIndex(iter.second).first);
+            }
         }
+
+        mGroupArrays.assign(writeArrays.begin(), writeArrays.end());
+
+        // string attributes are read through the metadata of the shared descriptor,
+        // which is not edited until every leaf has been executed
+
+        mStrings.reset(new StringTable(attributeSet.descriptor().getMetadata(),
+            registry.stringData()));
     }
 
-    // Check to see if any new data has been added and apply it accordingly
+    /// @brief  Returns the executer of the leaves of this grid
+    template <bool UseTransform, bool UseGroup>
+    PointExecuterOp<UseTransform, UseGroup>
+    executer(const AttributeRegistry& registry,
+             const CustomData& customData,
+             const PointKernels& kernels,
+             const bool pointInvariant)
+    {
+        return PointExecuterOp<UseTransform, UseGroup>(registry, customData,
+            kernels.mCompute, kernels.mRange, kernels.mGroupRange, pointInvariant,
+            mGrid.transform(), &mGroupIndex, mGroupBindings, mGroupArrays, *mStrings,
+            mLeafLocalData);
+    }
 
-    std::set<std::string> groups;
-    bool newStrings = false;
+    /// @brief  Sets the strings written by the executed code. This edits the metadata
+    ///         of the descriptor, which may be shared with other grids
+    void setStrings()
+    {
+        setNewStrings(*mLeafManager,
+            mGrid.tree().cbeginLeaf()->attributeSet().descriptorPtr()->getMetadata(),
+            mLeafLocalData);
+    }
 
+    /// @brief  Applies the groups, positions and deletions of the executed code.
+    ///         Returns the number of points written into a different voxel
+    size_t finish(const AttributeRegistry& registry)
     {
-        points::StringMetaInserter
-            inserter(leafIter->attributeSet().descriptorPtr()->getMetadata());
-        for (const auto& data : leafLocalData) {
-            data->getGroups(groups);
-            newStrings |= data->insertNewStrings(inserter);
+        // append newly created groups and copy over their membership
+
+        std::vector<std::string> groups;
+        for (const auto& data : mLeafLocalData) data.getGroups(groups);
+
+        appendNewGroups(*mLeafManager, groups, mLeafLocalData);
+
+        // points which remain in their voxel have their offsets updated in place, so
+        // only points which cross into another voxel are moved
+
+        size_t moved = 0;
+
+        if (registry.isAttributeWritable("P")) {
+            const math::Transform& transform = mGrid.transform();
+            std::vector<codegen::LeafLocalData>& leafLocalData = mLeafLocalData;
+
+            moved = tbb::parallel_reduce(mLeafManager->leafRange(), size_t(0),
+                [&leafLocalData, &transform]
+                (const LeafManagerT::LeafRange& range, size_t count) -> size_t {
+                    for (auto leaf = range.begin(); leaf; ++leaf) {
+                        count += leafLocalData[leaf.pos()].updatePositions(*leaf, transform);
+                    }
+                    return count;
+                },
+                std::plus<size_t>());
+
+            if (moved > 0) {
+                PointExecuterDeformer deformer(mLeafLocalData);
+                openvdb::points::movePoints(mGrid, deformer);
+            }
         }
-    }
 
-    // append and copy over newly created groups
-    // @todo  We should just be able to steal the arrays and compact
-    // groups but the API for this isn't very nice at the moment
+        // leaves from which every point has been deleted are removed
+
+        const bool deleted = std::any_of(mLeafLocalData.begin(), mLeafLocalData.end(),
+            [](const codegen::LeafLocalData& data) { return data.deletedPoints() > 0; });
+        if (deleted) openvdb::tools::pruneInactive(mGrid.tree());
 
-    for (const auto& name : groups) {
-        points::appendGroup(grid.tree(), name);
+        return moved;
     }
 
-    // add new groups and set strings
+    openvdb::points::PointDataGrid& mGrid;
+    std::unique_ptr<LeafManagerT> mLeafManager;
+    std::vector<codegen::LeafLocalData> mLeafLocalData;
+    GroupIndex mGroupIndex;
+    std::vector<GroupBinding> mGroupBindings;
+    std::vector<size_t> mGroupArrays;
+    std::unique_ptr<StringTable> mStrings;
+};
 
-    leafManager.foreach(
-        [&groups, &leafLocalData, newStrings] (LeafManagerT::LeafNodeType& leaf, size_t idx) {
+/// @brief  Executes the leaves of many grids in a single parallel loop, so that threads
+///         are not left idle at the end of each grid. The leaves of the grids are
+///         indexed in order, and each range of this index is split at the boundaries of
+///         the grids it spans
+template <bool UseTransform, bool UseGroup>
+void executeLeaves(std::vector<std::unique_ptr<PointGridState>>& states,
+                   const AttributeRegistry& registry,
+                   const CustomData& customData,
+                   const PointKernels& kernels,
+                   const bool pointInvariant)
+{
+    using ExecuterT = PointExecuterOp<UseTransform, UseGroup>;
+    using LeafRangeT = PointGridState::LeafManagerT::LeafRange;
 
-            codegen::LeafLocalData::UniquePtr& data = leafLocalData[idx];
+    std::vector<ExecuterT> executers;
+    executers.reserve(states.size());
 
-            for (const auto& name : groups) {
+    std::vector<size_t> offsets { 0 };
+    offsets.reserve(states.size() + 1);
 
-                // Attempt to get the group handle out of the leaf local data form this
-                // leaf. This may not exist as although all of the unique set are appended
-                // to the tree (above), not every leaf may have been directly touched
-                // by every new group. Some leaf nodes may not require any bit mask copying
+    for (auto& state : states) {
+        executers.emplace_back(state->executer<UseTransform, UseGroup>
+            (registry, customData, kernels, pointInvariant));
+        offsets.emplace_back(offsets.back() + state->mLeafManager->leafCount());
+    }
 
-                points::GroupWriteHandle* tmpHandle = data->get(name);
-                if (!tmpHandle) continue;
+    if (states.size() == 1) {
+        tbb::parallel_for(states.front()->mLeafManager->leafRange(), executers.front());
+        return;
+    }
 
-                points::GroupWriteHandle handle = leaf.groupWriteHandle(name);
-                if (tmpHandle->isUniform()) {
-                    handle.collapse(tmpHandle->get(0));
-                }
-                else {
-                    const size_t size = tmpHandle->size();
-                    for (size_t i = 0; i < size; ++i) {
-                        handle.set(i, tmpHandle->get(i));
-                    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, offsets.back()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            size_t i = std::upper_bound(offsets.begin(), offsets.end(), range.begin()) -
+                offsets.begin() - 1;
+            for (size_t begin = range.begin(); begin < range.end(); ++i) {
+                const size_t end = std::min(range.end(), offsets[i + 1]);
+                if (end > begin) {
+                    executers[i](LeafRangeT(begin - offsets[i], end - offsets[i],
+                        *states[i]->mLeafManager));
                 }
+                begin = end;
             }
+        });
+}
+
+/// @brief  Executes a set of grids which each contain a leaf, returning the number of
+///         points moved within each
+std::vector<size_t>
+executeGrids(std::vector<std::unique_ptr<PointGridState>>& states,
+             const AttributeRegistry& registry,
+             const CustomData& customData,
+             const PointKernels& kernels,
+             const bool pointInvariant,
+             const bool usingGroup)
+{
+    const bool usingPosition = registry.isAttributeRegistered("P");
 
-            if (newStrings) {
-                const MetaMap& metadata = leaf.attributeSet().descriptor().getMetadata();
-                const codegen::LeafLocalData::StringArrayMap& stringArrayMap = data->getStringArrayMap();
+    if (!usingPosition && !usingGroup) {
+        executeLeaves</*UseTransform*/false, /*UseGroup*/false>
+            (states, registry, customData, kernels, pointInvariant);
+    }
+    else if (!usingGroup) {
+        executeLeaves</*UseTransform*/true, /*UseGroup*/false>
+            (states, registry, customData, kernels, pointInvariant);
+    }
+    else if (!usingPosition) {
+        executeLeaves</*UseTransform*/false, /*UseGroup*/true>
+            (states, registry, customData, kernels, pointInvariant);
+    }
+    else {
+        // usingGroup && usingPosition
+        executeLeaves</*UseTransform*/true, /*UseGroup*/true>
+            (states, registry, customData, kernels, pointInvariant);
+    }
 
-                for (const auto& arrayIter : stringArrayMap) {
-                    points::StringAttributeWriteHandle::Ptr handle =
-                        points::StringAttributeWriteHandle::create(*(arrayIter.first), metadata);
+    // strings are set one grid at a time, as grids may share the metadata of their
+    // descriptors. The remaining data of each grid is applied concurrently
 
-                    for (const auto& iter : arrayIter.second) {
-                        handle->set(iter.first, iter.second);
-                    }
-                }
+    for (auto& state : states) state->setStrings();
+
+    std::vector<size_t> moved(states.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, states.size(), 1),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+                moved[i] = states[i]->finish(registry);
             }
-    });
+        });
 
-    if (mAttributeRegistry->isAttributeWritable("P")) {
-        if (usingGroup) {
-            openvdb::points::GroupFilter filter(groupIndex);
-            PointExecuterDeformer<openvdb::points::GroupFilter> deformer(leafLocalData, filter);
-            openvdb::points::movePoints(grid, deformer);
-        }
-        else {
-            openvdb::points::NullFilter nullFilter;
-            PointExecuterDeformer<openvdb::points::NullFilter> deformer(leafLocalData, nullFilter);
-            openvdb::points::movePoints(grid, deformer);
-        }
+    return moved;
+}
+
+} // anonymous namespace
+
+uint64_t PointExecutable::functionAddress(const std::string &name) const
+{
+    auto iter = mFunctionAddresses.find(name);
+    if (iter == mFunctionAddresses.end())   return 0;
+    return iter->second;
+}
+
+void PointExecutable::upgrade(const std::shared_ptr<const PointExecutable>& executable)
+{
+    std::atomic_store(&mUpgraded, executable);
+}
+
+bool PointExecutable::isUpgraded() const
+{
+    return static_cast<bool>(std::atomic_load(&mUpgraded));
+}
+
+void PointExecutable::execute(openvdb::points::PointDataGrid& grid,
+                              const std::string* const group,
+                              size_t* const movedPoints) const
+{
+    // the upgraded executable is kept alive for the duration of the call
+
+    const std::shared_ptr<const PointExecutable> upgraded = std::atomic_load(&mUpgraded);
+    if (upgraded) {
+        upgraded->execute(grid, group, movedPoints);
+        return;
+    }
+
+    if (movedPoints) *movedPoints = 0;
+
+    if (!grid.tree().cbeginLeaf()) return;
+
+    const PointKernels kernels = pointKernels(
+        functionAddress(codegen::ComputePointFunction::Name),
+        functionAddress(codegen::ComputePointRangeFunction::Name),
+        functionAddress(codegen::ComputePointGroupRangeFunction::Name));
+
+    std::vector<std::unique_ptr<PointGridState>> states;
+    states.emplace_back(new PointGridState(grid, *mAttributeRegistry, group));
+
+    const bool usingGroup(static_cast<bool>(group) ? !group->empty() : false);
+
+    const std::vector<size_t> moved = executeGrids(states, *mAttributeRegistry,
+        *mCustomData, kernels, mPointInvariant, usingGroup);
+
+    if (movedPoints) *movedPoints = moved.front();
+}
+
+void PointExecutable::execute(std::vector<points::PointDataGrid::Ptr>& grids,
+                              const std::string* const group,
+                              std::vector<size_t>* const movedPoints) const
+{
+    // the upgraded executable is kept alive for the duration of the call
+
+    const std::shared_ptr<const PointExecutable> upgraded = std::atomic_load(&mUpgraded);
+    if (upgraded) {
+        upgraded->execute(grids, group, movedPoints);
+        return;
+    }
+
+    if (movedPoints) movedPoints->assign(grids.size(), 0);
+
+    // grids without leaves have nothing to execute
+
+    std::vector<std::unique_ptr<PointGridState>> states;
+    std::vector<size_t> indices;
+
+    for (size_t i = 0; i < grids.size(); ++i) {
+        assert(grids[i]);
+        if (!grids[i]->tree().cbeginLeaf()) continue;
+        states.emplace_back(new PointGridState(*grids[i], *mAttributeRegistry, group));
+        indices.emplace_back(i);
+    }
+
+    if (states.empty()) return;
+
+    const PointKernels kernels = pointKernels(
+        functionAddress(codegen::ComputePointFunction::Name),
+        functionAddress(codegen::ComputePointRangeFunction::Name),
+        functionAddress(codegen::ComputePointGroupRangeFunction::Name));
+
+    const bool usingGroup(static_cast<bool>(group) ? !group->empty() : false);
+
+    const std::vector<size_t> moved = executeGrids(states, *mAttributeRegistry,
+        *mCustomData, kernels, mPointInvariant, usingGroup);
+
+    if (movedPoints) {
+        for (size_t i = 0; i < indices.size(); ++i) (*movedPoints)[indices[i]] = moved[i];
     }
 }
 
@@ -58,6 +58,8 @@ namespace OPENVDB_VERSION_NAME {
 
 namespace ax {
 
+class SharedLibrary;
+
 
 /// @brief Object that encapsulates compiled AX code which can be executed on a target point grid
 class PointExecutable
@@ -75,27 +77,100 @@ public:
     ///        used to retrieve external data from within the AX code
     /// @param functions A map of function names to physical memory addresses which were built
     ///        by llvm using exeEngine
+    /// @param codeSize The number of bytes of code and data allocated by the JIT for this executable
+    /// @param pointInvariant Whether the code computes the same result for every point with the
+    ///        same attribute values. See codegen::PointComputeGenerator::isPointInvariant
     /// @note  This object is normally be constructed by the Compiler::compile method, rather
     ///        than directly
     PointExecutable(const std::shared_ptr<const llvm::ExecutionEngine>& exeEngine,
                     const std::shared_ptr<const llvm::LLVMContext>& context,
                     const Registry::ConstPtr& attributeRegistry,
                     const CustomData::Ptr& customData,
-                    const std::map<std::string, uint64_t>& functions)
+                    const std::map<std::string, uint64_t>& functions,
+                    const size_t codeSize = 0,
+                    const bool pointInvariant = false)
         : mExecutionEngine(exeEngine)
         , mContext(context)
         , mAttributeRegistry(attributeRegistry)
         , mCustomData(customData)
-        , mFunctionAddresses(functions) {}
+        , mFunctionAddresses(functions)
+        , mCodeSize(codeSize)
+        , mPointInvariant(pointInvariant)
+        , mLibrary()
+        , mUpgraded() {}
+
+    /// @brief Constructor for an executable loaded from an ahead of time compiled
+    ///        shared library
+    /// @param library The shared library holding the compiled code
+    /// @param attributeRegistry Registry of point attributes accessed by AX code
+    /// @param customData Custom data object which will be shared by this executable
+    /// @param functions A map of function names to their addresses in library
+    /// @param pointInvariant Whether the code computes the same result for every point with the
+    ///        same attribute values
+    /// @note  This object is normally constructed by loadExecutable
+    PointExecutable(const std::shared_ptr<const SharedLibrary>& library,
+                    const Registry::ConstPtr& attributeRegistry,
+                    const CustomData::Ptr& customData,
+                    const std::map<std::string, uint64_t>& functions,
+                    const bool pointInvariant = false)
+        : mExecutionEngine()
+        , mContext()
+        , mAttributeRegistry(attributeRegistry)
+        , mCustomData(customData)
+        , mFunctionAddresses(functions)
+        , mCodeSize(0)
+        , mPointInvariant(pointInvariant)
+        , mLibrary(library)
+        , mUpgraded() {}
 
     ~PointExecutable() = default;
 
+    /// @brief Replaces the code run by this executable with that of another executable
+    ///        compiled from the same program and custom data, such as a more optimised
+    ///        build. This is safe to call concurrently with execute - executions already
+    ///        in progress complete with the previous code.
+    /// @note  This is normally called by Compiler::compileTiered
+    void upgrade(const std::shared_ptr<const PointExecutable>& executable);
+
+    /// @brief Returns true if this executable has been upgraded
+    bool isUpgraded() const;
+
     /// @brief executes compiled AX code on target grid
+    /// @details Leaves are specialised at runtime. Leaves in which the filter group is
+    ///          uniformly off are skipped and leaves in which it is uniformly on are
+    ///          processed without per point filtering. If the code is point invariant and
+    ///          every attribute it accesses is uniform in a leaf, it is run for a single
+    ///          point and the attributes it writes are kept uniform.
     /// @param grid Grid to apply code to
     /// @param group Optional name of a group for filtering.  If this is not NULL,
     ///        the code will only be applied to points in this group
+    /// @param movedPoints Optional count of the points whose positions were written into
+    ///        a different voxel. Written positions which remain within their voxel are
+    ///        updated in place, and the points are only re-bucketed if this is non zero.
     void execute(points::PointDataGrid& grid,
-                 const std::string* const group = nullptr) const;
+                 const std::string* const group = nullptr,
+                 size_t* const movedPoints = nullptr) const;
+
+    /// @brief executes compiled AX code on many target grids
+    /// @details The leaves of every grid are executed in a single parallel loop, rather
+    ///          than one loop per grid, so that small grids do not leave threads idle.
+    ///          The data created by the code, such as new groups and moved points, is
+    ///          then applied to the grids concurrently. Each grid is executed as it would
+    ///          be by execute(grid, group), and the grids must be distinct.
+    /// @param grids Grids to apply code to
+    /// @param group Optional name of a group for filtering, applied to every grid
+    /// @param movedPoints Optional count of the points moved within each grid, see
+    ///        execute(grid, group, movedPoints)
+    void execute(std::vector<points::PointDataGrid::Ptr>& grids,
+                 const std::string* const group = nullptr,
+                 std::vector<size_t>* const movedPoints = nullptr) const;
+
+    /// @brief Returns the number of bytes of code and data allocated by the JIT
+    inline size_t codeSize() const { return mCodeSize; }
+
+    /// @brief Returns true if the code computes the same result for every point with the
+    ///        same attribute values
+    inline bool isPointInvariant() const { return mPointInvariant; }
 
 private:
 
@@ -111,6 +186,12 @@ private:
     const CustomData::Ptr mCustomData;
     // addresses of actual compiled code
     const std::map<std::string, uint64_t> mFunctionAddresses;
+    const size_t mCodeSize;
+    const bool mPointInvariant;
+    // exists only for object lifetime management
+    const std::shared_ptr<const SharedLibrary> mLibrary;
+    // execution is forwarded to this executable once set. Only accessed atomically
+    std::shared_ptr<const PointExecutable> mUpgraded;
 };
 
 }
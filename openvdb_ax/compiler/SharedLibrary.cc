@@ -0,0 +1,373 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "SharedLibrary.h"
+
+#include "PointExecutable.h"
+#include "VolumeExecutable.h"
+
+#include <openvdb_ax/codegen/FunctionRegistry.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/Exceptions.h>
+
+#include <dlfcn.h>
+
+#include <map>
+#include <sstream>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+namespace {
+
+const char* sManifestHeader = "openvdb_ax_manifest";
+const int sManifestVersion = 7;
+
+/// @brief  Writes a whitespace separated token, throwing if the token can not be
+///         read back
+inline void writeToken(std::ostream& os, const std::string& token)
+{
+    if (token.empty() || token.find_first_of(" \t\r\n") != std::string::npos) {
+        OPENVDB_THROW(AXCompilerError, "Unable to serialize \"" + token +
+            "\" into a shared library manifest.");
+    }
+    os << token << '\n';
+}
+
+inline std::string readToken(std::istream& is)
+{
+    std::string token;
+    if (!(is >> token)) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+    return token;
+}
+
+inline size_t readSize(std::istream& is)
+{
+    size_t size;
+    if (!(is >> size)) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+    return size;
+}
+
+/// @brief  Writes a length prefixed string which, unlike a token, may be empty or
+///         contain whitespace
+inline void writeString(std::ostream& os, const std::string& string)
+{
+    os << string.size() << ' ' << string << '\n';
+}
+
+inline std::string readString(std::istream& is)
+{
+    const size_t size = readSize(is);
+    std::string string(size, '\0');
+    if (is.get() != ' ' || !is.read(&string[0], size)) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+    return string;
+}
+
+/// @brief  Opens a library and binds its imported function pointers to the
+///         functions of a registry
+SharedLibrary::Ptr
+openLibrary(const std::string& path,
+            const std::string& executable,
+            SharedLibraryManifest& manifest,
+            const codegen::FunctionRegistry* functionRegistry)
+{
+    SharedLibrary::Ptr library = SharedLibrary::create(path);
+
+    const char* const data =
+        static_cast<const char*>(library->symbol(SharedLibraryManifest::Symbol));
+    if (!data) {
+        OPENVDB_THROW(AXCompilerError, "\"" + path + "\" is not an AX shared library.");
+    }
+
+    manifest = SharedLibraryManifest::deserialize(data);
+    if (manifest.mExecutable != executable) {
+        OPENVDB_THROW(AXCompilerError, "\"" + path + "\" contains a " +
+            manifest.mExecutable + " executable, not a " + executable + " executable.");
+    }
+
+    // gather the addresses of all external functions. The standard registry is
+    // used if none is provided
+
+    const FunctionOptions options;
+    codegen::FunctionRegistry::UniquePtr registry;
+    if (functionRegistry) registry.reset(new codegen::FunctionRegistry(*functionRegistry));
+    else                  registry = codegen::createStandardRegistry(options);
+    registry->createAll(options);
+
+    std::map<std::string, void*> addresses;
+    for (const auto& iter : registry->map()) {
+        const codegen::FunctionBase::Ptr function = iter.second.function();
+        if (!function) continue;
+
+        for (const codegen::FunctionSignatureBase::Ptr& signature : function->list()) {
+            if (signature->functionPointer()) {
+                addresses[signature->symbolName()] = signature->functionPointer();
+            }
+        }
+    }
+
+    for (const std::string& import : manifest.mImports) {
+        auto iter = addresses.find(import);
+        if (iter == addresses.end()) {
+            OPENVDB_THROW(AXCompilerError, "Unable to resolve function \"" + import +
+                "\" required by \"" + path + "\".");
+        }
+
+        void** pointer = static_cast<void**>
+            (library->symbol(SharedLibraryManifest::importSymbol(import)));
+        if (!pointer) {
+            OPENVDB_THROW(AXCompilerError, "Missing function import \"" + import +
+                "\" in \"" + path + "\".");
+        }
+        *pointer = iter->second;
+    }
+
+    return library;
+}
+
+/// @brief  Returns the addresses of the functions of a block
+std::map<std::string, uint64_t>
+blockFunctions(const SharedLibrary& library, const std::vector<std::string>& names)
+{
+    std::map<std::string, uint64_t> functions;
+    for (const std::string& name : names) {
+        void* address = library.symbol(name);
+        if (!address) {
+            OPENVDB_THROW(AXCompilerError, "Missing compute function \"" + name +
+                "\" in \"" + library.path() + "\".");
+        }
+        functions[name] = reinterpret_cast<uint64_t>(address);
+    }
+    return functions;
+}
+
+}
+
+const char* SharedLibraryManifest::Symbol = "ax_manifest";
+
+std::string SharedLibraryManifest::importSymbol(const std::string& symbol)
+{
+    return "ax_import." + symbol;
+}
+
+std::string SharedLibraryManifest::serialize() const
+{
+    std::ostringstream os;
+    os << sManifestHeader << ' ' << sManifestVersion << '\n';
+
+    writeToken(os, mExecutable);
+
+    os << mFunctions.size() << '\n';
+    for (const std::vector<std::string>& block : mFunctions) {
+        os << block.size() << '\n';
+        for (const std::string& name : block) writeToken(os, name);
+    }
+
+    os << mData.size() << '\n';
+    for (const Data& data : mData) {
+        writeToken(os, data.mName);
+        writeToken(os, data.mType);
+        os << data.mWriteable << '\n';
+    }
+
+    os << mGroups.size() << '\n';
+    for (const Group& group : mGroups) {
+        writeToken(os, group.mName);
+        os << group.mWriteable << '\n';
+    }
+    os << mDynamicGroupWrites << '\n';
+
+    os << mStrings.size() << '\n';
+    for (const std::string& string : mStrings) writeString(os, string);
+
+    os << mAssignedVolumes.size() << '\n';
+    for (const std::string& name : mAssignedVolumes) writeToken(os, name);
+    os << mSinglePass << '\n';
+    os << mPointInvariant << '\n';
+
+    os << mImports.size() << '\n';
+    for (const std::string& name : mImports) writeToken(os, name);
+
+    return os.str();
+}
+
+SharedLibraryManifest SharedLibraryManifest::deserialize(const std::string& manifest)
+{
+    std::istringstream is(manifest);
+
+    if (readToken(is) != sManifestHeader) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+    if (readSize(is) != size_t(sManifestVersion)) {
+        OPENVDB_THROW(AXCompilerError, "Unsupported shared library manifest version.");
+    }
+
+    SharedLibraryManifest result;
+    result.mExecutable = readToken(is);
+
+    result.mFunctions.resize(readSize(is));
+    for (std::vector<std::string>& block : result.mFunctions) {
+        block.resize(readSize(is));
+        for (std::string& name : block) name = readToken(is);
+    }
+
+    result.mData.resize(readSize(is));
+    for (Data& data : result.mData) {
+        data.mName = readToken(is);
+        data.mType = readToken(is);
+        data.mWriteable = readSize(is) != 0;
+    }
+
+    result.mGroups.resize(readSize(is));
+    for (Group& group : result.mGroups) {
+        group.mName = readToken(is);
+        group.mWriteable = readSize(is) != 0;
+    }
+    result.mDynamicGroupWrites = readSize(is) != 0;
+
+    result.mStrings.resize(readSize(is));
+    for (std::string& string : result.mStrings) string = readString(is);
+
+    result.mAssignedVolumes.resize(readSize(is));
+    for (std::string& name : result.mAssignedVolumes) name = readToken(is);
+    result.mSinglePass = readSize(is) != 0;
+    result.mPointInvariant = readSize(is) != 0;
+
+    result.mImports.resize(readSize(is));
+    for (std::string& name : result.mImports) name = readToken(is);
+
+    return result;
+}
+
+SharedLibrary::SharedLibrary(const std::string& path)
+    : mPath(path)
+    , mHandle(nullptr)
+{
+    // local binding so that symbols of different libraries never interpose
+    mHandle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!mHandle) {
+        const char* error = dlerror();
+        OPENVDB_THROW(AXCompilerError, "Unable to open shared library \"" + path + "\": " +
+            (error ? error : "unknown error"));
+    }
+}
+
+SharedLibrary::~SharedLibrary()
+{
+    if (mHandle) dlclose(mHandle);
+}
+
+SharedLibrary::Ptr SharedLibrary::create(const std::string& path)
+{
+    Ptr library(new SharedLibrary(path));
+    return library;
+}
+
+void* SharedLibrary::symbol(const std::string& name) const
+{
+    return dlsym(mHandle, name.c_str());
+}
+
+template<>
+PointExecutable::Ptr
+loadExecutable<PointExecutable>(const std::string& path,
+                                const CustomData::Ptr& data,
+                                const codegen::FunctionRegistry* functionRegistry)
+{
+    SharedLibraryManifest manifest;
+    const SharedLibrary::Ptr library = openLibrary(path, "point", manifest, functionRegistry);
+
+    if (manifest.mFunctions.size() != 1) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+
+    AttributeRegistry::Ptr registry(new AttributeRegistry);
+    for (const SharedLibraryManifest::Data& attribute : manifest.mData) {
+        registry->addData(attribute.mName, attribute.mType, attribute.mWriteable);
+    }
+    for (const SharedLibraryManifest::Group& group : manifest.mGroups) {
+        registry->addGroup(group.mName, group.mWriteable);
+    }
+    registry->setDynamicGroupWrites(manifest.mDynamicGroupWrites);
+    for (const std::string& string : manifest.mStrings) {
+        registry->addString(string);
+    }
+
+    PointExecutable::Ptr executable(new PointExecutable(library, registry, data,
+        blockFunctions(*library, manifest.mFunctions.front()), manifest.mPointInvariant));
+    return executable;
+}
+
+template<>
+VolumeExecutable::Ptr
+loadExecutable<VolumeExecutable>(const std::string& path,
+                                 const CustomData::Ptr& data,
+                                 const codegen::FunctionRegistry* functionRegistry)
+{
+    SharedLibraryManifest manifest;
+    const SharedLibrary::Ptr library = openLibrary(path, "volume", manifest, functionRegistry);
+
+    const size_t numBlocks =
+        manifest.mSinglePass ? size_t(1) : manifest.mAssignedVolumes.size();
+    if (manifest.mFunctions.size() < numBlocks) {
+        OPENVDB_THROW(AXCompilerError, "Invalid shared library manifest.");
+    }
+
+    VolumeRegistry::Ptr registry(new VolumeRegistry);
+    for (const SharedLibraryManifest::Data& volume : manifest.mData) {
+        registry->addData(volume.mName, volume.mType, volume.mWriteable);
+    }
+
+    std::vector<std::map<std::string, uint64_t>> functions;
+    for (size_t i = 0; i < numBlocks; ++i) {
+        functions.emplace_back(blockFunctions(*library, manifest.mFunctions[i]));
+    }
+
+    VolumeExecutable::Ptr executable(new VolumeExecutable(library, registry, data,
+        functions, manifest.mAssignedVolumes, manifest.mSinglePass));
+    return executable;
+}
+
+}
+}
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+/// @file compiler/SharedLibrary.h
+///
+/// @brief  Loading of AX programs which have been compiled ahead of time into shared
+///         libraries with Compiler::compileToSharedLibrary. Loading requires no llvm
+///         state - the library is opened and its functions bound to the executables
+///         directly.
+///
+
+#ifndef OPENVDB_AX_COMPILER_SHARED_LIBRARY_HAS_BEEN_INCLUDED
+#define OPENVDB_AX_COMPILER_SHARED_LIBRARY_HAS_BEEN_INCLUDED
+
+#include <openvdb_ax/compiler/CustomData.h>
+
+#include <openvdb/version.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openvdb {
+OPENVDB_USE_VERSION_NAMESPACE
+namespace OPENVDB_VERSION_NAME {
+
+namespace ax {
+
+namespace codegen {
+class FunctionRegistry;
+}
+
+/// @brief  The description of a compiled program which is embedded into a shared
+///         library alongside its code. It holds everything the executables would
+///         otherwise derive from the syntax tree.
+struct SharedLibraryManifest
+{
+    /// @brief  The symbol of the null terminated manifest string in the library
+    static const char* Symbol;
+
+    /// @brief  An attribute or volume registry entry
+    struct Data
+    {
+        std::string mName;
+        std::string mType;
+        bool mWriteable;
+    };
+
+    /// @brief  A group accessed by name by a point program
+    struct Group
+    {
+        std::string mName;
+        bool mWriteable;
+    };
+
+    /// @brief  The executable type, "point" or "volume"
+    std::string mExecutable;
+    /// @brief  The compute functions of each block. Point programs have a single block
+    std::vector<std::vector<std::string>> mFunctions;
+    /// @brief  The registry entries in index order
+    std::vector<Data> mData;
+    /// @brief  The groups named by a point program in registry order
+    std::vector<Group> mGroups;
+    /// @brief  Whether a point program edits groups whose names are only known at
+    ///         runtime. See AttributeRegistry::dynamicGroupWrites
+    bool mDynamicGroupWrites = false;
+    /// @brief  The string literals compared against string attributes in registry order
+    std::vector<std::string> mStrings;
+    /// @brief  The names of volumes written to by each block
+    std::vector<std::string> mAssignedVolumes;
+    /// @brief  Whether a volume program writes all of its assigned volumes from a
+    ///         single block. See CompilerOptions::singlePassVolumes
+    bool mSinglePass = false;
+    /// @brief  Whether a point program computes the same result for every point with the
+    ///         same attribute values. See PointExecutable::isPointInvariant
+    bool mPointInvariant = false;
+    /// @brief  The symbols of externally defined functions called by the program. Each
+    ///         is called through a pointer stored at the symbol importSymbol(symbol)
+    std::vector<std::string> mImports;
+
+    /// @brief  Returns the library symbol of the pointer used to call an imported function
+    static std::string importSymbol(const std::string& symbol);
+
+    std::string serialize() const;
+    static SharedLibraryManifest deserialize(const std::string& manifest);
+};
+
+/// @brief  An opened shared library. The library is closed on destruction, so must
+///         outlive any executables created from it.
+class SharedLibrary
+{
+public:
+    using Ptr = std::shared_ptr<SharedLibrary>;
+
+    /// @brief  Opens the library at a given path. Throws if it can not be opened
+    SharedLibrary(const std::string& path);
+    ~SharedLibrary();
+
+    SharedLibrary(const SharedLibrary&) = delete;
+    SharedLibrary& operator=(const SharedLibrary&) = delete;
+
+    static Ptr create(const std::string& path);
+
+    /// @brief  Returns the address of a symbol, or a nullptr if it does not exist
+    void* symbol(const std::string& name) const;
+
+    inline const std::string& path() const { return mPath; }
+
+private:
+    const std::string mPath;
+    void* mHandle;
+};
+
+/// @brief  Loads an executable from a shared library created with
+///         Compiler::compileToSharedLibrary for the same executable type
+/// @param path              The path to the shared library
+/// @param data              Custom data to be shared by the executable
+/// @param functionRegistry  The registry of the functions the library was compiled
+///                          with. The standard registry is used if not provided.
+template <typename ExecutableT>
+typename ExecutableT::Ptr
+loadExecutable(const std::string& path,
+               const CustomData::Ptr& data = CustomData::create(),
+               const codegen::FunctionRegistry* functionRegistry = nullptr);
+
+}
+}
+}
+
+#endif // OPENVDB_AX_COMPILER_SHARED_LIBRARY_HAS_BEEN_INCLUDED
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -81,8 +81,30 @@ public:
 
     using AttributeDataVec = std::vector<AttributeData>;
 
+    /// @brief  Registered group details, including its name and whether a write
+    ///         handle is required
+    ///
+    struct GroupData
+    {
+        /// @brief Storage for group name and writeable details
+        /// @param name      The name of the group
+        /// @param writeable Whether the group needs to be writeable
+        GroupData(const Name& name, const bool writeable)
+            : mName(name), mWriteable(writeable) {}
+
+        Name mName;
+        bool mWriteable;
+    };
+
+    using GroupDataVec = std::vector<GroupData>;
+
+    using StringVec = std::vector<Name>;
+
     AttributeRegistry()
-        : mAttributes() {}
+        : mAttributes()
+        , mGroups()
+        , mDynamicGroupWrites(false)
+        , mStrings() {}
 
     /// @brief  Returns whether or not an attribute is required to be written to.
     ///         If no attribute with this name has been registered, returns false
@@ -132,8 +154,73 @@ public:
         return mAttributes;
     }
 
+    /// @brief  Returns whether or not a group is registered.
+    /// @param  name The name of the group
+    ///
+    inline bool
+    isGroupRegistered(const Name& name) const
+    {
+        for (const auto& data : mGroups) {
+            if (data.mName == name) return true;
+        }
+        return false;
+    }
+
+    /// @brief  Add a group which is accessed by name to the registry, returns an index
+    ///         into the registry for that group
+    /// @param  name      The name of the group
+    /// @param  writeable Whether the group is required to be writeable
+    ///
+    inline int64_t
+    addGroup(const Name& name, const bool writeable)
+    {
+        mGroups.emplace_back(name, writeable);
+        return mGroups.size() - 1;
+    }
+
+    /// @brief  Returns a const reference to the vector of registered groups
+    ///
+    inline const
+    GroupDataVec& groupData() const
+    {
+        return mGroups;
+    }
+
+    /// @brief  Set whether groups are edited through names which are only known at
+    ///         runtime, in which case every group must be writeable
+    /// @param  on  Whether groups are edited dynamically
+    ///
+    inline void setDynamicGroupWrites(const bool on) { mDynamicGroupWrites = on; }
+
+    /// @brief  Returns whether groups are edited through names which are only known
+    ///         at runtime
+    ///
+    inline bool dynamicGroupWrites() const { return mDynamicGroupWrites; }
+
+    /// @brief  Add a string literal which is compared against string attributes to the
+    ///         registry, returns an index into the registry for that string
+    /// @param  string  The string literal
+    ///
+    inline int64_t
+    addString(const Name& string)
+    {
+        mStrings.emplace_back(string);
+        return mStrings.size() - 1;
+    }
+
+    /// @brief  Returns a const reference to the vector of registered string literals
+    ///
+    inline const
+    StringVec& stringData() const
+    {
+        return mStrings;
+    }
+
 private:
     AttributeDataVec mAttributes;
+    GroupDataVec mGroups;
+    bool mDynamicGroupWrites;
+    StringVec mStrings;
 };
 
 
@@ -39,8 +39,13 @@
 #include <openvdb/tree/LeafManager.h>
 #include <openvdb/Types.h>
 
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory> // std::atomic_load
+
 namespace openvdb {
 OPENVDB_USE_VERSION_NAMESPACE
 namespace OPENVDB_VERSION_NAME {
@@ -111,9 +116,9 @@ struct VolumeExecuterOp
 
         for (auto leaf = range.begin(); leaf; ++leaf) {
             for (auto voxel = leaf->cbeginValueOn(); voxel; ++voxel) {
-                args.mCoord = voxel.getCoord();
-                args.mCoordWS = mTargetVolumeTransform.indexToWorld(args.mCoord);
-                args.bind(mComputeFunction)();
+                const openvdb::Coord& coord = voxel.getCoord();
+                args.setCoord(coord, mTargetVolumeTransform.indexToWorld(coord));
+                args.call(mComputeFunction);
             }
         }
     }
@@ -159,25 +164,215 @@ void registerVolumes(const GridPtrVec &grids, GridPtrVec &writeableGrids, GridPt
     }
 }
 
+/// @brief  Calls an operator with the typed tree of a grid
+template <typename OpT>
+inline void applyToTree(const openvdb::GridBase::Ptr& grid, const OpT& op)
+{
+    if (grid->isType<BoolGrid>())           op(StaticPtrCast<BoolGrid>(grid)->tree());
+    else if (grid->isType<Int32Grid>())     op(StaticPtrCast<Int32Grid>(grid)->tree());
+    else if (grid->isType<Int64Grid>())     op(StaticPtrCast<Int64Grid>(grid)->tree());
+    else if (grid->isType<FloatGrid>())     op(StaticPtrCast<FloatGrid>(grid)->tree());
+    else if (grid->isType<DoubleGrid>())    op(StaticPtrCast<DoubleGrid>(grid)->tree());
+    else if (grid->isType<Vec3IGrid>())     op(StaticPtrCast<Vec3IGrid>(grid)->tree());
+    else if (grid->isType<Vec3fGrid>())     op(StaticPtrCast<Vec3fGrid>(grid)->tree());
+    else if (grid->isType<Vec3dGrid>())     op(StaticPtrCast<Vec3dGrid>(grid)->tree());
+    else if (grid->isType<MaskGrid>())      op(StaticPtrCast<MaskGrid>(grid)->tree());
+    else {
+        OPENVDB_THROW(TypeError, "Could not retrieve volume '" + grid->getName()
+                                 + "' as it has an unknown value type");
+    }
+}
+
+/// @brief  The leaves of a tree to be executed by a block. The type of the tree is
+///         erased so that the leaves of many trees can be executed in a single
+///         parallel loop, see executeLeafTasks
+struct LeafTask
+{
+    size_t mLeafCount;
+    /// Executes the leaves with indices in the range [begin, end)
+    std::function<void(const size_t, const size_t)> mExecute;
+};
+
+/// @brief  Creates the task which executes a compute function over the active voxels of
+///         the leaf nodes of a tree
+struct CreateLeafTaskOp
+{
+    using FunctionT = codegen::ComputeVolumeFunction::SignaturePtr;
+
+    CreateLeafTaskOp(const VolumeRegistry& volumeRegistry,
+                     const CustomData& customData,
+                     const math::Transform& transform,
+                     FunctionT computeFunction,
+                     openvdb::GridPtrVec& grids,
+                     LeafTask& task)
+        : mVolumeRegistry(volumeRegistry)
+        , mCustomData(customData)
+        , mTransform(transform)
+        , mComputeFunction(computeFunction)
+        , mGrids(grids)
+        , mTask(task) {}
+
+    template <typename TreeT>
+    void operator()(TreeT& tree) const
+    {
+        using LeafManagerT = tree::LeafManager<TreeT>;
+
+        const std::shared_ptr<LeafManagerT> leafManager(new LeafManagerT(tree));
+        const VolumeExecuterOp<TreeT> executerOp(mVolumeRegistry, mCustomData, mTransform,
+            mComputeFunction, mGrids);
+
+        mTask.mLeafCount = leafManager->leafCount();
+        mTask.mExecute = [leafManager, executerOp](const size_t begin, const size_t end) {
+            executerOp(typename LeafManagerT::LeafRange(begin, end, *leafManager));
+        };
+    }
+
+private:
+    const VolumeRegistry&   mVolumeRegistry;
+    const CustomData&       mCustomData;
+    const math::Transform&  mTransform;
+    FunctionT               mComputeFunction;
+    openvdb::GridPtrVec&    mGrids;
+    LeafTask&               mTask;
+};
+
+/// @brief  Executes the leaves of many tasks in a single parallel loop, so that threads
+///         are not left idle at the end of each tree. The leaves of the tasks are
+///         indexed in order, and each range of this index is split at the boundaries of
+///         the tasks it spans
+void executeLeafTasks(const std::vector<LeafTask>& tasks)
+{
+    std::vector<size_t> offsets { 0 };
+    offsets.reserve(tasks.size() + 1);
+    for (const LeafTask& task : tasks) offsets.emplace_back(offsets.back() + task.mLeafCount);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, offsets.back()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            size_t i = std::upper_bound(offsets.begin(), offsets.end(), range.begin()) -
+                offsets.begin() - 1;
+            for (size_t begin = range.begin(); begin < range.end(); ++i) {
+                const size_t end = std::min(range.end(), offsets[i + 1]);
+                if (end > begin) tasks[i].mExecute(begin - offsets[i], end - offsets[i]);
+                begin = end;
+            }
+        });
+}
+
+/// @brief  Adds the active voxels of the leaf nodes of a tree to a mask. Active tiles
+///         are ignored, as they are not visited by the executer
+struct TopologyUnionOp
+{
+    TopologyUnionOp(MaskTree& topology) : mTopology(topology) {}
+
+    template <typename TreeT>
+    void operator()(const TreeT& tree) const
+    {
+        for (auto leaf = tree.cbeginLeaf(); leaf; ++leaf) {
+            mTopology.touchLeaf(leaf->origin())->topologyUnion(*leaf);
+        }
+    }
+
+private:
+    MaskTree& mTopology;
+};
+
+/// @brief  A set of grids executed together, with the grids matched to the volumes of
+///         the registry
+struct VolumeGridSet
+{
+    openvdb::GridPtrVec mUsableGrids;
+    openvdb::GridPtrVec mWriteableGrids;
+    /// The combined topology of the written grids of a single pass program which
+    /// writes to more than one grid
+    std::unique_ptr<MaskTree> mTopology;
+};
+
 } // anonymous namespace
 
+const std::map<std::string, uint64_t>&
+VolumeExecutable::blockFunctions(const size_t block) const
+{
+    if (!mBlockCompiler) return mBlockFunctionAddresses.at(block);
+
+    tbb::mutex::scoped_lock lock(mMutex);
+    std::map<std::string, uint64_t>& functions = mBlockFunctionAddresses.at(block);
+    if (functions.empty()) functions = mBlockCompiler->compile(block);
+    return functions;
+}
+
+void VolumeExecutable::compileBlocks() const
+{
+    for (size_t i = 0; i < mBlockFunctionAddresses.size(); ++i) {
+        this->blockFunctions(i);
+    }
+}
+
+void VolumeExecutable::upgrade(const std::shared_ptr<const VolumeExecutable>& executable)
+{
+    std::atomic_store(&mUpgraded, executable);
+}
+
+bool VolumeExecutable::isUpgraded() const
+{
+    return static_cast<bool>(std::atomic_load(&mUpgraded));
+}
+
 void VolumeExecutable::execute(const openvdb::GridPtrVec& grids) const
 {
-    openvdb::GridPtrVec usableGrids, writeableGrids;
+    std::vector<openvdb::GridPtrVec> gridSets { grids };
+    this->execute(gridSets);
+}
 
-    registerVolumes(grids, writeableGrids, usableGrids, mVolumeRegistry->volumeData());
+void VolumeExecutable::execute(std::vector<openvdb::GridPtrVec>& gridSets) const
+{
+    // the upgraded executable is kept alive for the duration of the call
+
+    const std::shared_ptr<const VolumeExecutable> upgraded = std::atomic_load(&mUpgraded);
+    if (upgraded) {
+        upgraded->execute(gridSets);
+        return;
+    }
+
+    // every set is matched to the registry before any is executed
+
+    std::vector<VolumeGridSet> sets(gridSets.size());
+
+    for (size_t i = 0; i < gridSets.size(); ++i) {
+        VolumeGridSet& set = sets[i];
+        registerVolumes(gridSets[i], set.mWriteableGrids, set.mUsableGrids,
+            mVolumeRegistry->volumeData());
+
+        if (!mSinglePass || set.mWriteableGrids.size() < 2) continue;
+
+        // every assigned volume is written in a single traversal of their combined
+        // topology, which requires them to share an index space
+
+        const math::Transform& transform = set.mWriteableGrids.front()->transform();
+        for (const auto& grid : set.mWriteableGrids) {
+            if (grid->transform() != transform) {
+                OPENVDB_THROW(AXExecutionError, "Unable to write to volume \"" +
+                    grid->getName() + "\" in a single pass as its transform differs "
+                    "from that of \"" + set.mWriteableGrids.front()->getName() + "\".");
+            }
+        }
+    }
 
     using FunctionType = codegen::ComputeVolumeFunction;
     const int numBlocks = mBlockFunctionAddresses.size();
 
     for (int i = 0; i < numBlocks; i++) {
 
+        // a single pass program with no assignments has nothing to write
+
+        if (mSinglePass && std::all_of(sets.begin(), sets.end(),
+            [](const VolumeGridSet& set) { return set.mWriteableGrids.empty(); })) return;
+
         FunctionType::SignaturePtr compute = nullptr;
         std::stringstream funcName("compute_volume_" + std::to_string(i));
-        const std::map<std::string, uint64_t>& blockFunctions = mBlockFunctionAddresses.at(i);
-        auto iter = blockFunctions.find(funcName.str());
+        const std::map<std::string, uint64_t>& functions = this->blockFunctions(i);
+        auto iter = functions.find(funcName.str());
 
-        if (iter != blockFunctions.cend() && (iter->second != uint64_t(0))) {
+        if (iter != functions.cend() && (iter->second != uint64_t(0))) {
             compute = reinterpret_cast<FunctionType::SignaturePtr>(iter->second);
         }
 
@@ -185,90 +380,59 @@ void VolumeExecutable::execute(const openvdb::GridPtrVec& grids) const
             OPENVDB_THROW(AXCompilerError, "No code has been successfully compiled for execution.");
         }
 
-        const std::string& currentVolumeAssigned = mAssignedVolumes[i];
-        math::Transform::ConstPtr writeTransform = nullptr;
+        // the leaves written by this block in every set are executed together. Blocks
+        // are executed in order, as a block may read the volumes written by the last
+
+        std::vector<LeafTask> tasks(sets.size());
+
+        for (size_t n = 0; n < sets.size(); ++n) {
+            VolumeGridSet& set = sets[n];
+            LeafTask& task = tasks[n];
+            task.mLeafCount = 0;
+
+            if (mSinglePass) {
+                if (set.mWriteableGrids.empty()) continue;
+
+                const math::Transform& transform = set.mWriteableGrids.front()->transform();
+                const CreateLeafTaskOp createOp(*mVolumeRegistry, *mCustomData,
+                    transform, compute, set.mUsableGrids, task);
+
+                if (set.mWriteableGrids.size() == 1) {
+                    applyToTree(set.mWriteableGrids.front(), createOp);
+                    continue;
+                }
 
-        // pointer to the grid which is being written to in the current block
-        openvdb::GridBase::Ptr gridToModify = nullptr;
+                // the kernel only writes to the active voxels of each volume, so their
+                // topology is unchanged and may be written to concurrently
 
-        for (const auto& grid : writeableGrids) {
-            if (grid->getName() == currentVolumeAssigned) {
-                writeTransform = grid->transformPtr();
-                gridToModify = grid;
-                break;
+                set.mTopology.reset(new MaskTree);
+                for (const auto& grid : set.mWriteableGrids) {
+                    applyToTree(grid, TopologyUnionOp(*set.mTopology));
+                }
+
+                createOp(*set.mTopology);
+                continue;
             }
-        }
 
-        // We execute over the topology of the grid currently being modified.  To do this, we need
-        // a typed tree and leaf manager
+            const std::string& currentVolumeAssigned = mAssignedVolumes[i];
 
-        if (gridToModify->isType<BoolGrid>()) {
-            BoolGrid::Ptr typed = StaticPtrCast<BoolGrid>(gridToModify);
-            tree::LeafManager<BoolTree> leafManager(typed->tree());
-            VolumeExecuterOp<BoolTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<Int32Grid>()) {
-            Int32Grid::Ptr typed = StaticPtrCast<Int32Grid>(gridToModify);
-            tree::LeafManager<Int32Tree> leafManager(typed->tree());
-            VolumeExecuterOp<Int32Tree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                 compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<Int64Grid>()) {
-            Int64Grid::Ptr typed = StaticPtrCast<Int64Grid>(gridToModify);
-            tree::LeafManager<Int64Tree> leafManager(typed->tree());
-            VolumeExecuterOp<Int64Tree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<FloatGrid>()) {
-            FloatGrid::Ptr typed = StaticPtrCast<FloatGrid>(gridToModify);
-            tree::LeafManager<FloatTree> leafManager(typed->tree());
-            VolumeExecuterOp<FloatTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<DoubleGrid>()) {
-            DoubleGrid::Ptr typed = StaticPtrCast<DoubleGrid>(gridToModify);
-            tree::LeafManager<DoubleTree> leafManager(typed->tree());
-            VolumeExecuterOp<DoubleTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<Vec3IGrid>()) {
-            Vec3IGrid::Ptr typed = StaticPtrCast<Vec3IGrid>(gridToModify);
-            tree::LeafManager<Vec3ITree> leafManager(typed->tree());
-            VolumeExecuterOp<Vec3ITree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<Vec3fGrid>()) {
-            Vec3fGrid::Ptr typed = StaticPtrCast<Vec3fGrid>(gridToModify);
-            tree::LeafManager<Vec3fTree> leafManager(typed->tree());
-            VolumeExecuterOp<Vec3fTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<Vec3dGrid>()) {
-            Vec3dGrid::Ptr typed = StaticPtrCast<Vec3dGrid>(gridToModify);
-            tree::LeafManager<Vec3dTree> leafManager(typed->tree());
-            VolumeExecuterOp<Vec3dTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else if (gridToModify->isType<MaskGrid>()) {
-            MaskGrid::Ptr typed = StaticPtrCast<MaskGrid>(gridToModify);
-            tree::LeafManager<MaskTree> leafManager(typed->tree());
-            VolumeExecuterOp<MaskTree> executerOp(*mVolumeRegistry, *mCustomData, *writeTransform,
-                compute, usableGrids);
-            tbb::parallel_for(leafManager.leafRange(), executerOp);
-        }
-        else {
-            OPENVDB_THROW(TypeError, "Could not retrieve volume '" + gridToModify->getName()
-                                     + "' as it has an unknown value type");
+            // pointer to the grid which is being written to in the current block
+            openvdb::GridBase::Ptr gridToModify = nullptr;
+
+            for (const auto& grid : set.mWriteableGrids) {
+                if (grid->getName() == currentVolumeAssigned) {
+                    gridToModify = grid;
+                    break;
+                }
+            }
+
+            // We execute over the topology of the grid currently being modified
+
+            applyToTree(gridToModify, CreateLeafTaskOp(*mVolumeRegistry, *mCustomData,
+                gridToModify->transform(), compute, set.mUsableGrids, task));
         }
+
+        executeLeafTasks(tasks);
     }
 }
 
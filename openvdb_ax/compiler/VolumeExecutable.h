@@ -43,6 +43,8 @@
 
 #include <openvdb/openvdb.h>
 
+#include <tbb/mutex.h>
+
 //forward
 namespace llvm {
 
@@ -57,6 +59,8 @@ namespace OPENVDB_VERSION_NAME {
 
 namespace ax {
 
+class SharedLibrary;
+
 /// @brief Object that encapsulates compiled AX code which can be executed on a collection of
 ///        VDB volume grids
 class VolumeExecutable
@@ -65,6 +69,19 @@ public:
     using Ptr = std::shared_ptr<VolumeExecutable>;
     using Registry = VolumeRegistry;
 
+    /// @brief  Generates the machine code of a block of compute functions on the first
+    ///         execution of that block. Implemented by the Compiler.
+    struct BlockCompiler
+    {
+        using Ptr = std::shared_ptr<BlockCompiler>;
+        virtual ~BlockCompiler() = default;
+
+        /// @brief  Compiles a block, returning a map of its function names to addresses
+        virtual std::map<std::string, uint64_t> compile(const size_t block) = 0;
+        /// @brief  Returns the number of bytes of code and data allocated so far
+        virtual size_t codeSize() const = 0;
+    };
+
     /// @brief Constructor
     /// @param exeEngine Shared pointer to an llvm::ExecutionEngine object used to build functions.
     ///        context should be the associated llvm context
@@ -75,6 +92,8 @@ public:
     /// @param functionAddresses A Vector of maps of function names to physical memory addresses which were built
     ///        by llvm using exeEngine
     /// @param assignedVolumes Vector of names of volumes which are written to, in order.
+    /// @param codeSize The number of bytes of code and data allocated by the JIT for this executable
+    /// @param singlePass Whether a single block writes to all assigned volumes
     /// @note  This object is normally be constructed by the Compiler::compile method, rather
     ///        than directly
     VolumeExecutable(const std::shared_ptr<const llvm::ExecutionEngine>& exeEngine,
@@ -82,21 +101,119 @@ public:
                      const VolumeRegistry::ConstPtr& volumeRegistry,
                      const CustomData::Ptr& customData,
                      const std::vector<std::map<std::string, uint64_t> >& functionAddresses,
-                     const std::vector<std::string>& assignedVolumes)
+                     const std::vector<std::string>& assignedVolumes,
+                     const size_t codeSize = 0,
+                     const bool singlePass = false)
         : mExecutionEngine(exeEngine)
         , mContext(context)
         , mVolumeRegistry(volumeRegistry)
         , mCustomData(customData)
         , mBlockFunctionAddresses(functionAddresses)
-        , mAssignedVolumes(assignedVolumes) {}
+        , mAssignedVolumes(assignedVolumes)
+        , mSinglePass(singlePass)
+        , mCodeSize(codeSize)
+        , mBlockCompiler()
+        , mMutex()
+        , mLibrary()
+        , mUpgraded() {}
+
+    /// @brief Constructor for an executable which compiles each block on first execution
+    /// @param blockCompiler The block compiler, which also owns the llvm objects of
+    ///        the compiled code
+    /// @param volumeRegistry Registry of volumes accessed by AX code
+    /// @param customData Custom data object which will be shared by this executable
+    /// @param assignedVolumes Vector of names of volumes which are written to, in order.
+    /// @param singlePass Whether a single block writes to all assigned volumes
+    VolumeExecutable(const BlockCompiler::Ptr& blockCompiler,
+                     const VolumeRegistry::ConstPtr& volumeRegistry,
+                     const CustomData::Ptr& customData,
+                     const std::vector<std::string>& assignedVolumes,
+                     const bool singlePass = false)
+        : mExecutionEngine()
+        , mContext()
+        , mVolumeRegistry(volumeRegistry)
+        , mCustomData(customData)
+        , mBlockFunctionAddresses(singlePass ? size_t(1) : assignedVolumes.size())
+        , mAssignedVolumes(assignedVolumes)
+        , mSinglePass(singlePass)
+        , mCodeSize(0)
+        , mBlockCompiler(blockCompiler)
+        , mMutex()
+        , mLibrary()
+        , mUpgraded() {}
+
+    /// @brief Constructor for an executable loaded from an ahead of time compiled
+    ///        shared library
+    /// @param library The shared library holding the compiled code
+    /// @param volumeRegistry Registry of volumes accessed by AX code
+    /// @param customData Custom data object which will be shared by this executable
+    /// @param functionAddresses A Vector of maps of function names to their addresses
+    ///        in library
+    /// @param assignedVolumes Vector of names of volumes which are written to, in order.
+    /// @param singlePass Whether a single block writes to all assigned volumes
+    /// @note  This object is normally constructed by loadExecutable
+    VolumeExecutable(const std::shared_ptr<const SharedLibrary>& library,
+                     const VolumeRegistry::ConstPtr& volumeRegistry,
+                     const CustomData::Ptr& customData,
+                     const std::vector<std::map<std::string, uint64_t> >& functionAddresses,
+                     const std::vector<std::string>& assignedVolumes,
+                     const bool singlePass = false)
+        : mExecutionEngine()
+        , mContext()
+        , mVolumeRegistry(volumeRegistry)
+        , mCustomData(customData)
+        , mBlockFunctionAddresses(functionAddresses)
+        , mAssignedVolumes(assignedVolumes)
+        , mSinglePass(singlePass)
+        , mCodeSize(0)
+        , mBlockCompiler()
+        , mMutex()
+        , mLibrary(library)
+        , mUpgraded() {}
 
     ~VolumeExecutable() = default;
 
+    /// @brief Replaces the code run by this executable with that of another executable
+    ///        compiled from the same program and custom data, such as a more optimised
+    ///        build. This is safe to call concurrently with execute - executions already
+    ///        in progress complete with the previous code.
+    /// @note  This is normally called by Compiler::compileTiered
+    void upgrade(const std::shared_ptr<const VolumeExecutable>& executable);
+
+    /// @brief Returns true if this executable has been upgraded
+    bool isUpgraded() const;
+
     /// @brief Execute AX code on target grids
     void execute(const openvdb::GridPtrVec& grids) const;
 
+    /// @brief Execute AX code on many sets of target grids
+    /// @details Each block of the code is executed over the leaves of every set in a
+    ///          single parallel loop, rather than one loop per set, so that small grids
+    ///          do not leave threads idle. Each set is executed as it would be by
+    ///          execute(grids), and the sets must not share grids which are written to.
+    /// @param gridSets The sets of grids to apply code to
+    void execute(std::vector<openvdb::GridPtrVec>& gridSets) const;
+
+    /// @brief Compiles all blocks which have not yet been executed. Has no effect on
+    ///        executables which are not lazily compiled.
+    void compileBlocks() const;
+
+    /// @brief Returns true if all assigned volumes are written in a single traversal.
+    ///        See CompilerOptions::singlePassVolumes
+    inline bool isSinglePass() const { return mSinglePass; }
+
+    /// @brief Returns the number of bytes of code and data allocated by the JIT. For
+    ///        lazily compiled executables this grows as blocks are first executed.
+    inline size_t codeSize() const
+    {
+        return mBlockCompiler ? mBlockCompiler->codeSize() : mCodeSize;
+    }
+
 private:
 
+    /// @brief Returns the functions of a block, compiling them if necessary
+    const std::map<std::string, uint64_t>& blockFunctions(const size_t block) const;
+
     // these 2 shared pointers exist _only_ for object lifetime management
     // as these objects must not be destroyed before this one
     const std::shared_ptr<const llvm::ExecutionEngine> mExecutionEngine;
@@ -105,8 +222,18 @@ private:
     const Registry::ConstPtr mVolumeRegistry;
 
     const CustomData::Ptr mCustomData;
-    const std::vector<std::map<std::string, uint64_t> > mBlockFunctionAddresses;
+    // populated on first execution of each block for lazily compiled executables
+    mutable std::vector<std::map<std::string, uint64_t> > mBlockFunctionAddresses;
     const std::vector<std::string> mAssignedVolumes;
+    const bool mSinglePass;
+    const size_t mCodeSize;
+
+    const BlockCompiler::Ptr mBlockCompiler;
+    mutable tbb::mutex mMutex;
+    // exists only for object lifetime management
+    const std::shared_ptr<const SharedLibrary> mLibrary;
+    // execution is forwarded to this executable once set. Only accessed atomically
+    std::shared_ptr<const VolumeExecutable> mUpgraded;
 };
 
 }
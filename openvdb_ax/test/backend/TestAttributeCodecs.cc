@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/codegen/AttributeCodecs.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestAttributeCodecs : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestAttributeCodecs);
+    CPPUNIT_TEST(testDecode);
+    CPPUNIT_TEST(testEncode);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testDecode();
+    void testEncode();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestAttributeCodecs);
+
+namespace {
+
+using FixedPointArray =
+    openvdb::points::TypedAttributeArray<float,
+        openvdb::points::FixedPointCodec<false, openvdb::points::UnitRange>>;
+using TruncateArray =
+    openvdb::points::TypedAttributeArray<float, openvdb::points::TruncateCodec>;
+using UnitVecArray =
+    openvdb::points::TypedAttributeArray<openvdb::Vec3f, openvdb::points::UnitVecCodec>;
+
+}
+
+void
+TestAttributeCodecs::testDecode()
+{
+    using namespace openvdb::ax::codegen;
+
+    FixedPointArray fixed(10);
+    fixed.expand();
+    for (openvdb::Index n = 0; n < 10; ++n) fixed.set(n, float(n) / 10.0f);
+
+    std::vector<float> values;
+    CPPUNIT_ASSERT(decodeAttributeArray(fixed, values));
+    CPPUNIT_ASSERT_EQUAL(size_t(10), values.size());
+    for (openvdb::Index n = 0; n < 10; ++n) CPPUNIT_ASSERT_EQUAL(fixed.get(n), values[n]);
+
+    TruncateArray truncate(4);
+    truncate.expand();
+    truncate.set(3, 1.5f);
+    CPPUNIT_ASSERT(decodeAttributeArray(truncate, values));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), values.size());
+    CPPUNIT_ASSERT_EQUAL(1.5f, values[3]);
+
+    UnitVecArray unit(4);
+    unit.expand();
+    unit.set(2, openvdb::Vec3f(0.0f, 1.0f, 0.0f));
+    std::vector<openvdb::Vec3f> vectors;
+    CPPUNIT_ASSERT(decodeAttributeArray(unit, vectors));
+    CPPUNIT_ASSERT_EQUAL(unit.get(2), vectors[2]);
+
+    // uniform arrays and mismatching value types are not decoded
+
+    std::vector<float> unchanged;
+    FixedPointArray uniform(10);
+    CPPUNIT_ASSERT(!decodeAttributeArray(uniform, unchanged));
+    CPPUNIT_ASSERT(!decodeAttributeArray(unit, unchanged));
+    CPPUNIT_ASSERT(unchanged.empty());
+}
+
+void
+TestAttributeCodecs::testEncode()
+{
+    using namespace openvdb::ax::codegen;
+
+    FixedPointArray fixed(10);
+    fixed.expand();
+    for (openvdb::Index n = 0; n < 10; ++n) fixed.set(n, float(n) / 10.0f);
+
+    std::vector<float> values;
+    CPPUNIT_ASSERT(decodeAttributeArray(fixed, values));
+
+    // only changed values are re-encoded, so the others are unaffected by the loss
+    // of precision of a round trip through the codec
+
+    const FixedPointArray original(fixed);
+    const std::vector<float> decoded(values);
+    values[5] = 0.25f;
+    CPPUNIT_ASSERT(encodeAttributeArray(fixed, values, decoded));
+
+    for (openvdb::Index n = 0; n < 10; ++n) {
+        if (n == 5) continue;
+        CPPUNIT_ASSERT_EQUAL(original.get(n), fixed.get(n));
+    }
+
+    FixedPointArray expected(1);
+    expected.set(0, 0.25f);
+    CPPUNIT_ASSERT_EQUAL(expected.get(0), fixed.get(5));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/PointAttribute.h>
+#include <openvdb/points/PointCount.h>
+#include <openvdb/points/PointGroup.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestBatchedExecute : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestBatchedExecute);
+    CPPUNIT_TEST(testPoints);
+    CPPUNIT_TEST(testVolumes);
+    CPPUNIT_TEST(testVolumeErrors);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testPoints();
+    void testVolumes();
+    void testVolumeErrors();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBatchedExecute);
+
+namespace {
+
+/// @brief  Creates a point grid with a point in each of the first count voxels along
+///         x, and a float attribute "a" holding the index of each point
+openvdb::points::PointDataGrid::Ptr createPoints(const int count)
+{
+    using namespace openvdb::points;
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < count; ++n) positions.emplace_back(float(n), 0.0f, 0.0f);
+
+    PointDataGrid::Ptr grid = unittest_util::createPointGrid(positions);
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    float value = 0.0f;
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) a.set(n, value++);
+    }
+
+    return grid;
+}
+
+openvdb::FloatGrid::Ptr createVolume(const std::string& name, const int count)
+{
+    openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create();
+    grid->setName(name);
+    for (int n = 0; n < count; ++n) grid->tree().setValueOn(openvdb::Coord(n * 8, 0, 0));
+    return grid;
+}
+
+}
+
+void
+TestBatchedExecute::testPoints()
+{
+    using namespace openvdb::points;
+
+    const std::string code = "@b = @a * 2.0f;"
+        "if (@a == 1.0f) addtogroup(\"new\");"
+        "if (@a == 2.0f) v@P.x = 100.0f;"
+        "if (@a == 3.0f) deletepoint();";
+
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::PointExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::PointExecutable>(code, openvdb::ax::CustomData::create());
+
+    // grids of different sizes, including one without points, are each executed as
+    // they would be on their own
+
+    const std::vector<int> counts { 40, 0, 5, 200 };
+
+    std::vector<PointDataGrid::Ptr> grids, expected;
+    for (const int count : counts) {
+        grids.emplace_back(createPoints(count));
+        expected.emplace_back(createPoints(count));
+    }
+
+    std::vector<size_t> moved;
+    executable->execute(grids, nullptr, &moved);
+    CPPUNIT_ASSERT_EQUAL(grids.size(), moved.size());
+
+    for (size_t i = 0; i < grids.size(); ++i) {
+        size_t expectedMoved = 0;
+        if (counts[i] > 0) executable->execute(*expected[i], nullptr, &expectedMoved);
+        CPPUNIT_ASSERT_EQUAL(expectedMoved, moved[i]);
+
+        const openvdb::Index64 count = pointCount(grids[i]->tree());
+        CPPUNIT_ASSERT_EQUAL(pointCount(expected[i]->tree()), count);
+        if (counts[i] < 4) continue;
+
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(counts[i] - 1), count);
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(1), groupPointCount(grids[i]->tree(), "new"));
+        CPPUNIT_ASSERT_EQUAL(expected[i]->tree().leafCount(), grids[i]->tree().leafCount());
+
+        auto leaf = grids[i]->tree().cbeginLeaf();
+        auto expectedLeaf = expected[i]->tree().cbeginLeaf();
+        for (; leaf; ++leaf, ++expectedLeaf) {
+            CPPUNIT_ASSERT(expectedLeaf);
+            CPPUNIT_ASSERT_EQUAL(expectedLeaf->origin(), leaf->origin());
+
+            AttributeHandle<float> a(leaf->constAttributeArray("a"));
+            AttributeHandle<float> b(leaf->constAttributeArray("b"));
+            AttributeHandle<float> expectedA(expectedLeaf->constAttributeArray("a"));
+            CPPUNIT_ASSERT_EQUAL(expectedA.size(), a.size());
+            for (openvdb::Index n = 0; n < a.size(); ++n) {
+                CPPUNIT_ASSERT_EQUAL(expectedA.get(n), a.get(n));
+                CPPUNIT_ASSERT_EQUAL(a.get(n) * 2.0f, b.get(n));
+            }
+        }
+    }
+}
+
+void
+TestBatchedExecute::testVolumes()
+{
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::VolumeExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::VolumeExecutable>("@a = 1.0f; @b = @a + 1.0f;",
+            openvdb::ax::CustomData::create());
+
+    // sets with different numbers of leaves. The second block reads the result of the
+    // first within each set
+
+    const std::vector<int> counts { 1, 30, 0, 4 };
+
+    std::vector<openvdb::GridPtrVec> sets;
+    for (const int count : counts) {
+        sets.emplace_back(openvdb::GridPtrVec {
+            createVolume("a", count), createVolume("b", count) });
+    }
+
+    executable->execute(sets);
+
+    for (size_t i = 0; i < sets.size(); ++i) {
+        for (size_t grid = 0; grid < 2; ++grid) {
+            const openvdb::FloatGrid& volume =
+                static_cast<const openvdb::FloatGrid&>(*sets[i][grid]);
+            CPPUNIT_ASSERT_EQUAL(openvdb::Index64(counts[i]), volume.tree().activeVoxelCount());
+            for (auto iter = volume.tree().cbeginValueOn(); iter; ++iter) {
+                CPPUNIT_ASSERT_EQUAL(float(grid + 1), *iter);
+            }
+        }
+    }
+}
+
+void
+TestBatchedExecute::testVolumeErrors()
+{
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::VolumeExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::VolumeExecutable>("@a = 1.0f;",
+            openvdb::ax::CustomData::create());
+
+    // every set is validated before any is executed
+
+    openvdb::FloatGrid::Ptr a = createVolume("a", 2);
+    std::vector<openvdb::GridPtrVec> sets {
+        openvdb::GridPtrVec { a },
+        openvdb::GridPtrVec { createVolume("c", 2) } };
+
+    CPPUNIT_ASSERT_THROW(executable->execute(sets), openvdb::LookupError);
+    CPPUNIT_ASSERT_EQUAL(0.0f, a->tree().getValue(openvdb::Coord(0)));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
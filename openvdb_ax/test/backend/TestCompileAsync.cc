@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/ExecutableCache.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+class TestCompileAsync : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestCompileAsync);
+    CPPUNIT_TEST(testCompile);
+    CPPUNIT_TEST(testErrors);
+    CPPUNIT_TEST(testRelease);
+    CPPUNIT_TEST(testTiered);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testCompile();
+    void testErrors();
+    void testRelease();
+    void testTiered();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCompileAsync);
+
+void
+TestCompileAsync::testCompile()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    CustomData::Ptr data = CustomData::create();
+
+    std::vector<std::future<PointExecutable::Ptr>> points;
+    std::vector<std::future<VolumeExecutable::Ptr>> volumes;
+
+    for (int i = 0; i < 8; ++i) {
+        const std::string code = "@a = " + std::to_string(i) + ".0f + @b;";
+        points.emplace_back(compiler->compileAsync<PointExecutable>(code, data));
+        volumes.emplace_back(compiler->compileAsync<VolumeExecutable>(code, data));
+    }
+
+    // synchronous compilation remains valid while asynchronous tasks are running
+
+    CPPUNIT_ASSERT(compiler->compile<PointExecutable>("@a = 1.0f;", data));
+
+    for (auto& future : points)  CPPUNIT_ASSERT(future.get());
+    for (auto& future : volumes) CPPUNIT_ASSERT(future.get());
+}
+
+void
+TestCompileAsync::testErrors()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    std::vector<std::string> warnings;
+
+    std::future<PointExecutable::Ptr> future =
+        compiler->compileAsync<PointExecutable>("@a = unknown_function();",
+            CustomData::create(), &warnings);
+
+    CPPUNIT_ASSERT_THROW(future.get(), std::exception);
+}
+
+void
+TestCompileAsync::testRelease()
+{
+    using namespace openvdb::ax;
+
+    // an executable cache too small to hold more than one executable evicts, and so
+    // destroys, executables on the worker threads while other programs are compiled
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->setExecutableCache(ExecutableCache::create(1));
+    CustomData::Ptr data = CustomData::create();
+
+    std::vector<std::future<PointExecutable::Ptr>> points;
+    for (int i = 0; i < 16; ++i) {
+        const std::string code = "@a = " + std::to_string(i) + ".0f + @b;";
+        points.emplace_back(compiler->compileAsync<PointExecutable>(code, data));
+    }
+
+    // executables released on this thread while compilation continues
+
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT(compiler->compile<PointExecutable>("@c = " + std::to_string(i) + ";", data));
+    }
+
+    for (auto& future : points) CPPUNIT_ASSERT(future.get());
+}
+
+void
+TestCompileAsync::testTiered()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+
+    openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create();
+    grid->setName("a");
+    grid->tree().setValueOn(openvdb::Coord(0));
+    openvdb::GridPtrVec grids { grid };
+
+    VolumeExecutable::Ptr executable =
+        compiler->compileTiered<VolumeExecutable>("@a += 2.0f;", CustomData::create());
+    CPPUNIT_ASSERT(executable);
+
+    // execution is valid before, during and after the upgrade
+
+    executable->execute(grids);
+    CPPUNIT_ASSERT_EQUAL(2.0f, grid->tree().getValue(openvdb::Coord(0)));
+
+    compiler->wait();
+    CPPUNIT_ASSERT(executable->isUpgraded());
+
+    executable->execute(grids);
+    CPPUNIT_ASSERT_EQUAL(4.0f, grid->tree().getValue(openvdb::Coord(0)));
+
+    // nothing to upgrade to at O0
+
+    CompilerOptions options;
+    options.optLevel = CompilerOptions::OptLevel::O0;
+    compiler = Compiler::create(options);
+
+    PointExecutable::Ptr points =
+        compiler->compileTiered<PointExecutable>("@a = 1.0f;", CustomData::create());
+    compiler->wait();
+    CPPUNIT_ASSERT(!points->isUpgraded());
+
+    // upgraded point executables released on other threads while the compiler keeps
+    // building other programs
+
+    compiler = Compiler::create();
+    std::vector<std::future<void>> released;
+    for (int i = 0; i < 8; ++i) {
+        const std::string code = "@a = " + std::to_string(i) + ".0f * @b;";
+        PointExecutable::Ptr tiered =
+            compiler->compileTiered<PointExecutable>(code, CustomData::create());
+        released.emplace_back(std::async(std::launch::async,
+            [tiered]() mutable { tiered.reset(); }));
+        CPPUNIT_ASSERT(compiler->compile<PointExecutable>(code, CustomData::create()));
+    }
+
+    for (auto& future : released) future.get();
+    compiler->wait();
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
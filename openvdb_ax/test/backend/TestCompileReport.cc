@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/CompileReport.h>
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/ExecutableCache.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+
+class TestCompileReport : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestCompileReport);
+    CPPUNIT_TEST(testPoint);
+    CPPUNIT_TEST(testVolume);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testPoint();
+    void testVolume();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCompileReport);
+
+void
+TestCompileReport::testPoint()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->setExecutableCache(ExecutableCache::create());
+
+    CompileReport report;
+    compiler->compile<PointExecutable>("@a = sin(@b) + 1.0f;", CustomData::create(),
+        nullptr, &report);
+
+    CPPUNIT_ASSERT(!report.mExecutableCacheHit);
+    CPPUNIT_ASSERT(!report.mObjectCacheHit);
+    CPPUNIT_ASSERT(report.mParseTime > 0.0);
+    CPPUNIT_ASSERT(report.mCodeGenerationTime > 0.0);
+    CPPUNIT_ASSERT(report.mOptimisationTime > 0.0);
+    CPPUNIT_ASSERT(report.mMachineCodeTime > 0.0);
+    CPPUNIT_ASSERT(report.mInstructionsBeforeOptimisation > 0);
+    CPPUNIT_ASSERT(report.mInstructionsAfterOptimisation > 0);
+    CPPUNIT_ASSERT(report.mMachineCodeBytes > 0);
+    CPPUNIT_ASSERT(report.mFunctionsInstantiated > 0);
+
+    std::ostringstream os;
+    report.print(os);
+    CPPUNIT_ASSERT(!os.str().empty());
+
+    // a second compilation is served from the cache
+
+    compiler->compile<PointExecutable>("@a = sin(@b) + 1.0f;", CustomData::create(),
+        nullptr, &report);
+
+    CPPUNIT_ASSERT(report.mExecutableCacheHit);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), report.mInstructionsBeforeOptimisation);
+    CPPUNIT_ASSERT_EQUAL(0.0, report.mOptimisationTime);
+}
+
+void
+TestCompileReport::testVolume()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+
+    // reporting compiles all blocks ahead of execution
+
+    CompileReport report;
+    VolumeExecutable::Ptr executable =
+        compiler->compile<VolumeExecutable>("@a = 1.0f; @b = 2.0f;", CustomData::create(),
+            nullptr, &report);
+
+    CPPUNIT_ASSERT(!report.mExecutableCacheHit);
+    CPPUNIT_ASSERT(report.mInstructionsBeforeOptimisation > 0);
+    CPPUNIT_ASSERT(report.mInstructionsAfterOptimisation > 0);
+    CPPUNIT_ASSERT(report.mMachineCodeBytes > 0);
+    CPPUNIT_ASSERT_EQUAL(executable->codeSize(), report.mMachineCodeBytes);
+
+    openvdb::FloatGrid::Ptr a = openvdb::FloatGrid::create();
+    openvdb::FloatGrid::Ptr b = openvdb::FloatGrid::create();
+    a->setName("a");
+    b->setName("b");
+    a->tree().setValueOn(openvdb::Coord(0));
+    b->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { a, b };
+    executable->execute(grids);
+
+    CPPUNIT_ASSERT_EQUAL(1.0f, a->tree().getValue(openvdb::Coord(0)));
+    CPPUNIT_ASSERT_EQUAL(2.0f, b->tree().getValue(openvdb::Coord(0)));
+    CPPUNIT_ASSERT_EQUAL(report.mMachineCodeBytes, executable->codeSize());
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/compiler/ExecutableCache.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestCompilerTarget : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestCompilerTarget);
+    CPPUNIT_TEST(testTarget);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testTarget();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCompilerTarget);
+
+namespace {
+
+float execute(const openvdb::ax::CompilerOptions& options,
+              const openvdb::ax::ExecutableCache::Ptr& cache)
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create(options);
+    compiler->setExecutableCache(cache);
+
+    VolumeExecutable::Ptr executable =
+        compiler->compile<VolumeExecutable>("float b = 1.5f; @a = b * 8.0f;",
+            CustomData::create());
+
+    openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create();
+    grid->setName("a");
+    grid->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { grid };
+    executable->execute(grids);
+
+    return grid->tree().getValue(openvdb::Coord(0));
+}
+
+}
+
+void
+TestCompilerTarget::testTarget()
+{
+    using namespace openvdb::ax;
+
+    ExecutableCache::Ptr cache = ExecutableCache::create();
+
+    // host cpu
+
+    CompilerOptions options;
+    CPPUNIT_ASSERT_EQUAL(12.0f, execute(options, cache));
+
+    // explicit generic cpu - the target is part of the compilation key
+
+    options.cpu = "generic";
+    CPPUNIT_ASSERT_EQUAL(12.0f, execute(options, cache));
+
+    CPPUNIT_ASSERT_EQUAL(size_t(2), cache->statistics().mEntries);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), cache->statistics().mHits);
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/codegen/PointComputeGenerator.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestDirectAttributeAccess : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestDirectAttributeAccess);
+    CPPUNIT_TEST(testRawData);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testRawData();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestDirectAttributeAccess);
+
+void
+TestDirectAttributeAccess::testRawData()
+{
+    using namespace openvdb::points;
+    using openvdb::ax::codegen::rawAttributeData;
+
+    // uniform arrays hold a single value
+
+    TypedAttributeArray<float> array(10);
+    CPPUNIT_ASSERT(array.isUniform());
+    CPPUNIT_ASSERT(!rawAttributeData<float>(array));
+
+    array.expand();
+    CPPUNIT_ASSERT(rawAttributeData<float>(array));
+    CPPUNIT_ASSERT(!rawAttributeData<double>(array));
+
+    // values stored with a codec
+
+    TypedAttributeArray<float, TruncateCodec> truncated(10);
+    truncated.expand();
+    CPPUNIT_ASSERT(!rawAttributeData<float>(truncated));
+
+    // strided arrays
+
+    TypedAttributeArray<float> strided(10, 3);
+    strided.expand();
+    CPPUNIT_ASSERT(!rawAttributeData<float>(strided));
+
+    // booleans
+
+    TypedAttributeArray<bool> boolean(10);
+    boolean.expand();
+    CPPUNIT_ASSERT(!rawAttributeData<bool>(boolean));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/ExecutableCache.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestExecutableCache : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestExecutableCache);
+    CPPUNIT_TEST(testLRU);
+    CPPUNIT_TEST(testCompile);
+    CPPUNIT_TEST(testLazyVolume);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testLRU();
+    void testCompile();
+    void testLazyVolume();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestExecutableCache);
+
+namespace {
+struct TestExecutable { using Ptr = std::shared_ptr<TestExecutable>; };
+struct OtherExecutable { using Ptr = std::shared_ptr<OtherExecutable>; };
+}
+
+void
+TestExecutableCache::testLRU()
+{
+    using openvdb::ax::ExecutableCache;
+
+    ExecutableCache cache(100);
+    CPPUNIT_ASSERT_EQUAL(size_t(100), cache.capacity());
+
+    TestExecutable::Ptr exe1(new TestExecutable), exe2(new TestExecutable),
+        exe3(new TestExecutable);
+
+    CPPUNIT_ASSERT(!cache.get<TestExecutable>(1));
+
+    const std::vector<std::string> warnings { "warning" };
+    cache.insert(1, exe1, 40, &warnings);
+    cache.insert(2, exe2, 40);
+
+    std::vector<std::string> result;
+    CPPUNIT_ASSERT_EQUAL(exe1, cache.get<TestExecutable>(1, &result));
+    CPPUNIT_ASSERT(warnings == result);
+
+    // 2 is now the least recently used and should be evicted
+
+    cache.insert(3, exe3, 40);
+    CPPUNIT_ASSERT(!cache.get<TestExecutable>(2));
+    CPPUNIT_ASSERT_EQUAL(exe1, cache.get<TestExecutable>(1));
+    CPPUNIT_ASSERT_EQUAL(exe3, cache.get<TestExecutable>(3));
+
+    ExecutableCache::Statistics stats = cache.statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(4), stats.mHits);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), stats.mMisses);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), stats.mEvictions);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), stats.mEntries);
+    CPPUNIT_ASSERT_EQUAL(size_t(80), stats.mBytes);
+
+    // the most recent entry is always kept, even if over capacity
+
+    cache.insert(4, exe1, 200);
+    stats = cache.statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(1), stats.mEntries);
+    CPPUNIT_ASSERT_EQUAL(size_t(200), stats.mBytes);
+    CPPUNIT_ASSERT_EQUAL(exe1, cache.get<TestExecutable>(4));
+
+    // entries are only returned as the type they were inserted as
+
+    CPPUNIT_ASSERT(!cache.get<OtherExecutable>(4));
+    CPPUNIT_ASSERT_EQUAL(exe1, cache.get<TestExecutable>(4));
+
+    cache.clear();
+    stats = cache.statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mEntries);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mBytes);
+}
+
+void
+TestExecutableCache::testCompile()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    ExecutableCache::Ptr cache = ExecutableCache::create();
+    compiler->setExecutableCache(cache);
+
+    CustomData::Ptr data = CustomData::create();
+
+    PointExecutable::Ptr point1 = compiler->compile<PointExecutable>("@a = 1.0f;", data);
+    PointExecutable::Ptr point2 = compiler->compile<PointExecutable>("@a  =  1.0f ;", data);
+    CPPUNIT_ASSERT(point1);
+    CPPUNIT_ASSERT(point1->codeSize() > 0);
+    CPPUNIT_ASSERT_EQUAL(point1, point2);
+
+    // different code, executable type or custom data produce new executables
+
+    PointExecutable::Ptr point3 = compiler->compile<PointExecutable>("@a = 2.0f;", data);
+    CPPUNIT_ASSERT(point3 != point1);
+
+    VolumeExecutable::Ptr volume = compiler->compile<VolumeExecutable>("@a = 1.0f;", data);
+    CPPUNIT_ASSERT(volume);
+
+    PointExecutable::Ptr point4 =
+        compiler->compile<PointExecutable>("@a = 1.0f;", CustomData::create());
+    CPPUNIT_ASSERT(point4 != point1);
+
+    const ExecutableCache::Statistics stats = cache->statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(1), stats.mHits);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), stats.mMisses);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), stats.mEntries);
+}
+
+void
+TestExecutableCache::testLazyVolume()
+{
+    using namespace openvdb::ax;
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    ExecutableCache::Ptr cache = ExecutableCache::create();
+    compiler->setExecutableCache(cache);
+
+    // volume blocks are only compiled on execution, at which point the cached size
+    // is updated
+
+    VolumeExecutable::Ptr volume =
+        compiler->compile<VolumeExecutable>("@a = 1.0f; @b = @a;", CustomData::create());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), volume->codeSize());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), cache->statistics().mBytes);
+
+    openvdb::FloatGrid::Ptr a = openvdb::FloatGrid::create();
+    openvdb::FloatGrid::Ptr b = openvdb::FloatGrid::create();
+    a->setName("a");
+    b->setName("b");
+    a->tree().setValueOn(openvdb::Coord(0));
+    b->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { a, b };
+    volume->execute(grids);
+
+    CPPUNIT_ASSERT_EQUAL(1.0f, b->tree().getValue(openvdb::Coord(0)));
+
+    const size_t size = volume->codeSize();
+    CPPUNIT_ASSERT(size > 0);
+    CPPUNIT_ASSERT_EQUAL(size, cache->statistics().mBytes);
+
+    // subsequent executions use the compiled blocks
+
+    volume->execute(grids);
+    CPPUNIT_ASSERT_EQUAL(size, volume->codeSize());
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
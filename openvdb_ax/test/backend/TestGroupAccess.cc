@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/ast/AST.h>
+#include <openvdb_ax/ast/Scanners.h>
+#include <openvdb_ax/codegen/PointComputeGenerator.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestGroupAccess : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestGroupAccess);
+    CPPUNIT_TEST(testIsGroupAccess);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testIsGroupAccess();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestGroupAccess);
+
+namespace {
+
+bool isGroupAccess(const std::string& code, std::string& name, bool& write)
+{
+    const openvdb::ax::ast::Tree::Ptr tree = openvdb::ax::ast::parse(code.c_str());
+
+    bool access = false;
+    openvdb::ax::ast::visitNodeType<openvdb::ax::ast::FunctionCall>(*tree,
+        [&](const openvdb::ax::ast::FunctionCall& node) {
+            access |= openvdb::ax::codegen::PointComputeGenerator::isGroupAccess(node, name, write);
+        });
+    return access;
+}
+
+}
+
+void
+TestGroupAccess::testIsGroupAccess()
+{
+    std::string name;
+    bool write = true;
+
+    CPPUNIT_ASSERT(isGroupAccess("ingroup(\"a\");", name, write));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), name);
+    CPPUNIT_ASSERT(!write);
+
+    CPPUNIT_ASSERT(isGroupAccess("addtogroup(\"b\");", name, write));
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), name);
+    CPPUNIT_ASSERT(write);
+
+    CPPUNIT_ASSERT(isGroupAccess("removefromgroup(\"b\");", name, write));
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), name);
+    CPPUNIT_ASSERT(write);
+
+    // deleted points are removed by the executable rather than through a group
+
+    CPPUNIT_ASSERT(!isGroupAccess("deletepoint();", name, write));
+
+    // names which are not literals are found at runtime
+
+    CPPUNIT_ASSERT(isGroupAccess("string s = \"c\"; addtogroup(s);", name, write));
+    CPPUNIT_ASSERT(name.empty());
+    CPPUNIT_ASSERT(write);
+
+    CPPUNIT_ASSERT(!isGroupAccess("print(1.0f);", name, write));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
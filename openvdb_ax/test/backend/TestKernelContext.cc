@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/codegen/PointComputeGenerator.h>
+#include <openvdb_ax/codegen/VolumeComputeGenerator.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <cstddef>
+
+class TestKernelContext : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestKernelContext);
+    CPPUNIT_TEST(testLayout);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testLayout();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestKernelContext);
+
+void
+TestKernelContext::testLayout()
+{
+    using PointContext = openvdb::ax::codegen::ComputePointFunction::Context;
+    using VolumeContext = openvdb::ax::codegen::ComputeVolumeFunction::Context;
+
+    llvm::LLVMContext context;
+    const llvm::DataLayout layout("");
+
+    // the generated code must address the members at their host offsets
+
+    const llvm::StructLayout* point = layout.getStructLayout(PointContext::llvmType(context));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(sizeof(PointContext)), uint64_t(point->getSizeInBytes()));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(PointContext, mAttributeSet)), point->getElementOffset(1));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(PointContext, mGroupMasks)), point->getElementOffset(6));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(PointContext, mStrings)), point->getElementOffset(7));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(PointContext, mStringLiterals)), point->getElementOffset(8));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(PointContext, mLeafData)), point->getElementOffset(9));
+
+    const llvm::StructLayout* volume = layout.getStructLayout(VolumeContext::llvmType(context));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(sizeof(VolumeContext)), uint64_t(volume->getSizeInBytes()));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(VolumeContext, mCoord)), volume->getElementOffset(1));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(VolumeContext, mCoordWS)), volume->getElementOffset(2));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(VolumeContext, mAccessors)), volume->getElementOffset(3));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(offsetof(VolumeContext, mTransforms)), volume->getElementOffset(4));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/codegen/LeafArena.h>
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+#include <openvdb/points/PointAttribute.h>
+#include <openvdb/points/PointGroup.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+
+/// @brief  The number of heap allocations made through operator new by the test
+///         executable, see the replacement operators below
+std::atomic<size_t> sAllocations(0);
+
+}
+
+// replace the global allocation functions to count the allocations made by every
+// object, rather than only those the arena makes itself
+
+void* operator new(std::size_t size)
+{
+    ++sAllocations;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+class TestLeafArena : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestLeafArena);
+    CPPUNIT_TEST(testArena);
+    CPPUNIT_TEST(testSteadyState);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testArena();
+    void testSteadyState();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestLeafArena);
+
+namespace {
+
+/// @brief  Records the order in which objects are destroyed
+struct Tracked
+{
+    Tracked(std::vector<int>& destroyed, const int id)
+        : mDestroyed(destroyed), mId(id) {}
+    ~Tracked() { mDestroyed.push_back(mId); }
+
+    std::vector<int>& mDestroyed;
+    const int mId;
+};
+
+/// @brief  Creates a point grid with a given number of leaves, each holding between
+///         two and five points, with an attribute "a" stored with a codec, an attribute
+///         "c" alternating between zero and one per point, and a group "group"
+openvdb::points::PointDataGrid::Ptr createGrid(const int leaves)
+{
+    using namespace openvdb::points;
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < leaves; ++n) {
+        for (int i = 0; i <= 1 + n % 4; ++i) {
+            positions.emplace_back(float(n * 8) + float(i), 0.0f, 0.0f);
+        }
+    }
+
+    PointDataGrid::Ptr grid = unittest_util::createPointGrid(positions);
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float, TruncateCodec>::attributeType());
+    appendAttribute(grid->tree(), "c", TypedAttributeArray<float>::attributeType());
+    appendGroup(grid->tree(), "group");
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<float> c(leaf->attributeArray("c"));
+        for (openvdb::Index n = 0; n < c.size(); ++n) c.set(n, float(n % 2));
+    }
+
+    return grid;
+}
+
+}
+
+void
+TestLeafArena::testArena()
+{
+    using openvdb::ax::codegen::LeafArena;
+
+    std::vector<int> destroyed;
+    destroyed.reserve(32);
+    LeafArena arena(64);
+
+    // objects are destroyed in reverse order of creation
+
+    Tracked* first = arena.create<Tracked>(destroyed, 1);
+    arena.create<Tracked>(destroyed, 2);
+    CPPUNIT_ASSERT_EQUAL(1, first->mId);
+
+    double* values = arena.createArray<double>(100);
+    CPPUNIT_ASSERT(values);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), size_t(reinterpret_cast<uintptr_t>(values) % alignof(double)));
+    for (size_t i = 0; i < 100; ++i) CPPUNIT_ASSERT_EQUAL(0.0, values[i]);
+    CPPUNIT_ASSERT(!arena.createArray<double>(0));
+
+    arena.reset();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), destroyed.size());
+    CPPUNIT_ASSERT_EQUAL(2, destroyed[0]);
+    CPPUNIT_ASSERT_EQUAL(1, destroyed[1]);
+
+    // the memory of the first leaf is reused, so the same state allocates nothing.
+    // Results are checked once counting ends, as failed assertions allocate
+
+    bool reused = true, initialized = true;
+    const size_t allocations = sAllocations.load();
+
+    for (int leaf = 0; leaf < 10; ++leaf) {
+        Tracked* object = arena.create<Tracked>(destroyed, leaf);
+        reused &= object == first;
+        arena.create<Tracked>(destroyed, leaf);
+        values = arena.createArray<double>(100);
+        for (size_t i = 0; i < 100; ++i) initialized &= values[i] == 0.0;
+        values[0] = 1.0;
+        arena.reset();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(allocations, sAllocations.load());
+    CPPUNIT_ASSERT(reused);
+    CPPUNIT_ASSERT(initialized);
+    CPPUNIT_ASSERT_EQUAL(size_t(22), destroyed.size());
+}
+
+void
+TestLeafArena::testSteadyState()
+{
+    using namespace openvdb::points;
+
+    // reads and writes of codec attributes, positions and existing groups
+
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::PointExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::PointExecutable>(
+            "@a += 1.0f; @d = v@P.x;"
+            "if (@c > 0.5f) addtogroup(\"group\"); else removefromgroup(\"group\");"
+            "if (ingroup(\"group\")) @b = @a;", openvdb::ax::CustomData::create());
+
+    // execute with a single thread, so that the same arena executes every leaf. Once it
+    // has grown to hold the largest leaf, an execution only allocates the state of the
+    // grid, so a grid with many more leaves makes no more than a few more allocations
+
+    PointDataGrid::Ptr small = createGrid(64);
+    PointDataGrid::Ptr large = createGrid(512);
+
+    std::vector<size_t> allocations;
+    tbb::task_arena single(1);
+    single.execute([&]() {
+        for (PointDataGrid::Ptr grid : { small, large }) {
+            for (int i = 0; i < 3; ++i) {
+                const size_t start = sAllocations.load();
+                executable->execute(*grid);
+                allocations.push_back(sAllocations.load() - start);
+            }
+        }
+    });
+
+    CPPUNIT_ASSERT_EQUAL(size_t(6), allocations.size());
+    CPPUNIT_ASSERT(allocations[5] < allocations[2] + 32);
+
+    for (PointDataGrid::Ptr grid : { small, large }) {
+        for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+            AttributeHandle<float> a(leaf->constAttributeArray("a"));
+            AttributeHandle<float> b(leaf->constAttributeArray("b"));
+            AttributeHandle<float> c(leaf->constAttributeArray("c"));
+            GroupHandle group = leaf->groupHandle("group");
+            for (openvdb::Index n = 0; n < a.size(); ++n) {
+                CPPUNIT_ASSERT_EQUAL(3.0f, a.get(n));
+                CPPUNIT_ASSERT_EQUAL(c.get(n) > 0.5f, group.get(n));
+                CPPUNIT_ASSERT_EQUAL(group.get(n) ? 3.0f : 0.0f, b.get(n));
+            }
+        }
+    }
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
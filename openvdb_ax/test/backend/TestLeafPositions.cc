@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/codegen/LeafLocalData.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/math/Maps.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestLeafPositions : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestLeafPositions);
+    CPPUNIT_TEST(testRead);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testRead();
+    void testWrite();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestLeafPositions);
+
+namespace {
+
+openvdb::points::PointDataGrid::Ptr
+createGrid(const openvdb::math::Transform& transform)
+{
+    using namespace openvdb::points;
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 20; ++n) {
+        positions.emplace_back(0.3f * float(n), 0.1f * float(n % 3), -0.2f * float(n % 5));
+    }
+
+    return unittest_util::createPointGrid<FixedPointCodec<false, PositionRange>>
+        (positions, transform);
+}
+
+/// @brief  Checks the lazily computed positions of every point in every leaf of a grid
+///         against those computed by the transform
+void checkPositions(const openvdb::points::PointDataGrid& grid)
+{
+    using namespace openvdb::points;
+    using openvdb::ax::codegen::LeafLocalData;
+
+    openvdb::ax::codegen::LeafArena arena;
+
+    for (auto leaf = grid.tree().cbeginLeaf(); leaf; ++leaf) {
+
+        arena.reset();
+        LeafLocalData data(leaf->pointCount());
+        data.initPositions(*leaf, grid.transform(), arena);
+
+        AttributeHandle<openvdb::Vec3f> handle(leaf->constAttributeArray("P"));
+
+        std::vector<LeafLocalData::PositionT> expected(leaf->pointCount());
+        for (auto iter = leaf->beginIndexOn(); iter; ++iter) {
+            expected[*iter] = LeafLocalData::PositionT(grid.transform().indexToWorld(
+                iter.getCoord().asVec3d() + handle.get(*iter)));
+        }
+
+        // in order, then in reverse to exercise the voxel search
+
+        for (openvdb::Index n = 0; n < expected.size(); ++n) {
+            CPPUNIT_ASSERT(openvdb::math::isApproxEqual(expected[n], data.getPosition(n)));
+        }
+        for (openvdb::Index n = openvdb::Index(expected.size()); n > 0; --n) {
+            CPPUNIT_ASSERT(openvdb::math::isApproxEqual(expected[n-1], data.getPosition(n-1)));
+        }
+    }
+}
+
+}
+
+void
+TestLeafPositions::testRead()
+{
+    // linear transforms use the precomputed matrix
+
+    openvdb::math::Transform::Ptr transform =
+        openvdb::math::Transform::createLinearTransform(0.5);
+    transform->preRotate(0.3, openvdb::math::Y_AXIS);
+    transform->postTranslate(openvdb::Vec3d(1.0, -2.0, 3.0));
+    CPPUNIT_ASSERT(transform->isLinear());
+    checkPositions(*createGrid(*transform));
+
+    // non-linear transforms are applied through the transform
+
+    openvdb::math::MapBase::Ptr frustum(new openvdb::math::NonlinearFrustumMap(
+        openvdb::BBoxd(openvdb::Vec3d(-10.0), openvdb::Vec3d(10.0)), 0.5, 2.0));
+    openvdb::math::Transform nonlinear(frustum);
+    CPPUNIT_ASSERT(!nonlinear.isLinear());
+    checkPositions(*createGrid(nonlinear));
+}
+
+void
+TestLeafPositions::testWrite()
+{
+    using openvdb::ax::codegen::LeafLocalData;
+
+    openvdb::math::Transform::Ptr transform =
+        openvdb::math::Transform::createLinearTransform(1.0);
+    openvdb::points::PointDataGrid::Ptr grid = createGrid(*transform);
+
+    auto leaf = grid->tree().cbeginLeaf();
+    CPPUNIT_ASSERT(leaf->pointCount() >= 4);
+
+    openvdb::ax::codegen::LeafArena arena;
+    LeafLocalData data(leaf->pointCount());
+    data.initPositions(*leaf, *transform, arena);
+
+    LeafLocalData::PositionT written;
+    CPPUNIT_ASSERT(!data.getWrittenPosition(0, written));
+
+    // positions may be written in any order and overwritten
+
+    data.setPosition(LeafLocalData::PositionT(3.0f), 3);
+    data.setPosition(LeafLocalData::PositionT(1.0f), 1);
+    data.setPosition(LeafLocalData::PositionT(2.0f), 2);
+    data.setPosition(LeafLocalData::PositionT(4.0f), 1);
+
+    CPPUNIT_ASSERT_EQUAL(LeafLocalData::PositionT(4.0f), data.getPosition(1));
+    CPPUNIT_ASSERT_EQUAL(LeafLocalData::PositionT(2.0f), data.getPosition(2));
+
+    // written positions are kept once reads are released
+
+    data.releasePositions();
+
+    CPPUNIT_ASSERT(!data.getWrittenPosition(0, written));
+    CPPUNIT_ASSERT(data.getWrittenPosition(1, written));
+    CPPUNIT_ASSERT_EQUAL(LeafLocalData::PositionT(4.0f), written);
+    CPPUNIT_ASSERT(data.getWrittenPosition(2, written));
+    CPPUNIT_ASSERT_EQUAL(LeafLocalData::PositionT(2.0f), written);
+    CPPUNIT_ASSERT(data.getWrittenPosition(3, written));
+    CPPUNIT_ASSERT_EQUAL(LeafLocalData::PositionT(3.0f), written);
+}
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
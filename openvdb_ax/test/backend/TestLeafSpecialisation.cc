@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/ast/AST.h>
+#include <openvdb_ax/codegen/FunctionRegistry.h>
+#include <openvdb_ax/codegen/PointComputeGenerator.h>
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestLeafSpecialisation : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestLeafSpecialisation);
+    CPPUNIT_TEST(testPointInvariant);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testPointInvariant();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestLeafSpecialisation);
+
+namespace {
+
+bool isPointInvariant(const std::string& code)
+{
+    const openvdb::ax::FunctionOptions options;
+    openvdb::ax::codegen::FunctionRegistry::UniquePtr registry =
+        openvdb::ax::codegen::createStandardRegistry(options);
+    const openvdb::ax::ast::Tree::Ptr tree = openvdb::ax::ast::parse(code.c_str());
+    return openvdb::ax::codegen::PointComputeGenerator::isPointInvariant(*tree,
+        *registry, options);
+}
+
+}
+
+void
+TestLeafSpecialisation::testPointInvariant()
+{
+    CPPUNIT_ASSERT(isPointInvariant("@b = @a * 2.0f;"));
+    CPPUNIT_ASSERT(isPointInvariant("if (@a > 1.0f) @b = sqrt(@a); else @b = 0.0f;"));
+    CPPUNIT_ASSERT(isPointInvariant("@b = clamp(pow(@a, 2.0f), 0.0f, 1.0f);"));
+
+    CPPUNIT_ASSERT(!isPointInvariant("@a = v@P.x;"));
+    CPPUNIT_ASSERT(!isPointInvariant("@a = rand(@b);"));
+    CPPUNIT_ASSERT(!isPointInvariant("if (ingroup(\"group\")) @a = 1.0f;"));
+    CPPUNIT_ASSERT(!isPointInvariant("s@s = \"foo\";"));
+    CPPUNIT_ASSERT(!isPointInvariant("print(@a);"));
+
+    // functions which are not registered or not marked as pure are never invariant
+
+    CPPUNIT_ASSERT(!isPointInvariant("@a = unknownfunction(@b);"));
+    CPPUNIT_ASSERT(!isPointInvariant("@a = getattribute(@b);"));
+
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    CPPUNIT_ASSERT(compiler->compile<openvdb::ax::PointExecutable>("@b = @a;",
+        openvdb::ax::CustomData::create())->isPointInvariant());
+    CPPUNIT_ASSERT(!compiler->compile<openvdb::ax::PointExecutable>("@b = rand(@a);",
+        openvdb::ax::CustomData::create())->isPointInvariant());
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/codegen/LeafLocalData.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArrayString.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestLeafStrings : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestLeafStrings);
+    CPPUNIT_TEST(testSet);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testSet();
+    void testWrite();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestLeafStrings);
+
+void
+TestLeafStrings::testSet()
+{
+    using openvdb::ax::codegen::LeafLocalData;
+
+    openvdb::points::StringAttributeArray a(8), b(8);
+    LeafLocalData data(8);
+
+    std::string value;
+    CPPUNIT_ASSERT(!data.hasNewStrings());
+    CPPUNIT_ASSERT(!data.getNewStringData(&a, 0, value));
+
+    // strings are held per array and may be overwritten or removed
+
+    data.setNewStringData(&a, 0, "foo");
+    data.setNewStringData(&a, 1, "foo");
+    data.setNewStringData(&b, 1, "bar");
+    data.setNewStringData(&a, 2, "baz");
+    data.setNewStringData(&a, 2, "");
+    data.setNewStringData(&a, 3, "qux");
+    data.removeNewStringData(&a, 3);
+    data.removeNewStringData(&b, 0);
+
+    CPPUNIT_ASSERT(data.hasNewStrings());
+
+    CPPUNIT_ASSERT(data.getNewStringData(&a, 0, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("foo"), value);
+    CPPUNIT_ASSERT(data.getNewStringData(&a, 1, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("foo"), value);
+    CPPUNIT_ASSERT(data.getNewStringData(&b, 1, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("bar"), value);
+    CPPUNIT_ASSERT(data.getNewStringData(&a, 2, value));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), value);
+    CPPUNIT_ASSERT(!data.getNewStringData(&a, 3, value));
+    CPPUNIT_ASSERT(!data.getNewStringData(&b, 0, value));
+
+    // only the strings which are still held are collected, once each
+
+    std::set<std::string> strings;
+    data.getNewStrings(strings);
+    CPPUNIT_ASSERT_EQUAL(std::set<std::string>({ "", "bar", "foo" }), strings);
+}
+
+void
+TestLeafStrings::testWrite()
+{
+    using openvdb::ax::codegen::LeafLocalData;
+    using namespace openvdb::points;
+
+    StringAttributeArray array(4);
+    openvdb::MetaMap metadata;
+
+    {
+        StringMetaInserter inserter(metadata);
+        inserter.insert("foo");
+        inserter.insert("bar");
+    }
+
+    LeafLocalData data(4);
+    data.setNewStringData(&array, 0, "bar");
+    data.setNewStringData(&array, 2, "foo");
+    data.setNewStringData(&array, 3, "bar");
+
+    // indices are one plus the index of the metadata entry
+
+    LeafLocalData::StringIndexMap indices;
+    indices["foo"] = 1;
+    indices["bar"] = 2;
+    data.writeNewStrings(indices);
+
+    StringAttributeHandle handle(array, metadata);
+    CPPUNIT_ASSERT_EQUAL(openvdb::Name("bar"), handle.get(0));
+    CPPUNIT_ASSERT_EQUAL(openvdb::Name(""), handle.get(1));
+    CPPUNIT_ASSERT_EQUAL(openvdb::Name("foo"), handle.get(2));
+    CPPUNIT_ASSERT_EQUAL(openvdb::Name("bar"), handle.get(3));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
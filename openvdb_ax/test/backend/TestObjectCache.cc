@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/ObjectCache.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <future>
+
+class TestObjectCache : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestObjectCache);
+    CPPUNIT_TEST(testCompile);
+    CPPUNIT_TEST(testConcurrentCompile);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testCompile();
+    void testConcurrentCompile();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestObjectCache);
+
+void
+TestObjectCache::testCompile()
+{
+    using openvdb::ax::Compiler;
+    using openvdb::ax::CustomData;
+    using openvdb::ax::ObjectCache;
+    using openvdb::ax::VolumeExecutable;
+
+    llvm::SmallString<256> directory;
+    CPPUNIT_ASSERT(!llvm::sys::fs::createUniqueDirectory("ax_object_cache", directory));
+
+    const std::string code = "@a = 2.0f; @b = lookupf(\"value\");";
+
+    ObjectCache::Ptr cache = ObjectCache::create(directory.str());
+
+    openvdb::FloatGrid::Ptr a = openvdb::FloatGrid::create();
+    openvdb::FloatGrid::Ptr b = openvdb::FloatGrid::create();
+    a->setName("a");
+    b->setName("b");
+    a->tree().setValueOn(openvdb::Coord(0));
+    b->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { a, b };
+
+    // cold compilation - volume blocks are compiled on execution, each is a miss and
+    // store
+
+    {
+        Compiler::UniquePtr compiler = Compiler::create();
+        compiler->setObjectCache(cache);
+        VolumeExecutable::Ptr executable =
+            compiler->compile<VolumeExecutable>(code, CustomData::create());
+
+        ObjectCache::Statistics stats = cache->statistics();
+        CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mMisses);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mStores);
+
+        executable->execute(grids);
+
+        stats = cache->statistics();
+        CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mHits);
+        CPPUNIT_ASSERT_EQUAL(size_t(2), stats.mMisses);
+        CPPUNIT_ASSERT_EQUAL(size_t(2), stats.mStores);
+    }
+
+    cache->resetStatistics();
+
+    // warm compilation from a new compiler and cache instance - objects are loaded and
+    // must be valid for different custom data
+
+    cache = ObjectCache::create(directory.str());
+
+    CustomData::Ptr data = CustomData::create();
+    data->insertData("value", openvdb::TypedMetadata<float>::Ptr(
+        new openvdb::TypedMetadata<float>(5.0f)));
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->setObjectCache(cache);
+    VolumeExecutable::Ptr executable = compiler->compile<VolumeExecutable>(code, data);
+
+    executable->execute(grids);
+
+    const ObjectCache::Statistics stats = cache->statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), stats.mHits);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mMisses);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mStores);
+
+    CPPUNIT_ASSERT_EQUAL(2.0f, a->tree().getValue(openvdb::Coord(0)));
+    CPPUNIT_ASSERT_EQUAL(5.0f, b->tree().getValue(openvdb::Coord(0)));
+
+    llvm::sys::fs::remove_directories(directory);
+}
+
+void
+TestObjectCache::testConcurrentCompile()
+{
+    using openvdb::ax::Compiler;
+    using openvdb::ax::CustomData;
+    using openvdb::ax::ObjectCache;
+    using openvdb::ax::VolumeExecutable;
+
+    llvm::SmallString<256> directory;
+    CPPUNIT_ASSERT(!llvm::sys::fs::createUniqueDirectory("ax_object_cache", directory));
+
+    const std::string code = "@a = 2.0f; @b = 3.0f;";
+
+    ObjectCache::Ptr cache = ObjectCache::create(directory.str());
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->setObjectCache(cache);
+
+    openvdb::FloatGrid::Ptr a = openvdb::FloatGrid::create();
+    openvdb::FloatGrid::Ptr b = openvdb::FloatGrid::create();
+    a->setName("a");
+    b->setName("b");
+    a->tree().setValueOn(openvdb::Coord(0));
+    b->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { a, b };
+
+    compiler->compile<VolumeExecutable>(code, CustomData::create())->execute(grids);
+    cache->resetStatistics();
+
+    // overlapping compilations of the same program each load their own objects
+
+    std::future<VolumeExecutable::Ptr> first =
+        compiler->compileAsync<VolumeExecutable>(code, CustomData::create());
+    std::future<VolumeExecutable::Ptr> second =
+        compiler->compileAsync<VolumeExecutable>(code, CustomData::create());
+
+    const VolumeExecutable::Ptr executable1 = first.get();
+    const VolumeExecutable::Ptr executable2 = second.get();
+    executable1->compileBlocks();
+    executable2->compileBlocks();
+
+    const ObjectCache::Statistics stats = cache->statistics();
+    CPPUNIT_ASSERT_EQUAL(size_t(4), stats.mHits);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mMisses);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.mStores);
+
+    for (const VolumeExecutable::Ptr& executable : { executable1, executable2 }) {
+        a->tree().setValueOn(openvdb::Coord(0), 0.0f);
+        b->tree().setValueOn(openvdb::Coord(0), 0.0f);
+        executable->execute(grids);
+        CPPUNIT_ASSERT_EQUAL(2.0f, a->tree().getValue(openvdb::Coord(0)));
+        CPPUNIT_ASSERT_EQUAL(3.0f, b->tree().getValue(openvdb::Coord(0)));
+    }
+
+    llvm::sys::fs::remove_directories(directory);
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/ast/AST.h>
+#include <openvdb_ax/codegen/FunctionRegistry.h>
+#include <openvdb_ax/codegen/PointComputeGenerator.h>
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/Exceptions.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+#include <openvdb/points/PointAttribute.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Type.h>
+
+class TestPointVectorisation : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestPointVectorisation);
+    CPPUNIT_TEST(testVectorizable);
+    CPPUNIT_TEST(testGenerate);
+    CPPUNIT_TEST(testExecute);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testVectorizable();
+    void testGenerate();
+    void testExecute();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPointVectorisation);
+
+namespace {
+
+bool isVectorizable(const std::string& code)
+{
+    const openvdb::ax::FunctionOptions options;
+    openvdb::ax::codegen::FunctionRegistry::UniquePtr registry =
+        openvdb::ax::codegen::createStandardRegistry(options);
+    const openvdb::ax::ast::Tree::Ptr tree = openvdb::ax::ast::parse(code.c_str());
+    return openvdb::ax::codegen::PointComputeGenerator::isVectorizable(*tree,
+        *registry, options);
+}
+
+/// @brief  Generates a point module, returning true if its point loop is marked
+///         for vectorisation. Marked loops are checked to contain vector code once the
+///         module is optimised
+bool generate(const std::string& code, const size_t width)
+{
+    using namespace openvdb::ax;
+
+    const ast::Tree::Ptr tree = ast::parse(code.c_str());
+
+    const FunctionOptions options;
+    codegen::FunctionRegistry::UniquePtr registry = codegen::createStandardRegistry(options);
+    CustomData::Ptr data = CustomData::create();
+
+    llvm::LLVMContext context;
+    llvm::Module module("module", context);
+
+    codegen::PointComputeGenerator generator(module, data.get(), options, *registry,
+        nullptr, width);
+    tree->accept(generator);
+
+    const llvm::Function* range =
+        module.getFunction(codegen::ComputePointRangeFunction::Name);
+    CPPUNIT_ASSERT(range);
+
+    bool vectorized = false;
+    for (const llvm::BasicBlock& block : *range) {
+        if (block.getTerminator()->getMetadata(llvm::LLVMContext::MD_loop)) vectorized = true;
+    }
+
+    const llvm::Function* point = module.getFunction(codegen::ComputePointFunction::Name);
+    CPPUNIT_ASSERT(point);
+    CPPUNIT_ASSERT_EQUAL(vectorized, point->hasFnAttribute(llvm::Attribute::AlwaysInline));
+
+    if (!vectorized) return false;
+
+    CompilerOptions compilerOptions;
+    compilerOptions.optLevel = CompilerOptions::OptLevel::O3;
+    compilerOptions.pointVectorWidth = width;
+    optimiseAndVerify(module, compilerOptions);
+
+    // the optimised point loop should operate on <width x float> values
+
+    range = module.getFunction(codegen::ComputePointRangeFunction::Name);
+    CPPUNIT_ASSERT(range);
+
+    bool vectorCode = false;
+    for (const llvm::BasicBlock& block : *range) {
+        for (const llvm::Instruction& instruction : block) {
+            llvm::Type* type = instruction.getType();
+            if (!type->isVectorTy() || !type->getVectorElementType()->isFloatTy()) continue;
+            if (type->getVectorNumElements() == width) vectorCode = true;
+        }
+    }
+    CPPUNIT_ASSERT(vectorCode);
+
+    return true;
+}
+
+}
+
+void
+TestPointVectorisation::testVectorizable()
+{
+    CPPUNIT_ASSERT(isVectorizable("@a *= 2.0f;"));
+    CPPUNIT_ASSERT(isVectorizable("if (@a > 1.0f) @b = sqrt(@a); else @b = 0.0f;"));
+
+    CPPUNIT_ASSERT(!isVectorizable("@a = v@P.x;"));
+    CPPUNIT_ASSERT(!isVectorizable("@a = rand(@b);"));
+    CPPUNIT_ASSERT(!isVectorizable("if (@a > 1.0f) deletepoint();"));
+    CPPUNIT_ASSERT(!isVectorizable("addtogroup(\"group\");"));
+    CPPUNIT_ASSERT(!isVectorizable("string s = \"foo\";"));
+}
+
+void
+TestPointVectorisation::testGenerate()
+{
+    using namespace openvdb::ax;
+
+    CPPUNIT_ASSERT(generate("@a *= 2.0f;", 8));
+    CPPUNIT_ASSERT(!generate("@a *= 2.0f;", 0));
+    CPPUNIT_ASSERT(!generate("@a = rand(@b);", 8));
+
+    CPPUNIT_ASSERT_THROW(generate("@a *= 2.0f;", 3), AXCompilerError);
+}
+
+void
+TestPointVectorisation::testExecute()
+{
+    using namespace openvdb::ax;
+    using namespace openvdb::points;
+
+    // a point count which is not a multiple of any vector width, to exercise the tail
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 37; ++n) positions.emplace_back(float(n % 7), float(n / 7), 0.0f);
+
+    PointDataGrid::Ptr grid = unittest_util::createPointGrid(positions);
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    appendAttribute(grid->tree(), "b", TypedAttributeArray<float>::attributeType());
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) a.set(n, float(n));
+    }
+
+    for (const size_t width : { 4, 8, 16 }) {
+        CompilerOptions options;
+        options.pointVectorWidth = width;
+        Compiler::UniquePtr compiler = Compiler::create(options);
+
+        PointExecutable::Ptr executable = compiler->compile<PointExecutable>(
+            "if (@a > 10.0f) @b = @a * 2.0f; else @b = -1.0f;", CustomData::create());
+        executable->execute(*grid);
+
+        for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+            AttributeHandle<float> a(leaf->constAttributeArray("a"));
+            AttributeHandle<float> b(leaf->constAttributeArray("b"));
+            for (openvdb::Index n = 0; n < a.size(); ++n) {
+                const float expected = a.get(n) > 10.0f ? a.get(n) * 2.0f : -1.0f;
+                CPPUNIT_ASSERT_EQUAL(expected, b.get(n));
+            }
+        }
+    }
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/PointCount.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+
+class TestPositionUpdate : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestPositionUpdate);
+    CPPUNIT_TEST(testInPlace);
+    CPPUNIT_TEST(testMove);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testInPlace();
+    void testMove();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPositionUpdate);
+
+namespace {
+
+/// @brief  Returns the sorted world space positions of the points of a grid
+std::vector<openvdb::Vec3d>
+worldPositions(const openvdb::points::PointDataGrid& grid)
+{
+    std::vector<openvdb::Vec3d> positions;
+    for (auto leaf = grid.tree().cbeginLeaf(); leaf; ++leaf) {
+        openvdb::points::AttributeHandle<openvdb::Vec3f> handle(leaf->constAttributeArray("P"));
+        for (auto iter = leaf->beginIndexOn(); iter; ++iter) {
+            positions.emplace_back(grid.transform().indexToWorld(
+                iter.getCoord().asVec3d() + handle.get(*iter)));
+        }
+    }
+
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+const std::vector<openvdb::Vec3s> sPositions {
+    openvdb::Vec3s(0.0f, 0.0f, 0.0f),
+    openvdb::Vec3s(1.0f, 2.0f, 3.0f),
+    openvdb::Vec3s(10.0f, 0.0f, -5.0f),
+    openvdb::Vec3s(20.0f, 20.0f, 20.0f)
+};
+
+}
+
+void
+TestPositionUpdate::testInPlace()
+{
+    openvdb::points::PointDataGrid::Ptr grid = unittest_util::createPointGrid(sPositions);
+    const openvdb::Index64 leafCount = grid->tree().leafCount();
+
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::PointExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::PointExecutable>("v@P += {0.25f, -0.125f, 0.0f};",
+            openvdb::ax::CustomData::create());
+
+    size_t moved = 1;
+    executable->execute(*grid, nullptr, &moved);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), moved);
+
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(sPositions.size()),
+        openvdb::points::pointCount(grid->tree()));
+    CPPUNIT_ASSERT_EQUAL(leafCount, grid->tree().leafCount());
+
+    std::vector<openvdb::Vec3d> expected;
+    for (const openvdb::Vec3s& pos : sPositions) {
+        expected.emplace_back(openvdb::Vec3d(pos) + openvdb::Vec3d(0.25, -0.125, 0.0));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    const std::vector<openvdb::Vec3d> result = worldPositions(*grid);
+    CPPUNIT_ASSERT_EQUAL(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        CPPUNIT_ASSERT(openvdb::math::isApproxEqual(expected[i], result[i]));
+    }
+}
+
+void
+TestPositionUpdate::testMove()
+{
+    openvdb::points::PointDataGrid::Ptr grid = unittest_util::createPointGrid(sPositions);
+
+    // only the first two points cross into another voxel
+
+    openvdb::ax::Compiler::UniquePtr compiler = openvdb::ax::Compiler::create();
+    openvdb::ax::PointExecutable::Ptr executable =
+        compiler->compile<openvdb::ax::PointExecutable>(
+            "if (v@P.x < 5.0f) v@P += {20.0f, 0.0f, 0.0f}; else v@P += {0.1f, 0.0f, 0.0f};",
+            openvdb::ax::CustomData::create());
+
+    size_t moved = 0;
+    executable->execute(*grid, nullptr, &moved);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), moved);
+
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(sPositions.size()),
+        openvdb::points::pointCount(grid->tree()));
+
+    std::vector<openvdb::Vec3d> expected {
+        openvdb::Vec3d(20.0, 0.0, 0.0),
+        openvdb::Vec3d(21.0, 2.0, 3.0),
+        openvdb::Vec3d(10.1, 0.0, -5.0),
+        openvdb::Vec3d(20.1, 20.0, 20.0)
+    };
+    std::sort(expected.begin(), expected.end());
+
+    const std::vector<openvdb::Vec3d> result = worldPositions(*grid);
+    CPPUNIT_ASSERT_EQUAL(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        CPPUNIT_ASSERT(openvdb::math::isApproxEqual(expected[i], result[i],
+            openvdb::Vec3d(1e-5)));
+    }
+}
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
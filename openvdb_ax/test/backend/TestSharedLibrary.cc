@@ -0,0 +1,187 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "test/util.h"
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/PointExecutable.h>
+#include <openvdb_ax/compiler/SharedLibrary.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+#include <openvdb_ax/Exceptions.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/points/AttributeArray.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+class TestSharedLibrary : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestSharedLibrary);
+    CPPUNIT_TEST(testManifest);
+    CPPUNIT_TEST(testVolume);
+    CPPUNIT_TEST(testPoint);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testManifest();
+    void testVolume();
+    void testPoint();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSharedLibrary);
+
+namespace {
+
+std::string libraryPath()
+{
+    int fd;
+    llvm::SmallString<256> path;
+    CPPUNIT_ASSERT(!llvm::sys::fs::createTemporaryFile("ax_test", "so", fd, path));
+    llvm::sys::fs::remove(path);
+    return path.str().str();
+}
+
+}
+
+void
+TestSharedLibrary::testManifest()
+{
+    using openvdb::ax::SharedLibraryManifest;
+
+    SharedLibraryManifest manifest;
+    manifest.mExecutable = "volume";
+    manifest.mFunctions = { { "compute_volume_0" }, { "compute_volume_1" } };
+    manifest.mData = { { "a", "float", true }, { "b", "vec3s", false } };
+    manifest.mGroups = { { "g", true } };
+    manifest.mDynamicGroupWrites = true;
+    manifest.mStrings = { "", "a b" };
+    manifest.mAssignedVolumes = { "a" };
+    manifest.mPointInvariant = true;
+    manifest.mImports = { "lookupf" };
+
+    const SharedLibraryManifest result =
+        SharedLibraryManifest::deserialize(manifest.serialize());
+
+    CPPUNIT_ASSERT_EQUAL(manifest.mExecutable, result.mExecutable);
+    CPPUNIT_ASSERT(manifest.mFunctions == result.mFunctions);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), result.mData.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), result.mData[1].mName);
+    CPPUNIT_ASSERT_EQUAL(std::string("vec3s"), result.mData[1].mType);
+    CPPUNIT_ASSERT(result.mData[0].mWriteable);
+    CPPUNIT_ASSERT(!result.mData[1].mWriteable);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), result.mGroups.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("g"), result.mGroups[0].mName);
+    CPPUNIT_ASSERT(result.mGroups[0].mWriteable);
+    CPPUNIT_ASSERT(result.mDynamicGroupWrites);
+    CPPUNIT_ASSERT(manifest.mStrings == result.mStrings);
+    CPPUNIT_ASSERT(manifest.mAssignedVolumes == result.mAssignedVolumes);
+    CPPUNIT_ASSERT(result.mPointInvariant);
+    CPPUNIT_ASSERT(manifest.mImports == result.mImports);
+
+    // names must not contain whitespace
+
+    manifest.mAssignedVolumes = { "a b" };
+    CPPUNIT_ASSERT_THROW(manifest.serialize(), openvdb::ax::AXCompilerError);
+    CPPUNIT_ASSERT_THROW(SharedLibraryManifest::deserialize("invalid"),
+        openvdb::ax::AXCompilerError);
+}
+
+void
+TestSharedLibrary::testVolume()
+{
+    using namespace openvdb::ax;
+
+    const std::string path = libraryPath();
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->compileToSharedLibrary<VolumeExecutable>
+        ("@a = 2.0f; @b = lookupf(\"value\");", path);
+
+    // loaded with data which did not exist at compile time
+
+    CustomData::Ptr data = CustomData::create();
+    data->insertData("value", openvdb::TypedMetadata<float>::Ptr(
+        new openvdb::TypedMetadata<float>(5.0f)));
+
+    VolumeExecutable::Ptr executable = loadExecutable<VolumeExecutable>(path, data);
+    CPPUNIT_ASSERT(executable);
+    CPPUNIT_ASSERT_THROW(loadExecutable<PointExecutable>(path), AXCompilerError);
+
+    openvdb::FloatGrid::Ptr a = openvdb::FloatGrid::create();
+    openvdb::FloatGrid::Ptr b = openvdb::FloatGrid::create();
+    a->setName("a");
+    b->setName("b");
+    a->tree().setValueOn(openvdb::Coord(0));
+    b->tree().setValueOn(openvdb::Coord(0));
+
+    openvdb::GridPtrVec grids { a, b };
+    executable->execute(grids);
+
+    CPPUNIT_ASSERT_EQUAL(2.0f, a->tree().getValue(openvdb::Coord(0)));
+    CPPUNIT_ASSERT_EQUAL(5.0f, b->tree().getValue(openvdb::Coord(0)));
+
+    executable.reset();
+    llvm::sys::fs::remove(path);
+}
+
+void
+TestSharedLibrary::testPoint()
+{
+    using namespace openvdb::ax;
+
+    const std::string path = libraryPath();
+
+    Compiler::UniquePtr compiler = Compiler::create();
+    compiler->compileToSharedLibrary<PointExecutable>("@a = 3.0f;", path);
+
+    PointExecutable::Ptr executable = loadExecutable<PointExecutable>(path);
+    CPPUNIT_ASSERT(executable);
+
+    openvdb::points::PointDataGrid::Ptr grid = unittest_util::createPointGrid({ {0, 0, 0} });
+
+    executable->execute(*grid);
+
+    const auto leafIter = grid->tree().cbeginLeaf();
+    CPPUNIT_ASSERT(leafIter);
+
+    openvdb::points::AttributeHandle<float> handle(leafIter->constAttributeArray("a"));
+    CPPUNIT_ASSERT_EQUAL(3.0f, handle.get(0));
+
+    executable.reset();
+    llvm::sys::fs::remove(path);
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
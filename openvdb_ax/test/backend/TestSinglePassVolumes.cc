@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+#include <openvdb_ax/Exceptions.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestSinglePassVolumes : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestSinglePassVolumes);
+    CPPUNIT_TEST(testExecute);
+    CPPUNIT_TEST(testTopologyUnion);
+    CPPUNIT_TEST(testTransformMismatch);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testExecute();
+    void testTopologyUnion();
+    void testTransformMismatch();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSinglePassVolumes);
+
+namespace {
+
+const std::string sCode = "@a = 1.0f; @b = @a + 1.0f; @c = @b * 2.0f;";
+
+openvdb::ax::VolumeExecutable::Ptr
+compile(const bool singlePass)
+{
+    using namespace openvdb::ax;
+
+    CompilerOptions options;
+    options.singlePassVolumes = singlePass;
+
+    Compiler::UniquePtr compiler = Compiler::create(options);
+    return compiler->compile<VolumeExecutable>(sCode, CustomData::create());
+}
+
+openvdb::GridPtrVec createGrids()
+{
+    openvdb::GridPtrVec grids;
+    for (const std::string name : { "a", "b", "c" }) {
+        openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create();
+        grid->setName(name);
+        grid->tree().setValueOn(openvdb::Coord(0));
+        grid->tree().setValueOn(openvdb::Coord(20));
+        grids.push_back(grid);
+    }
+    return grids;
+}
+
+inline float value(const openvdb::GridBase::Ptr& grid, const openvdb::Coord& coord)
+{
+    return openvdb::StaticPtrCast<openvdb::FloatGrid>(grid)->tree().getValue(coord);
+}
+
+}
+
+void
+TestSinglePassVolumes::testExecute()
+{
+    using namespace openvdb::ax;
+
+    VolumeExecutable::Ptr singlePass = compile(true);
+    VolumeExecutable::Ptr multiPass = compile(false);
+
+    CPPUNIT_ASSERT(singlePass->isSinglePass());
+    CPPUNIT_ASSERT(!multiPass->isSinglePass());
+
+    // volumes which share topology produce the same results in either mode
+
+    openvdb::GridPtrVec singlePassGrids = createGrids();
+    openvdb::GridPtrVec multiPassGrids = createGrids();
+
+    singlePass->execute(singlePassGrids);
+    multiPass->execute(multiPassGrids);
+
+    for (const openvdb::Coord coord : { openvdb::Coord(0), openvdb::Coord(20) }) {
+        CPPUNIT_ASSERT_EQUAL(1.0f, value(singlePassGrids[0], coord));
+        CPPUNIT_ASSERT_EQUAL(2.0f, value(singlePassGrids[1], coord));
+        CPPUNIT_ASSERT_EQUAL(4.0f, value(singlePassGrids[2], coord));
+
+        for (size_t i = 0; i < singlePassGrids.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(value(multiPassGrids[i], coord),
+                value(singlePassGrids[i], coord));
+        }
+    }
+}
+
+void
+TestSinglePassVolumes::testTopologyUnion()
+{
+    using namespace openvdb::ax;
+
+    VolumeExecutable::Ptr executable = compile(true);
+
+    // voxels active in any assigned volume are visited, but each volume is only written
+    // at its own active voxels, leaving the results and active states of multi pass
+    // execution unchanged
+
+    openvdb::GridPtrVec grids = createGrids();
+    openvdb::GridPtrVec multiPassGrids = createGrids();
+    for (openvdb::GridPtrVec* set : { &grids, &multiPassGrids }) {
+        openvdb::StaticPtrCast<openvdb::FloatGrid>((*set)[1])->tree().setValueOn(openvdb::Coord(1000));
+    }
+
+    executable->execute(grids);
+    compile(false)->execute(multiPassGrids);
+
+    openvdb::FloatGrid::Ptr a = openvdb::StaticPtrCast<openvdb::FloatGrid>(grids[0]);
+    openvdb::FloatGrid::Ptr b = openvdb::StaticPtrCast<openvdb::FloatGrid>(grids[1]);
+
+    CPPUNIT_ASSERT_EQUAL(0.0f, value(grids[0], openvdb::Coord(1000)));
+    CPPUNIT_ASSERT_EQUAL(1.0f, value(grids[1], openvdb::Coord(1000)));
+    CPPUNIT_ASSERT_EQUAL(0.0f, value(grids[2], openvdb::Coord(1000)));
+
+    for (size_t i = 0; i < grids.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(value(multiPassGrids[i], openvdb::Coord(1000)),
+            value(grids[i], openvdb::Coord(1000)));
+    }
+
+    CPPUNIT_ASSERT(!a->tree().isValueOn(openvdb::Coord(1000)));
+    CPPUNIT_ASSERT(b->tree().isValueOn(openvdb::Coord(1000)));
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(2), grids[2]->activeVoxelCount());
+}
+
+void
+TestSinglePassVolumes::testTransformMismatch()
+{
+    using namespace openvdb::ax;
+
+    VolumeExecutable::Ptr executable = compile(true);
+
+    openvdb::GridPtrVec grids = createGrids();
+    grids[2]->setTransform(openvdb::math::Transform::createLinearTransform(0.5));
+
+    CPPUNIT_ASSERT_THROW(executable->execute(grids), AXExecutionError);
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
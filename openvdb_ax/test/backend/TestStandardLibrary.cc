@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/codegen/FunctionRegistry.h>
+#include <openvdb_ax/codegen/StandardLibrary.h>
+#include <openvdb_ax/compiler/Compiler.h>
+#include <openvdb_ax/compiler/CompilerOptions.h>
+#include <openvdb_ax/compiler/VolumeExecutable.h>
+
+#include <openvdb/openvdb.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+
+#include <string>
+#include <vector>
+
+class TestStandardLibrary : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestStandardLibrary);
+    CPPUNIT_TEST(testLink);
+    CPPUNIT_TEST(testExecute);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testLink();
+    void testExecute();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestStandardLibrary);
+
+void
+TestStandardLibrary::testLink()
+{
+    using namespace openvdb::ax;
+
+    // declare every external function of the standard registry
+
+    const FunctionOptions options;
+    codegen::FunctionRegistry::UniquePtr registry = codegen::createStandardRegistry(options);
+    registry->createAll(options);
+
+    llvm::LLVMContext context;
+    llvm::Module module("module", context);
+
+    for (const auto& iter : registry->map()) {
+        const codegen::FunctionBase::Ptr function = iter.second.function();
+        if (!function) continue;
+        for (const codegen::FunctionSignatureBase::Ptr& signature : function->list()) {
+            if (!signature->functionPointer()) continue;
+            if (module.getFunction(signature->symbolName())) continue;
+            std::vector<llvm::Type*> types;
+            llvm::Type* returnType = signature->toLLVMTypes(context, &types);
+            llvm::Function::Create(llvm::FunctionType::get(returnType, types, false),
+                llvm::GlobalValue::ExternalLinkage, signature->symbolName(), &module);
+        }
+    }
+
+    // builds without clang embed an empty library, which links nothing
+
+    if (!codegen::hasStandardLibrary()) {
+        CPPUNIT_ASSERT_EQUAL(size_t(0), codegen::linkStandardLibrary(module));
+        return;
+    }
+
+    CPPUNIT_ASSERT(codegen::linkStandardLibrary(module) > 0);
+    CPPUNIT_ASSERT(!llvm::verifyModule(module));
+
+    const std::vector<std::string> linked {
+        "dot<float>", "cross<double>", "normalize<float>", "Length::length<double>",
+        "LengthSq::lensq<int32_t>", "openvdb::math::Clamp<float>", "Min::min<int32_t>"
+    };
+
+    for (const std::string& name : linked) {
+        const llvm::Function* function = module.getFunction(name);
+        CPPUNIT_ASSERT_MESSAGE(name, function);
+        CPPUNIT_ASSERT_MESSAGE(name, !function->isDeclaration());
+        CPPUNIT_ASSERT_MESSAGE(name, function->hasInternalLinkage());
+    }
+
+    // functions with host state are always called through their pointers
+
+    const llvm::Function* lookup = module.getFunction("Lookup::lookup<float>");
+    CPPUNIT_ASSERT(!lookup || lookup->isDeclaration());
+
+    // nothing to link into a module without declarations
+
+    llvm::Module empty("empty", context);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), codegen::linkStandardLibrary(empty));
+}
+
+void
+TestStandardLibrary::testExecute()
+{
+    using namespace openvdb::ax;
+
+    const std::string code =
+        "vec3f v = {3.0f, 4.0f, 0.0f};"
+        "vec3f n = normalize(v);"
+        "@a = length(v) + dot(n, v) + lengthsq(cross(n, v)) + clamp(7.0f, 0.0f, 2.0f) + "
+        "    min(1.0f, 2.0f) + max(-1.0f, -2.0f);";
+
+    // the linked definitions must match the host functions
+
+    for (const bool bitcode : { true, false }) {
+        CompilerOptions options;
+        options.functionOptions.mStandardLibraryBitcode = bitcode;
+        Compiler::UniquePtr compiler = Compiler::create(options);
+
+        VolumeExecutable::Ptr executable =
+            compiler->compile<VolumeExecutable>(code, CustomData::create());
+
+        openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create();
+        grid->setName("a");
+        grid->tree().setValueOn(openvdb::Coord(0));
+
+        openvdb::GridPtrVec grids { grid };
+        executable->execute(grids);
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(12.0f, grid->tree().getValue(openvdb::Coord(0)), 1e-5f);
+    }
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
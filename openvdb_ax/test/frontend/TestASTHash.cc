@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <openvdb_ax/ast/AST.h>
+#include <openvdb_ax/ast/Hash.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+#include <vector>
+
+class TestASTHash : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestASTHash);
+    CPPUNIT_TEST(testEquivalentTrees);
+    CPPUNIT_TEST(testDistinctTrees);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testEquivalentTrees();
+    void testDistinctTrees();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestASTHash);
+
+void
+TestASTHash::testEquivalentTrees()
+{
+    using namespace openvdb::ax::ast;
+
+    const Tree::Ptr tree1 = parse("@a = 1.0f + @b;");
+    const Tree::Ptr tree2 = parse("@a   =  1.0f+@b ;");
+    CPPUNIT_ASSERT_EQUAL(hash(*tree1), hash(*tree2));
+
+    const Tree::Ptr copy(tree1->copy());
+    CPPUNIT_ASSERT_EQUAL(hash(*tree1), hash(*copy));
+
+    CPPUNIT_ASSERT_EQUAL(hashCombine(hash(*tree1), "test"),
+        hashCombine(hash(*tree2), "test"));
+}
+
+void
+TestASTHash::testDistinctTrees()
+{
+    using namespace openvdb::ax::ast;
+
+    const std::vector<std::string> code = {
+        "@a = 1.0f + @b;",
+        "@a = 2.0f + @b;",
+        "@a = 1.0f - @b;",
+        "@a = 1.0f + @c;",
+        "@c = 1.0f + @b;",
+        "@a = 1.0 + @b;",
+        "@a = 1.0f + f@b;",
+        "@a = 1.0f + i@b;",
+        "@a = @b + 1.0f;",
+        "@a += 1.0f + @b;",
+        "if (@b) @a = 1.0f;",
+        "if (@b) @a = 1.0f; else @a = 1.0f;",
+        "@a = sin(1.0f) + @b;",
+        "@a = cos(1.0f) + @b;",
+        "float a = 1.0f;",
+        "int a = 1;",
+        "++@a;",
+        "@a++;",
+        "--@a;",
+        "v@a = {1,2,3};",
+        "v@a = {1,2,4};",
+        "f@a = v@b.x;",
+        "f@a = v@b.y;",
+        "s@a = \"foo\";",
+        "s@a = \"bar\";",
+    };
+
+    std::vector<uint64_t> hashes;
+    for (const std::string& snippet : code) {
+        const Tree::Ptr tree = parse(snippet.c_str());
+        CPPUNIT_ASSERT(tree);
+        hashes.emplace_back(hash(*tree));
+    }
+
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        for (size_t j = i + 1; j < hashes.size(); ++j) {
+            CPPUNIT_ASSERT_MESSAGE("Hash collision between \"" + code[i] +
+                "\" and \"" + code[j] + "\"", hashes[i] != hashes[j]);
+        }
+    }
+
+    const Tree::Ptr tree = parse(code.front().c_str());
+    CPPUNIT_ASSERT(hashCombine(hash(*tree), "a") != hashCombine(hash(*tree), "b"));
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "TestHarness.h"
+
+#include "test/util.h"
+
+#include <openvdb/points/PointAttribute.h>
+#include <openvdb/points/PointCount.h>
+#include <openvdb/points/PointGroup.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestDeletePoints : public CppUnit::TestCase
+{
+public:
+
+    CPPUNIT_TEST_SUITE(TestDeletePoints);
+    CPPUNIT_TEST(testCompact);
+    CPPUNIT_TEST(testNewData);
+    CPPUNIT_TEST(testEmptyLeaves);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testCompact();
+    void testNewData();
+    void testEmptyLeaves();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestDeletePoints);
+
+namespace {
+
+/// @brief  Creates a point grid with two leaves of 8 points each, one per voxel, and
+///         a float attribute "a" holding the index of each point within its leaf
+openvdb::points::PointDataGrid::Ptr createGrid()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) a.set(n, float(n));
+    }
+
+    return grid;
+}
+
+}
+
+void
+TestDeletePoints::testCompact()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = createGrid();
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointDeleteCompact");
+
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(6), pointCount(grid->tree()));
+    CPPUNIT_ASSERT(!grid->tree().cbeginLeaf()->attributeSet().descriptor().hasGroup("dead"));
+
+    // the remaining points keep their order and values, and the voxels of the
+    // deleted points are deactivated
+
+    const std::vector<float> expected { 0.0f, 2.0f, 3.0f };
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(3), leaf->onPointCount());
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(3), leaf->onVoxelCount());
+
+        AttributeHandle<float> a(leaf->constAttributeArray("a"));
+        AttributeHandle<float> b(leaf->constAttributeArray("b"));
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index(3), a.size());
+        for (openvdb::Index n = 0; n < a.size(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(expected[n], a.get(n));
+            CPPUNIT_ASSERT_EQUAL(expected[n], b.get(n));
+        }
+
+        openvdb::Index n = 0;
+        for (auto iter = leaf->beginIndexOn(); iter; ++iter, ++n) {
+            CPPUNIT_ASSERT_EQUAL(int(expected[n]), iter.getCoord().x());
+        }
+    }
+}
+
+void
+TestDeletePoints::testNewData()
+{
+    using namespace openvdb::points;
+
+    // new groups and moved positions are applied to the remaining points
+
+    PointDataGrid::Ptr grid = createGrid();
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointDeleteNewData");
+
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(12), pointCount(grid->tree()));
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(6), leaf->pointCount());
+
+        // the point which moved is now first
+
+        AttributeHandle<float> a(leaf->constAttributeArray("a"));
+        CPPUNIT_ASSERT_EQUAL(7.0f, a.get(0));
+
+        GroupHandle group = leaf->groupHandle("new");
+        for (openvdb::Index n = 0; n < a.size(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(a.get(n) == 3.0f, group.get(n));
+        }
+    }
+}
+
+void
+TestDeletePoints::testEmptyLeaves()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = createGrid();
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointDeleteLeaf");
+
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index32(1), grid->tree().leafCount());
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index64(8), pointCount(grid->tree()));
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointDeleteAll");
+    CPPUNIT_ASSERT_EQUAL(openvdb::Index32(0), grid->tree().leafCount());
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
@@ -32,6 +32,8 @@
 
 #include <openvdb_ax/test/util.h>
 
+#include <openvdb/points/PointCount.h>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <boost/functional/hash.hpp>
@@ -340,25 +342,16 @@ TestFunction::testFunctionVolumePWS()
 void
 TestFunction::testFunctionDeletePoint()
 {
-    // NOTE: the "deletepoint" function doesn't actually directly delete points - it adds them
-    // to the "dead" group which marks them for deletion afterwards
+    // points are removed by the executable without creating a "dead" group
 
     mHarness.testVolumes(false);
-    mHarness.addInputGroups({"dead"}, {false});
-    mHarness.addExpectedGroups({"dead"}, {true});
-
-    mHarness.executeCode("test/snippets/function/functionDeletePoint");
-
-    AXTESTS_STANDARD_ASSERT();
-
-    // test without existing dead group
-
-    mHarness.reset();
-    mHarness.addExpectedGroups({"dead"}, {true});
-
     mHarness.executeCode("test/snippets/function/functionDeletePoint");
 
-    AXTESTS_STANDARD_ASSERT();
+    for (const auto& grid : mHarness.mInputPointGrids) {
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index64(0),
+            openvdb::points::pointCount(grid.second->tree()));
+        CPPUNIT_ASSERT_EQUAL(openvdb::Index32(0), grid.second->tree().leafCount());
+    }
 }
 
 // Copyright (c) 2015-2018 DNEG Visual Effects
@@ -30,7 +30,10 @@
 
 #include "TestHarness.h"
 
+#include "test/util.h"
+
 #include <openvdb/points/AttributeArray.h>
+#include <openvdb/points/PointAttribute.h>
 #include <openvdb/points/PointConversion.h>
 #include <openvdb/points/PointGroup.h>
 
@@ -43,11 +46,17 @@ public:
     CPPUNIT_TEST(testAssignArithmeticToGroup);
     CPPUNIT_TEST(testGroupQuery);
     CPPUNIT_TEST(testGroupOrder);
+    CPPUNIT_TEST(testGroupRange);
+    CPPUNIT_TEST(testGroupAccess);
+    CPPUNIT_TEST(testNewGroups);
     CPPUNIT_TEST_SUITE_END();
 
     void testAssignArithmeticToGroup();
     void testGroupQuery();
     void testGroupOrder();
+    void testGroupRange();
+    void testGroupAccess();
+    void testNewGroups();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestGroups);
@@ -198,6 +207,153 @@ TestGroups::testGroupQuery()
     }
 }
 
+void
+TestGroups::testGroupRange()
+{
+    using namespace openvdb::points;
+
+    // a point count which is not a multiple of the eight points scanned per word
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 37; ++n) positions.emplace_back(float(n % 7), float(n / 7), 0.0f);
+
+    PointDataGrid::Ptr grid = unittest_util::createPointGrid(positions);
+
+    // the second group is stored at a non zero bit
+
+    appendGroup(grid->tree(), "first");
+    appendGroup(grid->tree(), "second");
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<int32_t>::attributeType());
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        GroupWriteHandle first = leaf->groupWriteHandle("first");
+        GroupWriteHandle second = leaf->groupWriteHandle("second");
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) {
+            first.set(n, n % 2 == 0);
+            second.set(n, n % 3 == 0 || n == leaf->pointCount() - 1);
+        }
+    }
+
+    const std::string group("second");
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointGroupRange", &group);
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        AttributeHandle<int32_t> a(leaf->constAttributeArray("a"));
+        GroupHandle second = leaf->groupHandle("second");
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(second.get(n) ? 1 : 0, a.get(n));
+        }
+    }
+}
+
+void
+TestGroups::testGroupAccess()
+{
+    using namespace openvdb::points;
+
+    // two leaves of 8 points. The groups of the second leaf are uniform, so their
+    // array is expanded to be edited and compacted afterwards
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+
+    appendGroup(grid->tree(), "a");
+    appendGroup(grid->tree(), "b");
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        GroupWriteHandle a = leaf->groupWriteHandle("a");
+        if (leaf->origin().z() != 0) {
+            a.collapse(true);
+            continue;
+        }
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) a.set(n, n % 3 == 0);
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointGroupAccess");
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        const bool uniform = leaf->origin().z() != 0;
+
+        GroupHandle a = leaf->groupHandle("a");
+        GroupHandle b = leaf->groupHandle("b");
+        GroupHandle c = leaf->groupHandle("c");
+        AttributeHandle<int32_t> v(leaf->constAttributeArray("v"));
+
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) {
+            const bool inA = uniform || n % 3 == 0;
+            CPPUNIT_ASSERT(!a.get(n));
+            CPPUNIT_ASSERT_EQUAL(inA, b.get(n));
+            CPPUNIT_ASSERT(c.get(n));
+            CPPUNIT_ASSERT_EQUAL(inA ? 1 : 0, v.get(n));
+        }
+
+        // edited arrays are compacted once the leaf has been executed
+
+        if (uniform) CPPUNIT_ASSERT(b.isUniform());
+    }
+}
+
+void
+TestGroups::testNewGroups()
+{
+    using namespace openvdb::points;
+
+    // two leaves of 8 points
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+
+    // "x" keeps its offset. The offset of "y" is unused once it is dropped, but its
+    // bits remain set and must be cleared when the offset is taken by a new group
+
+    appendGroup(grid->tree(), "x");
+    appendGroup(grid->tree(), "y");
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        GroupWriteHandle x = leaf->groupWriteHandle("x");
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) x.set(n, n % 2 == 0);
+        leaf->groupWriteHandle("y").collapse(true);
+    }
+    dropGroup(grid->tree(), "y");
+
+    // nine new groups fill the unused offsets of the existing array and a new array
+
+    const int count = 9;
+
+    appendAttribute<int32_t>(grid->tree(), "id");
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<int32_t> id(leaf->attributeArray("id"));
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) id.set(n, int32_t(n));
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointNewGroups");
+
+    // the groups are held by the existing array and a single appended array
+
+    const AttributeSet::Descriptor& descriptor =
+        grid->tree().cbeginLeaf()->attributeSet().descriptor();
+
+    size_t arrays = 0;
+    for (size_t pos = 0; pos < descriptor.size(); ++pos) {
+        if (descriptor.type(pos) == GroupAttributeArray::attributeType()) ++arrays;
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(2), arrays);
+    CPPUNIT_ASSERT_EQUAL(size_t(count + 1), descriptor.groupMap().size());
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        CPPUNIT_ASSERT_EQUAL(&descriptor, &leaf->attributeSet().descriptor());
+
+        GroupHandle x = leaf->groupHandle("x");
+        for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(n % 2 == 0, x.get(n));
+        }
+
+        for (int k = 0; k < count; ++k) {
+            GroupHandle g = leaf->groupHandle("g" + std::to_string(k));
+            for (openvdb::Index n = 0; n < leaf->pointCount(); ++n) {
+                CPPUNIT_ASSERT_EQUAL(n % (k + 2) == 0, g.get(n));
+            }
+        }
+    }
+}
+
 // Copyright (c) 2015-2018 DNEG Visual Effects
 // All rights reserved. This software is distributed under the
 // Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
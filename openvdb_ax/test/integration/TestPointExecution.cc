@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2018 DNEG Visual Effects
+//
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
+//
+// Redistributions of source code must retain the above copyright
+// and license notice and the following restrictions and disclaimer.
+//
+// *     Neither the name of DNEG Visual Effects nor the names
+// of its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// IN NO EVENT SHALL THE COPYRIGHT HOLDERS' AND CONTRIBUTORS' AGGREGATE
+// LIABILITY FOR ALL CLAIMS REGARDLESS OF THEIR BASIS EXCEED US$250.00.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "TestHarness.h"
+
+#include "test/util.h"
+
+#include <openvdb/points/AttributeArray.h>
+#include <openvdb/points/AttributeArrayString.h>
+#include <openvdb/points/PointAttribute.h>
+#include <openvdb/points/PointGroup.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+/// @brief  End-to-end tests of point execution paths which depend on how attributes
+///         are stored, run on grids built for each test
+
+class TestPointExecution : public CppUnit::TestCase
+{
+public:
+    CPPUNIT_TEST_SUITE(TestPointExecution);
+    CPPUNIT_TEST(testDirectAttributeAccess);
+    CPPUNIT_TEST(testUniformAttributes);
+    CPPUNIT_TEST(testUniformGroups);
+    CPPUNIT_TEST(testAttributeCodecs);
+    CPPUNIT_TEST(testKernelContextReuse);
+    CPPUNIT_TEST(testStringCompare);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testDirectAttributeAccess();
+    void testUniformAttributes();
+    void testUniformGroups();
+    void testAttributeCodecs();
+    void testKernelContextReuse();
+    void testStringCompare();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPointExecution);
+
+namespace {
+
+/// @brief  Creates a point grid with two leaves of 8 points each and the string
+///         attributes "name" and "other". Points alternate between the names "foo"
+///         and "bar", and "other" holds "foo" for the first point of each leaf only
+openvdb::points::PointDataGrid::Ptr createStringGrid()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+
+    appendAttribute(grid->tree(), "name", StringAttributeArray::attributeType());
+    appendAttribute(grid->tree(), "other", StringAttributeArray::attributeType());
+
+    auto leaf = grid->tree().beginLeaf();
+    openvdb::MetaMap& metadata = leaf->attributeSet().descriptorPtr()->getMetadata();
+    {
+        StringMetaInserter inserter(metadata);
+        inserter.insert("foo");
+        inserter.insert("bar");
+    }
+
+    for (; leaf; ++leaf) {
+        StringAttributeWriteHandle name(leaf->attributeArray("name"), metadata);
+        for (openvdb::Index n = 0; n < name.size(); ++n) name.set(n, n % 2 ? "bar" : "foo");
+        StringAttributeWriteHandle other(leaf->attributeArray("other"), metadata);
+        other.set(0, "foo");
+    }
+
+    return grid;
+}
+
+}
+
+void
+TestPointExecution::testDirectAttributeAccess()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid =
+        unittest_util::createPointGrid({ {0, 0, 0}, {0.1f, 0, 0}, {0, 0.1f, 0} });
+
+    // "a" and "i" are accessed directly, the uniform "b" and compressed "c" through
+    // their handles
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    appendAttribute(grid->tree(), "b", TypedAttributeArray<float>::attributeType());
+    appendAttribute(grid->tree(), "c",
+        TypedAttributeArray<float, TruncateCodec>::attributeType());
+    appendAttribute(grid->tree(), "i", TypedAttributeArray<int32_t>::attributeType());
+
+    auto leaf = grid->tree().beginLeaf();
+    CPPUNIT_ASSERT(leaf);
+
+    {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        AttributeWriteHandle<int32_t> i(leaf->attributeArray("i"));
+        for (openvdb::Index n = 0; n < 3; ++n) {
+            a.set(n, float(n));
+            i.set(n, int32_t(n));
+        }
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointDirectAttributeAccess");
+
+    leaf = grid->tree().beginLeaf();
+    AttributeHandle<float> a(leaf->constAttributeArray("a"));
+    AttributeHandle<float> c(leaf->constAttributeArray("c"));
+    AttributeHandle<int32_t> i(leaf->constAttributeArray("i"));
+
+    for (openvdb::Index n = 0; n < 3; ++n) {
+        CPPUNIT_ASSERT_EQUAL(2.0f * float(n), a.get(n));
+        CPPUNIT_ASSERT_EQUAL(2.0f * float(n) + 1.0f, c.get(n));
+        CPPUNIT_ASSERT_EQUAL(int32_t(n) + 1, i.get(n));
+    }
+}
+
+void
+TestPointExecution::testUniformAttributes()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+
+    // the first leaf holds a uniform value, the second varying values
+
+    auto leaf = grid->tree().beginLeaf();
+    AttributeWriteHandle<float>(leaf->attributeArray("a"), /*expand*/false).collapse(3.0f);
+    ++leaf;
+    {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) a.set(n, float(n));
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointUniformAttributes");
+
+    leaf = grid->tree().beginLeaf();
+    CPPUNIT_ASSERT(leaf->constAttributeArray("b").isUniform());
+    CPPUNIT_ASSERT_EQUAL(6.0f, AttributeHandle<float>(leaf->constAttributeArray("b")).get(0));
+
+    ++leaf;
+    CPPUNIT_ASSERT(!leaf->constAttributeArray("b").isUniform());
+    AttributeHandle<float> b(leaf->constAttributeArray("b"));
+    for (openvdb::Index n = 0; n < b.size(); ++n) {
+        CPPUNIT_ASSERT_EQUAL(float(n) * 2.0f, b.get(n));
+    }
+
+    // programs which are not point invariant always expand
+
+    grid = unittest_util::createTwoLeafPointGrid();
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointUniformAttributesPosition");
+
+    for (leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        CPPUNIT_ASSERT(!leaf->constAttributeArray("b").isUniform());
+    }
+}
+
+void
+TestPointExecution::testUniformGroups()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = unittest_util::createTwoLeafPointGrid();
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    appendGroup(grid->tree(), "group");
+
+    // the group is uniformly on in the first leaf and off in the second
+
+    auto leaf = grid->tree().beginLeaf();
+    leaf->groupWriteHandle("group").collapse(true);
+    ++leaf;
+    leaf->groupWriteHandle("group").collapse(false);
+
+    const std::string group("group");
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointUniformGroups", &group);
+
+    leaf = grid->tree().beginLeaf();
+    CPPUNIT_ASSERT(leaf->constAttributeArray("a").isUniform());
+    CPPUNIT_ASSERT_EQUAL(1.0f, AttributeHandle<float>(leaf->constAttributeArray("a")).get(0));
+
+    ++leaf;
+    CPPUNIT_ASSERT(leaf->constAttributeArray("a").isUniform());
+    CPPUNIT_ASSERT_EQUAL(0.0f, AttributeHandle<float>(leaf->constAttributeArray("a")).get(0));
+
+    // a group which varies within the leaf is filtered per point
+
+    grid = unittest_util::createTwoLeafPointGrid();
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float>::attributeType());
+    appendGroup(grid->tree(), "group");
+    for (leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        GroupWriteHandle handle = leaf->groupWriteHandle("group");
+        handle.set(0, true);
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointUniformGroups", &group);
+
+    for (leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeHandle<float> a(leaf->constAttributeArray("a"));
+        CPPUNIT_ASSERT_EQUAL(1.0f, a.get(0));
+        for (openvdb::Index n = 1; n < a.size(); ++n) CPPUNIT_ASSERT_EQUAL(0.0f, a.get(n));
+    }
+}
+
+void
+TestPointExecution::testAttributeCodecs()
+{
+    using namespace openvdb::points;
+    using FixedPointArray = TypedAttributeArray<float, FixedPointCodec<false, UnitRange>>;
+
+    // "a" is stored with a codec, so is decoded for execution and encoded afterwards
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 16; ++n) positions.emplace_back(float(n % 8), float(n / 8), 0.0f);
+
+    PointDataGrid::Ptr grid =
+        unittest_util::createPointGrid<FixedPointCodec<false, PositionRange>>(positions);
+
+    appendAttribute(grid->tree(), "a", FixedPointArray::attributeType());
+    appendGroup(grid->tree(), "group");
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        GroupWriteHandle group = leaf->groupWriteHandle("group");
+        for (openvdb::Index n = 0; n < a.size(); ++n) {
+            a.set(n, float(n) / 16.0f);
+            group.set(n, n % 2 == 0);
+        }
+    }
+
+    PointDataGrid::Ptr original = grid->deepCopy();
+
+    // the value assigned to "a" once quantised
+
+    FixedPointArray assigned(1);
+    assigned.set(0, 0.5f);
+
+    const std::string group("group");
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointAttributeCodecs", &group);
+
+    auto leaf = grid->tree().cbeginLeaf();
+    auto originalLeaf = original->tree().cbeginLeaf();
+    for (; leaf; ++leaf, ++originalLeaf) {
+        AttributeHandle<float> a(leaf->constAttributeArray("a"));
+        AttributeHandle<float> b(leaf->constAttributeArray("b"));
+        AttributeHandle<float> originalA(originalLeaf->constAttributeArray("a"));
+        AttributeHandle<openvdb::Vec3f> P(originalLeaf->constAttributeArray("P"));
+
+        for (auto iter = originalLeaf->beginIndexOn(); iter; ++iter) {
+            const openvdb::Index n = *iter;
+            if (n % 2 == 0) {
+                const float x = float(grid->transform().indexToWorld(
+                    iter.getCoord().asVec3d() + P.get(n)).x());
+                CPPUNIT_ASSERT_EQUAL(originalA.get(n) + x, b.get(n));
+                CPPUNIT_ASSERT_EQUAL(assigned.get(0), a.get(n));
+            }
+            else {
+                // points outside the group are left untouched
+                CPPUNIT_ASSERT_EQUAL(0.0f, b.get(n));
+                CPPUNIT_ASSERT_EQUAL(originalA.get(n), a.get(n));
+            }
+        }
+    }
+}
+
+void
+TestPointExecution::testKernelContextReuse()
+{
+    using namespace openvdb::points;
+
+    // many leaves, so that each thread executes several with the same arguments. The
+    // attribute is decoded in some leaves and accessed through its handle in others
+
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 64; ++n) {
+        positions.emplace_back(float(n * 8), 0.0f, 0.0f);
+        if (n % 2 == 0) positions.emplace_back(float(n * 8) + 1.0f, 0.0f, 0.0f);
+    }
+
+    PointDataGrid::Ptr grid = unittest_util::createPointGrid(positions);
+
+    appendAttribute(grid->tree(), "a", TypedAttributeArray<float, TruncateCodec>::attributeType());
+
+    for (auto leaf = grid->tree().beginLeaf(); leaf; ++leaf) {
+        if (leaf->pointCount() == 1) continue;
+        AttributeWriteHandle<float> a(leaf->attributeArray("a"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) a.set(n, float(n + 1));
+    }
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointKernelContextReuse");
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        AttributeHandle<float> a(leaf->constAttributeArray("a"));
+        AttributeHandle<float> b(leaf->constAttributeArray("b"));
+        for (openvdb::Index n = 0; n < a.size(); ++n) {
+            const float expected = (leaf->pointCount() == 1 ? 0.0f : float(n + 1)) + 1.0f;
+            CPPUNIT_ASSERT_EQUAL(expected, a.get(n));
+            CPPUNIT_ASSERT_EQUAL(expected * 2.0f, b.get(n));
+        }
+    }
+}
+
+void
+TestPointExecution::testStringCompare()
+{
+    using namespace openvdb::points;
+
+    PointDataGrid::Ptr grid = createStringGrid();
+
+    unittest_util::wrapExecution(*grid, "test/snippets/point/pointStringCompare");
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        AttributeHandle<int32_t> a(leaf->constAttributeArray("a"));
+        AttributeHandle<int32_t> b(leaf->constAttributeArray("b"));
+        AttributeHandle<int32_t> c(leaf->constAttributeArray("c"));
+        AttributeHandle<int32_t> d(leaf->constAttributeArray("d"));
+
+        for (openvdb::Index n = 0; n < a.size(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(n % 2 ? 0 : 1, a.get(n));
+            CPPUNIT_ASSERT_EQUAL(n == 0 ? 0 : 1, b.get(n));
+            CPPUNIT_ASSERT_EQUAL(0, c.get(n));
+            CPPUNIT_ASSERT_EQUAL(n == 0 ? 0 : 1, d.get(n));
+        }
+    }
+
+    // the strings of the attributes are untouched
+
+    for (auto leaf = grid->tree().cbeginLeaf(); leaf; ++leaf) {
+        StringAttributeHandle name(leaf->constAttributeArray("name"),
+            leaf->attributeSet().descriptor().getMetadata());
+        for (openvdb::Index n = 0; n < name.size(); ++n) {
+            CPPUNIT_ASSERT_EQUAL(openvdb::Name(n % 2 ? "bar" : "foo"), name.get(n));
+        }
+    }
+}
+
+// Copyright (c) 2015-2018 DNEG Visual Effects
+// All rights reserved. This software is distributed under the
+// Mozilla Public License 2.0 ( http://www.mozilla.org/MPL/2.0/ )
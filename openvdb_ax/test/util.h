@@ -33,6 +33,9 @@
 #define OPENVDB_AX_UNITTEST_UTIL_HAS_BEEN_INCLUDED
 
 #include <openvdb/Types.h>
+#include <openvdb/math/Transform.h>
+#include <openvdb/points/PointConversion.h>
+#include <openvdb/points/PointDataGrid.h>
 
 #include <memory>
 #include <vector>
@@ -113,6 +116,40 @@ nameSequence(const std::string& base, const int number, const bool firstPrefixEm
     return names;
 }
 
+/// @brief  Creates a point data grid holding a point at each of the given world space
+///         positions, which are stored with the position codec CodecT
+template <typename CodecT = openvdb::points::NullCodec>
+inline openvdb::points::PointDataGrid::Ptr
+createPointGrid(const std::vector<openvdb::Vec3s>& positions,
+                const openvdb::math::Transform& transform)
+{
+    return openvdb::points::createPointDataGrid<CodecT, openvdb::points::PointDataGrid>
+        (positions, transform);
+}
+
+/// @brief  Creates a point data grid with a linear transform of the given voxel size
+template <typename CodecT = openvdb::points::NullCodec>
+inline openvdb::points::PointDataGrid::Ptr
+createPointGrid(const std::vector<openvdb::Vec3s>& positions, const double voxelSize = 1.0)
+{
+    const openvdb::math::Transform::Ptr transform =
+        openvdb::math::Transform::createLinearTransform(voxelSize);
+    return createPointGrid<CodecT>(positions, *transform);
+}
+
+/// @brief  Creates a point data grid with two leaves of 8 points each, one point per
+///         voxel, with a voxel size of 1
+inline openvdb::points::PointDataGrid::Ptr
+createTwoLeafPointGrid()
+{
+    std::vector<openvdb::Vec3s> positions;
+    for (int n = 0; n < 8; ++n) {
+        positions.emplace_back(float(n), 0.0f, 0.0f);
+        positions.emplace_back(float(n), 0.0f, 20.0f);
+    }
+    return createPointGrid(positions);
+}
+
 }
 
 #endif // OPENVDB_AX_UNITTEST_UTIL_HAS_BEEN_INCLUDED
@@ -43,6 +43,7 @@
 #include <openvdb_ax/ast/PrintTree.h>
 #include <openvdb_ax/compiler/Compiler.h>
 #include <openvdb_ax/compiler/CustomData.h>
+#include <openvdb_ax/compiler/ExecutableCache.h>
 #include <openvdb_ax/compiler/PointExecutable.h>
 #include <openvdb_ax/compiler/VolumeExecutable.h>
 
@@ -53,7 +54,6 @@
 
 #include <openvdb/openvdb.h>
 #include <openvdb/points/PointDataGrid.h>
-#include <openvdb/points/PointDelete.h>
 #include <openvdb/points/IndexIterator.h>
 
 #include <CH/CH_Channel.h>
@@ -125,10 +125,6 @@ struct CompilerCache
     ax::CustomData::Ptr mCustomData = nullptr;
     ax::PointExecutable::Ptr mPointExecutable = nullptr;
     ax::VolumeExecutable::Ptr mVolumeExecutable = nullptr;
-
-    // point variables
-
-    bool mRequiresDeletion = false;
 };
 
 
@@ -417,6 +413,10 @@ SOP_OpenVDB_AX::SOP_OpenVDB_AX(OP_Network* net,
     mCompilerCache.mCustomData.reset(new ax::CustomData);
     mCompilerCache.mCompiler = ax::Compiler::create();
     mCompilerCache.mCompiler->setFunctionRegistry(std::move(functionRegistry));
+
+    // keep previously compiled executables so that switching between snippets or
+    // target types does not require a recompile
+    mCompilerCache.mCompiler->setExecutableCache(ax::ExecutableCache::create());
 }
 
 bool
@@ -525,9 +525,6 @@ SOP_OpenVDB_AX::cookVDBSop(OP_Context& context)
 
             if (targetType == hax::TargetType::POINTS) {
 
-                mCompilerCache.mRequiresDeletion =
-                    openvdb::ax::ast::callsFunction(*mCompilerCache.mSyntaxTree, "deletepoint");
-
                 mCompilerCache.mPointExecutable =
                     mCompilerCache.mCompiler->compile<ax::PointExecutable>
                         (*mCompilerCache.mSyntaxTree, mCompilerCache.mCustomData, &mWarnings);
@@ -578,10 +575,6 @@ SOP_OpenVDB_AX::cookVDBSop(OP_Context& context)
                 }
 
                 mCompilerCache.mPointExecutable->execute(*points, &pointsGroup);
-
-                if (mCompilerCache.mRequiresDeletion) {
-                    openvdb::points::deleteFromGroup(points->tree(), "dead", false, false);
-                }
             }
         }
         else if (targetType == hax::TargetType::VOLUMES) {